@@ -0,0 +1,458 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Batch_Engine.h"
+
+#include <cstring>
+
+// Lockstep groups need GCC vector extensions; elsewhere every instance runs on its own
+#if defined(__GNUC__)
+#define BATCH_LOCKSTEP
+#endif
+
+// Build the lockstep loop twice on x86-64 Linux and pick the AVX2 copy when the processor has it
+#if defined(BATCH_LOCKSTEP) && defined(__x86_64__) && defined(__linux__)
+#define BATCH_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#define BATCH_TARGETS
+#endif
+
+namespace {
+    const int32_t finished = 0x7FFFFFFF; // Program counter of a lane whose instance has ended
+
+    // Arithmetic on 32-bit words that wraps around instead of overflowing
+    inline int32_t wrap(uint32_t value) { return static_cast<int32_t>(value); }
+
+    // Division truncating toward zero; the one quotient that does not fit wraps around
+    inline int32_t divide(int32_t left, int32_t right) {
+        if (right == -1) { return wrap(0u - static_cast<uint32_t>(left)); }
+        return left / right;
+    }
+
+    // The instances of a group between the lockstep loop and their fallbacks
+    struct Group {
+        const Vm_Instruction* code; // The program, followed by VM_END
+        uint32_t* memory; // Each variable as one word per lane
+        int32_t pc[Batch_Engine::lanes]; // Next instruction of each lane, finished once its instance ended
+        uint32_t accumulator[Batch_Engine::lanes]; // Accumulator of each lane
+        const vector<int32_t>* input[Batch_Engine::lanes]; // Input of each lane
+        size_t position[Batch_Engine::lanes]; // Next input word of each lane
+        Batch_Engine::Result* result[Batch_Engine::lanes]; // Result of each lane
+        unsigned long long vector_steps; // Instructions run in lockstep
+        unsigned long long lane_steps; // Instructions run by active lanes
+    };
+
+#ifdef BATCH_LOCKSTEP
+    typedef uint32_t Words __attribute__((vector_size(32))); // One word per lane
+    typedef int32_t Signed_Words __attribute__((vector_size(32))); // The same words compared as signed
+
+// The lanes of mask from first, the others from second
+#define BATCH_SELECT(mask, first, second) (((first) & (mask)) | ((second) & ~(mask)))
+
+    /** Run the lanes of a group in lockstep. At each step the lanes waiting at the lowest instruction
+     *  run it under a mask while the others keep their state, which lets lanes that took different
+     *  branches meet again where control joins, since the lanes behind run first. While no lane
+     *  waits between the active ones and where they go next, the mask and the lowest instruction
+     *  are kept as they are instead of being found again.
+     *  @param group The lanes, updated in place
+     *  @param min_active Stop if fewer lanes than this are active on average over a window of steps
+     *  @return True if every lane ended, false if the group stopped to run the rest on their own
+     */
+    BATCH_TARGETS bool run_lockstep(Group& group, unsigned min_active) {
+        const size_t lanes = Batch_Engine::lanes;
+        const unsigned long long window = 64; // Steps between checks of the utilization
+        const Words zero = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        uint32_t* const memory = group.memory;
+        Words accumulator;
+        Words pcs; // Next instruction of each lane, except of the active ones, which are at pc
+        std::memcpy(&accumulator, group.accumulator, sizeof(accumulator));
+        std::memcpy(&pcs, group.pc, sizeof(pcs));
+        Words mask = zero; // The active lanes
+        int32_t pc = 0; // Instruction the active lanes run
+        int32_t waiting = finished; // Lowest instruction of the other lanes
+        unsigned active = 0; // Number of active lanes
+        bool regroup = true; // Find the lowest instruction and its lanes again from pcs
+        unsigned long long window_steps = 0;
+        unsigned long long window_active = 0;
+        bool ended = false;
+
+        for (;;) {
+            if (regroup) {
+                pc = finished;
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    if (static_cast<int32_t>(pcs[lane]) < pc) { pc = static_cast<int32_t>(pcs[lane]); }
+                }
+                if (pc == finished) {
+                    ended = true;
+                    break;
+                }
+                mask = reinterpret_cast<Words>(reinterpret_cast<Signed_Words>(pcs) == pc);
+                active = 0;
+                waiting = finished;
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    if (mask[lane] != 0) { ++active; }
+                    else if (static_cast<int32_t>(pcs[lane]) < waiting) { waiting = static_cast<int32_t>(pcs[lane]); }
+                }
+                regroup = false;
+            }
+
+            ++group.vector_steps;
+            group.lane_steps += active;
+            window_active += active;
+            if (++window_steps == window) {
+                if (window_active < window * min_active) {
+                    pcs = BATCH_SELECT(mask, zero + static_cast<uint32_t>(pc), pcs);
+                    break;
+                }
+                window_steps = 0;
+                window_active = 0;
+            }
+
+            const Vm_Instruction& instruction = group.code[pc];
+            const int32_t operand = instruction.operand;
+            uint32_t* const variable = memory + static_cast<size_t>(operand) * lanes; // Only meaningful for variable operands
+            const Words integer = zero + static_cast<uint32_t>(operand);
+            Words value;
+            int32_t next = pc + 1;
+
+            switch (instruction.opcode) {
+            case VM_LOAD:
+                std::memcpy(&value, variable, sizeof(value));
+                accumulator = BATCH_SELECT(mask, value, accumulator);
+                break;
+            case VM_LOAD_I:
+                accumulator = BATCH_SELECT(mask, integer, accumulator);
+                break;
+            case VM_STORE:
+                std::memcpy(&value, variable, sizeof(value));
+                value = BATCH_SELECT(mask, accumulator, value);
+                std::memcpy(variable, &value, sizeof(value));
+                break;
+            case VM_ADD:
+                std::memcpy(&value, variable, sizeof(value));
+                accumulator = BATCH_SELECT(mask, accumulator + value, accumulator);
+                break;
+            case VM_ADD_I:
+                accumulator = BATCH_SELECT(mask, accumulator + integer, accumulator);
+                break;
+            case VM_SUB:
+                std::memcpy(&value, variable, sizeof(value));
+                accumulator = BATCH_SELECT(mask, accumulator - value, accumulator);
+                break;
+            case VM_SUB_I:
+                accumulator = BATCH_SELECT(mask, accumulator - integer, accumulator);
+                break;
+            case VM_MULT:
+                std::memcpy(&value, variable, sizeof(value));
+                accumulator = BATCH_SELECT(mask, accumulator * value, accumulator);
+                break;
+            case VM_MULT_I:
+                accumulator = BATCH_SELECT(mask, accumulator * integer, accumulator);
+                break;
+            case VM_DIV: case VM_DIV_I: // No vector division: each active lane divides on its own
+                if (instruction.opcode == VM_DIV) { std::memcpy(&value, variable, sizeof(value)); }
+                else { value = integer; }
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    if (mask[lane] == 0) { continue; }
+                    if (value[lane] == 0) {
+                        group.result[lane]->error = "division by zero";
+                        mask[lane] = 0;
+                        pcs[lane] = finished;
+                        regroup = true;
+                        continue;
+                    }
+                    accumulator[lane] = static_cast<uint32_t>(divide(static_cast<int32_t>(accumulator[lane]), static_cast<int32_t>(value[lane])));
+                }
+                break;
+            case VM_READ:
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    if (mask[lane] == 0) { continue; }
+                    if (group.position[lane] >= group.input[lane]->size()) {
+                        group.result[lane]->error = "READ past the end of the input";
+                        mask[lane] = 0;
+                        pcs[lane] = finished;
+                        regroup = true;
+                        continue;
+                    }
+                    variable[lane] = static_cast<uint32_t>(group.input[lane]->at(group.position[lane]++));
+                }
+                break;
+            case VM_WRITE: case VM_WRITE_I:
+                if (instruction.opcode == VM_WRITE) { std::memcpy(&value, variable, sizeof(value)); }
+                else { value = integer; }
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    if (mask[lane] != 0) { group.result[lane]->output.push_back(static_cast<int32_t>(value[lane])); }
+                }
+                break;
+            case VM_BR:
+                next = operand;
+                break;
+            case VM_BRNEG: case VM_BRZNEG: case VM_BRPOS: case VM_BRZPOS: case VM_BRZERO: {
+                Signed_Words signed_accumulator = reinterpret_cast<Signed_Words>(accumulator);
+                Signed_Words holds;
+                switch (instruction.opcode) {
+                case VM_BRNEG: holds = signed_accumulator < 0; break;
+                case VM_BRZNEG: holds = signed_accumulator <= 0; break;
+                case VM_BRPOS: holds = signed_accumulator > 0; break;
+                case VM_BRZPOS: holds = signed_accumulator >= 0; break;
+                default: holds = signed_accumulator == 0; break;
+                }
+                Words taken = mask & reinterpret_cast<Words>(holds);
+                bool every = true; // Every active lane takes the branch
+                bool none = true; // No active lane takes it
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    if (taken[lane] != mask[lane]) { every = false; }
+                    if (taken[lane] != 0) { none = false; }
+                }
+                if (every) { next = operand; }
+                else if (!none) {
+                    // The active lanes part: each goes its way and the lowest runs first
+                    pcs = BATCH_SELECT(mask, zero + static_cast<uint32_t>(next), pcs);
+                    pcs = BATCH_SELECT(taken, integer, pcs);
+                    regroup = true;
+                    continue;
+                }
+                break;
+            }
+            case VM_NOOP:
+                break;
+            case VM_STOP:
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    if (mask[lane] != 0) { group.result[lane]->stopped = true; }
+                }
+                pcs = BATCH_SELECT(mask, zero + static_cast<uint32_t>(finished), pcs);
+                regroup = true;
+                continue;
+            default: // VM_END
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    if (mask[lane] != 0) { group.result[lane]->error = "control fell off the end of the program"; }
+                }
+                pcs = BATCH_SELECT(mask, zero + static_cast<uint32_t>(finished), pcs);
+                regroup = true;
+                continue;
+            }
+
+            // The active lanes stay together unless they reach or pass a waiting lane, or one of them ended
+            if (next < waiting && !regroup) {
+                pc = next;
+            } else {
+                pcs = BATCH_SELECT(mask, zero + static_cast<uint32_t>(next), pcs);
+                regroup = true;
+            }
+        }
+
+        std::memcpy(group.accumulator, &accumulator, sizeof(accumulator));
+        std::memcpy(group.pc, &pcs, sizeof(pcs));
+        return ended;
+    }
+
+#undef BATCH_SELECT
+#endif
+}
+
+// Constructors
+Batch_Engine::Batch_Engine(const Virtual_Machine& machine)
+    : code(machine.get_code()), initial_memory(machine.get_initial_memory()), threads(1), lockstep(true), min_utilization(0.25),
+      inputs(NULL), results(NULL), next_group(0) {
+    statistics.vector_steps = 0;
+    statistics.lane_steps = 0;
+    statistics.scalar_steps = 0;
+    statistics.fallbacks = 0;
+}
+
+// Getters
+const Batch_Engine::Statistics& Batch_Engine::get_statistics() const { return statistics; }
+
+// Setters
+void Batch_Engine::set_threads(size_t count) { threads = count == 0 ? 1 : count; }
+
+void Batch_Engine::set_lockstep(bool enabled) { lockstep = enabled; }
+
+void Batch_Engine::set_min_utilization(double fraction) { min_utilization = fraction; }
+
+// Member functions
+
+/** Run the program once for each input, spreading groups of instances over the threads.
+ *  @param instance_inputs The words READ takes, one list per instance
+ *  @param instance_results Receives the result of each instance, in the same order
+ */
+void Batch_Engine::run(const vector<vector<int32_t> >& instance_inputs, vector<Result>& instance_results) {
+    Result empty;
+    empty.stopped = false;
+    instance_results.assign(instance_inputs.size(), empty);
+
+    inputs = &instance_inputs;
+    results = &instance_results;
+    next_group = 0;
+    statistics.vector_steps = 0;
+    statistics.lane_steps = 0;
+    statistics.scalar_steps = 0;
+    statistics.fallbacks = 0;
+    pthread_mutex_init(&mutex, NULL);
+
+    // The calling thread works too, so threads - 1 more are started; if some fail, fewer do the work
+    vector<pthread_t> workers;
+    for (size_t i = 1; i < threads && i * lanes < instance_inputs.size(); ++i) {
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, &Batch_Engine::work, this) != 0) { break; }
+        workers.push_back(worker);
+    }
+    work(this);
+    for (size_t i = 0; i < workers.size(); ++i) { pthread_join(workers.at(i), NULL); }
+
+    pthread_mutex_destroy(&mutex);
+    inputs = NULL;
+    results = NULL;
+}
+
+/** Run groups until none is left, then add the counts of this thread to the statistics.
+ *  @param engine The Batch_Engine running
+ *  @return: NULL
+ */
+void* Batch_Engine::work(void* engine) {
+    Batch_Engine& self = *static_cast<Batch_Engine*>(engine);
+    Statistics counts;
+    counts.vector_steps = 0;
+    counts.lane_steps = 0;
+    counts.scalar_steps = 0;
+    counts.fallbacks = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&self.mutex);
+        size_t first = self.next_group;
+        self.next_group += lanes;
+        pthread_mutex_unlock(&self.mutex);
+        if (first >= self.inputs->size()) { break; }
+        self.run_group(first, counts);
+    }
+
+    pthread_mutex_lock(&self.mutex);
+    self.statistics.vector_steps += counts.vector_steps;
+    self.statistics.lane_steps += counts.lane_steps;
+    self.statistics.scalar_steps += counts.scalar_steps;
+    self.statistics.fallbacks += counts.fallbacks;
+    pthread_mutex_unlock(&self.mutex);
+    return NULL;
+}
+
+/** Run the instances of one group: in lockstep if enabled, and on their own once their lanes diverge.
+ *  @param first Index of the first instance of the group
+ *  @param counts Receives the counts of the group
+ */
+void Batch_Engine::run_group(size_t first, Statistics& counts) {
+    size_t count = inputs->size() - first < lanes ? inputs->size() - first : lanes;
+    size_t variable_count = initial_memory.size();
+
+#ifdef BATCH_LOCKSTEP
+    if (lockstep) {
+        // Every variable holds one word per lane, so a lockstep LOAD or STORE moves a single vector
+        vector<uint32_t> memory(variable_count * lanes + 1, 0); // One spare word so a program without variables has an address
+        for (size_t variable = 0; variable < variable_count; ++variable) {
+            for (size_t lane = 0; lane < lanes; ++lane) { memory.at(variable * lanes + lane) = static_cast<uint32_t>(initial_memory.at(variable)); }
+        }
+
+        Group group;
+        group.code = &code.at(0);
+        group.memory = &memory.at(0);
+        group.vector_steps = 0;
+        group.lane_steps = 0;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            bool used = lane < count;
+            group.pc[lane] = used ? 0 : finished;
+            group.accumulator[lane] = 0;
+            group.input[lane] = used ? &inputs->at(first + lane) : NULL;
+            group.position[lane] = 0;
+            group.result[lane] = used ? &results->at(first + lane) : NULL;
+        }
+
+        unsigned min_active = static_cast<unsigned>(min_utilization * lanes);
+        bool ended = run_lockstep(group, min_active);
+        counts.vector_steps += group.vector_steps;
+        counts.lane_steps += group.lane_steps;
+        if (ended) { return; }
+
+        // Too few lanes were active: finish each remaining instance on its own from where it stands
+        for (size_t lane = 0; lane < count; ++lane) {
+            if (group.pc[lane] == finished) { continue; }
+            vector<int32_t> lane_memory(variable_count);
+            for (size_t variable = 0; variable < variable_count; ++variable) {
+                lane_memory.at(variable) = static_cast<int32_t>(memory.at(variable * lanes + lane));
+            }
+            counts.scalar_steps += run_instance(first + lane, static_cast<size_t>(group.pc[lane]), static_cast<int32_t>(group.accumulator[lane]), lane_memory, group.position[lane]);
+            ++counts.fallbacks;
+        }
+        return;
+    }
+#endif
+
+    for (size_t lane = 0; lane < count; ++lane) {
+        vector<int32_t> lane_memory(initial_memory);
+        counts.scalar_steps += run_instance(first + lane, 0, 0, lane_memory, 0);
+    }
+}
+
+/** Run one instance on its own, like the Virtual_Machine but on words already parsed.
+ *  @param instance Index of the instance
+ *  @param pc Instruction to start at
+ *  @param accumulator Accumulator to start with
+ *  @param memory Value of each variable, updated in place
+ *  @param position Next word of the input
+ *  @return: The number of instructions executed
+ */
+unsigned long long Batch_Engine::run_instance(size_t instance, size_t pc, int32_t accumulator, vector<int32_t>& memory, size_t position) {
+    const vector<int32_t>& input = inputs->at(instance);
+    Result& result = results->at(instance);
+    const Vm_Instruction* const base = &code.at(0);
+    int32_t* const data = memory.empty() ? NULL : &memory.at(0);
+    unsigned long long count = 0;
+
+    for (;;) {
+        ++count;
+        const Vm_Instruction& instruction = base[pc++];
+        const int32_t operand = instruction.operand;
+        switch (instruction.opcode) {
+        case VM_LOAD: accumulator = data[operand]; break;
+        case VM_LOAD_I: accumulator = operand; break;
+        case VM_STORE: data[operand] = accumulator; break;
+        case VM_ADD: accumulator = wrap(static_cast<uint32_t>(accumulator) + static_cast<uint32_t>(data[operand])); break;
+        case VM_ADD_I: accumulator = wrap(static_cast<uint32_t>(accumulator) + static_cast<uint32_t>(operand)); break;
+        case VM_SUB: accumulator = wrap(static_cast<uint32_t>(accumulator) - static_cast<uint32_t>(data[operand])); break;
+        case VM_SUB_I: accumulator = wrap(static_cast<uint32_t>(accumulator) - static_cast<uint32_t>(operand)); break;
+        case VM_MULT: accumulator = wrap(static_cast<uint32_t>(accumulator) * static_cast<uint32_t>(data[operand])); break;
+        case VM_MULT_I: accumulator = wrap(static_cast<uint32_t>(accumulator) * static_cast<uint32_t>(operand)); break;
+        case VM_DIV:
+        case VM_DIV_I: {
+            int32_t divisor = instruction.opcode == VM_DIV ? data[operand] : operand;
+            if (divisor == 0) {
+                result.error = "division by zero";
+                return count;
+            }
+            accumulator = divide(accumulator, divisor);
+            break;
+        }
+        case VM_READ:
+            if (position >= input.size()) {
+                result.error = "READ past the end of the input";
+                return count;
+            }
+            data[operand] = input.at(position++);
+            break;
+        case VM_WRITE: result.output.push_back(data[operand]); break;
+        case VM_WRITE_I: result.output.push_back(operand); break;
+        case VM_BR: pc = static_cast<size_t>(operand); break;
+        case VM_BRNEG: if (accumulator < 0) { pc = static_cast<size_t>(operand); } break;
+        case VM_BRZNEG: if (accumulator <= 0) { pc = static_cast<size_t>(operand); } break;
+        case VM_BRPOS: if (accumulator > 0) { pc = static_cast<size_t>(operand); } break;
+        case VM_BRZPOS: if (accumulator >= 0) { pc = static_cast<size_t>(operand); } break;
+        case VM_BRZERO: if (accumulator == 0) { pc = static_cast<size_t>(operand); } break;
+        case VM_NOOP: break;
+        case VM_STOP:
+            result.stopped = true;
+            return count;
+        default: // VM_END
+            result.error = "control fell off the end of the program";
+            return count;
+        }
+    }
+}
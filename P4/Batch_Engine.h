@@ -0,0 +1,80 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef BATCH_ENGINE_H
+#define BATCH_ENGINE_H
+
+#include "Virtual_Machine.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// Runs one assembled program over many inputs. Instances run in groups of eight in lockstep,
+// one per 32-bit lane of a 256-bit vector (AVX2 where the processor has it): the accumulator is
+// a vector, each variable is a vector holding every lane's copy, and at every step the lanes at the
+// lowest instruction run it while the others are masked off until control meets again.
+// Groups whose lanes stay apart fall back to running each instance on its own, and a pool of
+// threads takes groups in turn.
+class Batch_Engine {
+public:
+    static const size_t lanes = 8; // Instances run in lockstep
+
+    // The outcome of one instance
+    struct Result {
+        vector<int32_t> output; // Values written, in order
+        bool stopped; // True if the instance reached STOP
+        string error; // Why it failed otherwise
+    };
+
+    // Counts of the last run
+    struct Statistics {
+        unsigned long long vector_steps; // Instructions run in lockstep, once per group
+        unsigned long long lane_steps; // Instructions run in lockstep, once per active lane
+        unsigned long long scalar_steps; // Instructions run one instance at a time
+        unsigned long long fallbacks; // Instances that finished alone after their group diverged
+    };
+
+    // Constructors
+    Batch_Engine(const Virtual_Machine&);
+
+    // Getters
+    const Statistics& get_statistics() const;
+
+    // Setters
+    void set_threads(size_t); // Number of threads, at least 1
+    void set_lockstep(bool); // Run groups in lockstep, or every instance on its own
+    void set_min_utilization(double); // Fraction of active lanes below which a group falls back
+
+    // Member functions
+    void run(const vector<vector<int32_t> >&, vector<Result>&); // Run the program once per input
+
+private:
+    // Data fields
+    const vector<Vm_Instruction> code; // The program, followed by VM_END
+    const vector<int32_t> initial_memory; // Initial value of each variable
+    size_t threads; // Number of threads
+    bool lockstep; // Run groups in lockstep
+    double min_utilization; // Fraction of active lanes below which a group falls back
+    Statistics statistics; // Counts of the last run
+
+    // State of a run, shared by the threads
+    const vector<vector<int32_t> >* inputs; // The input of each instance
+    vector<Result>* results; // The result of each instance
+    size_t next_group; // First instance of the next group to run
+    pthread_mutex_t mutex; // Guards next_group and statistics
+
+    // Member functions
+    Batch_Engine(const Batch_Engine&); // Not copyable, it owns a mutex
+    Batch_Engine& operator=(const Batch_Engine&);
+    static void* work(void*); // Run groups until none is left
+    void run_group(size_t, Statistics&); // Run the instances of a group
+    unsigned long long run_instance(size_t, size_t, int32_t, vector<int32_t>&, size_t); // Run one instance on its own
+};
+
+#endif // BATCH_ENGINE_H
@@ -0,0 +1,199 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "C_Backend.h"
+
+#include <stdint.h>
+#include <vector>
+
+using std::istringstream;
+using std::vector;
+
+// Constructors
+C_Backend::C_Backend(const Program& program) : program(program) {}
+
+// Getters
+string C_Backend::get_source() const { return source; }
+
+// Member functions
+
+/** Translate the program into C. Instructions become statements of main in program order, so the
+ *  C compiler sees the same control flow the Generator emitted and optimizes it as a whole.
+ */
+void C_Backend::translate() {
+    const vector<Instruction>& instructions = program.get_instructions();
+    const vector<string>& storage = program.get_storage();
+    body.str("");
+    targets.clear();
+    helpers.clear();
+
+    bool accumulator = false; // Whether any instruction uses the accumulator, so main declares it
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        const string& opcode = instructions.at(i).opcode;
+        if (instructions.at(i).is_branch()) { targets.insert(instructions.at(i).operand); }
+        if (opcode != "READ" && opcode != "WRITE" && opcode != "BR" && opcode != "NOOP" && opcode != "STOP") { accumulator = true; }
+    }
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        translate_instruction(instructions.at(i));
+    }
+    if (instructions.empty() || (instructions.back().opcode != "STOP" && instructions.back().opcode != "BR")) {
+        use("fail");
+        body << "    fail(\"control fell off the end of the program\");\n";
+        body << "    return 1;\n";
+    }
+
+    ostringstream unit;
+    unit << prelude();
+    unit << "int main(void) {\n";
+    unit << "    static char output_buffer[1 << 16];\n";
+    if (accumulator) { unit << "    int32_t a = 0; /* The accumulator */\n"; }
+    for (size_t i = 0; i < storage.size(); ++i) {
+        unit << "    int32_t " << variable(storage.at(i)) << " = 0;\n";
+    }
+    unit << "\n";
+    unit << "    setvbuf(stdout, output_buffer, _IOFBF, sizeof output_buffer);\n";
+    unit << "\n";
+    unit << body.str();
+    unit << "}\n";
+    source = unit.str();
+}
+
+// Append the statement of an instruction, after its label if a branch jumps to it
+void C_Backend::translate_instruction(const Instruction& instruction) {
+    if (!instruction.label.empty() && targets.count(instruction.label)) {
+        body << label(instruction.label) << ":\n";
+    }
+
+    const string& opcode = instruction.opcode;
+    const string& operand = instruction.operand;
+    body << "    ";
+
+    if (opcode == "LOAD") { body << "a = " << value_of(instruction) << ";"; }
+    else if (opcode == "STORE") { body << variable(operand) << " = a;"; }
+    else if (opcode == "ADD") { use("add"); body << "a = add(a, " << value_of(instruction) << ");"; }
+    else if (opcode == "SUB") { use("subtract"); body << "a = subtract(a, " << value_of(instruction) << ");"; }
+    else if (opcode == "MULT") { use("multiply"); body << "a = multiply(a, " << value_of(instruction) << ");"; }
+    else if (opcode == "DIV") { use("divide"); body << "a = divide(a, " << value_of(instruction) << ");"; }
+    else if (opcode == "READ") { use("read_word"); body << variable(operand) << " = read_word();"; }
+    else if (opcode == "WRITE") { use("write_word"); body << "write_word(" << value_of(instruction) << ");"; }
+    else if (opcode == "BR") { body << "goto " << label(operand) << ";"; }
+    else if (opcode == "BRNEG") { body << "if (a < 0) goto " << label(operand) << ";"; }
+    else if (opcode == "BRZNEG") { body << "if (a <= 0) goto " << label(operand) << ";"; }
+    else if (opcode == "BRPOS") { body << "if (a > 0) goto " << label(operand) << ";"; }
+    else if (opcode == "BRZPOS") { body << "if (a >= 0) goto " << label(operand) << ";"; }
+    else if (opcode == "BRZERO") { body << "if (a == 0) goto " << label(operand) << ";"; }
+    else if (opcode == "NOOP") { body << ";"; }
+    else if (opcode == "STOP") { body << "return 0;"; }
+    else { body << "/* " << instruction.to_string() << " */"; }
+
+    body << "\n";
+}
+
+/** C expression for the operand of an instruction: a variable, or an integer wrapped to a word
+ *  the way the assembler does. The most negative word has no literal of its own in C.
+ *  @param instruction The instruction
+ *  @return: the expression
+ */
+string C_Backend::value_of(const Instruction& instruction) {
+    if (!instruction.has_immediate_operand()) { return variable(instruction.operand); }
+
+    long long value = 0;
+    istringstream(instruction.operand) >> value;
+    int32_t word = static_cast<int32_t>(static_cast<uint32_t>(value));
+
+    ostringstream text;
+    if (static_cast<uint32_t>(word) == 0x80000000u) { text << "(-2147483647 - 1)"; }
+    else { text << word; }
+    return text.str();
+}
+
+// Record that the statements call a helper, and the helpers it calls
+void C_Backend::use(const string& helper) {
+    helpers.insert(helper);
+    if (helper == "add" || helper == "subtract" || helper == "multiply") { helpers.insert("wrap"); }
+    if (helper == "divide") {
+        helpers.insert("wrap");
+        helpers.insert("fail");
+    }
+    if (helper == "read_word") {
+        helpers.insert("wrap");
+        helpers.insert("fail");
+    }
+}
+
+/** The includes and the helpers the statements call, each once, in dependency order.
+ *  Arithmetic goes through uint32_t so that it wraps around instead of overflowing.
+ *  @return: the start of the translation unit
+ */
+string C_Backend::prelude() const {
+    ostringstream text;
+    text << "/* Generated by compile from accumulator assembly */\n";
+    text << "#include <stdint.h>\n";
+    text << "#include <stdio.h>\n";
+    text << "#include <stdlib.h>\n";
+    text << "\n";
+
+    if (helpers.count("wrap")) {
+        text << "/* Words are 32 bits and wrap around like the target's */\n";
+        text << "static int32_t wrap(uint32_t value) { return (int32_t)value; }\n\n";
+    }
+    if (helpers.count("add")) {
+        text << "static int32_t add(int32_t left, int32_t right) { return wrap((uint32_t)left + (uint32_t)right); }\n\n";
+    }
+    if (helpers.count("subtract")) {
+        text << "static int32_t subtract(int32_t left, int32_t right) { return wrap((uint32_t)left - (uint32_t)right); }\n\n";
+    }
+    if (helpers.count("multiply")) {
+        text << "static int32_t multiply(int32_t left, int32_t right) { return wrap((uint32_t)left * (uint32_t)right); }\n\n";
+    }
+    if (helpers.count("fail")) {
+        text << "static void fail(const char* reason) {\n";
+        text << "    fflush(stdout);\n";
+        text << "    fprintf(stderr, \"[Error] %s\\n\", reason);\n";
+        text << "    exit(1);\n";
+        text << "}\n\n";
+    }
+    if (helpers.count("divide")) {
+        text << "/* Division truncating toward zero; the one quotient that does not fit wraps around */\n";
+        text << "static int32_t divide(int32_t left, int32_t right) {\n";
+        text << "    if (right == 0) { fail(\"division by zero\"); }\n";
+        text << "    if (right == -1) { return wrap(0u - (uint32_t)left); }\n";
+        text << "    return left / right;\n";
+        text << "}\n\n";
+    }
+    if (helpers.count("read_word")) {
+        text << "/* Next whitespace-separated integer of the input, wrapped to a word */\n";
+        text << "static int32_t read_word(void) {\n";
+        text << "    uint32_t magnitude = 0;\n";
+        text << "    int negative;\n";
+        text << "    int c = getchar();\n";
+        text << "    while (c == ' ' || c == '\\t' || c == '\\n' || c == '\\r') { c = getchar(); }\n";
+        text << "    if (c == EOF) { fail(\"READ past the end of the input\"); }\n";
+        text << "    negative = c == '-';\n";
+        text << "    if (c == '-' || c == '+') { c = getchar(); }\n";
+        text << "    if (c < '0' || c > '9') { fail(\"READ found something other than an integer\"); }\n";
+        text << "    while (c >= '0' && c <= '9') {\n";
+        text << "        magnitude = magnitude * 10 + (uint32_t)(c - '0');\n";
+        text << "        c = getchar();\n";
+        text << "    }\n";
+        text << "    if (c != EOF) { ungetc(c, stdin); }\n";
+        text << "    return wrap(negative ? 0u - magnitude : magnitude);\n";
+        text << "}\n\n";
+    }
+    if (helpers.count("write_word")) {
+        text << "static void write_word(int32_t value) { printf(\"%ld\\n\", (long)value); }\n\n";
+    }
+
+    return text.str();
+}
+
+// C name of a variable, prefixed so that no name of the source clashes with C
+string C_Backend::variable(const string& name) {
+    if (!name.empty() && name.at(0) == GENERATED_PREFIX) { return "g_" + name.substr(1); } // $ is not portable C
+    return "v_" + name;
+}
+
+// C name of a label
+string C_Backend::label(const string& name) { return "l_" + name; }
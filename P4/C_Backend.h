@@ -0,0 +1,49 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef C_BACKEND_H
+#define C_BACKEND_H
+
+#include "Program.h"
+
+#include <set>
+#include <sstream>
+#include <string>
+
+using std::ostringstream;
+using std::set;
+using std::string;
+
+// Translates the lowered program into one portable C translation unit: the accumulator and the
+// variables become locals of main, labels become gotos, and READ and WRITE use buffered stdio.
+// The C program behaves like the Virtual_Machine, runtime errors included.
+class C_Backend {
+public:
+    // Constructors
+    C_Backend(const Program&);
+
+    // Getters
+    string get_source() const; // The C translation unit
+
+    // Member functions
+    void translate(); // Translate the program into C
+
+private:
+    // Data fields
+    const Program& program; // The program to translate
+    ostringstream body; // Statements of main
+    set<string> targets; // Labels some branch jumps to
+    set<string> helpers; // Helper functions the statements call
+    string source; // The translation unit
+
+    // Member functions
+    void translate_instruction(const Instruction&); // Append the statement of an instruction
+    string value_of(const Instruction&); // C expression for the operand of an instruction
+    void use(const string&); // Record that the statements call a helper
+    string prelude() const; // The includes and the helpers the statements call
+    static string variable(const string&); // C name of a variable
+    static string label(const string&); // C name of a label
+};
+
+#endif // C_BACKEND_H
@@ -0,0 +1,813 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef CONSTEXPR_COMPILER_H
+#define CONSTEXPR_COMPILER_H
+
+#if __cplusplus < 202002L
+#error "Constexpr_Compiler.h needs C++20 (-std=c++20) for constexpr strings and vectors"
+#endif
+
+#include "Token.h"
+#include "Virtual_Machine.h"
+
+#include <array>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+using std::array;
+using std::string;
+using std::string_view;
+using std::vector;
+
+// Why a compilation failed. It is thrown: while the C++ compiler evaluates a program at compile
+// time that makes the evaluation fail, and the diagnostic shows the call to Constexpr_Compiler::fail
+// with the message and the line; at run time it can be caught.
+struct Constexpr_Error {
+    const char* message; // What is wrong, worded like the Parser's and Static_Semantics' errors
+    string name; // The variable or func it is about, empty if none
+    size_t line; // Line of the source
+
+    // Member functions
+    string describe() const; // The line, the message and the name
+};
+
+// Compiles a program to VM bytecode with nothing but constexpr code, so that it can run while the
+// C++ compiler evaluates a constant. It scans, parses and checks like Scanner, Parser and
+// Static_Semantics and reports the same errors, then generates accumulator code: an expression
+// leaves its value in the accumulator, the right operand of a binary operator is computed first
+// into a temporary unless it is a variable or an integer, and a call is replaced by the body of its
+// func. Variables start at 0 and temporaries get addresses after them.
+class Constexpr_Compiler {
+public:
+    // Constructors
+    constexpr Constexpr_Compiler(string_view);
+
+    // Getters
+    constexpr const vector<Vm_Instruction>& get_code() const; // The program, ending with STOP
+    constexpr const vector<string>& get_variables() const; // Name of each variable, by address
+    constexpr size_t get_name_bytes() const; // Bytes of the names, each followed by a NUL
+
+    // Member functions
+    constexpr void compile(); // Compile the source, throwing a Constexpr_Error if it is invalid
+    static constexpr void fail(const char*, size_t, string_view = string_view()); // Throw a Constexpr_Error
+
+private:
+    // Kinds of parsed nodes
+    enum Kind {
+        CONSTANT, VARIABLE, ADD, SUBTRACT, MULTIPLY, DIVIDE, NEGATE, // Expressions
+        READ, PRINT, ASSIGN, IF, LOOP, SEQUENCE, CALL // Statements
+    };
+
+    // Relational operators, decided by the sign of (left - right)
+    enum Relation { GE, LE, GT, LT, EQ, NE };
+
+    // What the static semantics check, in the order the tree walk meets it
+    enum Check { DECLARE, USE, CALLED };
+
+    // One token of the source
+    struct Lexeme {
+        TokenID id;
+        string_view text;
+        size_t line;
+    };
+
+    // One parsed node; which fields are used depends on the kind
+    struct Code {
+        int32_t kind; // A Kind
+        int32_t value; // Constant, address of a variable, Relation, or func of a CALL
+        int32_t left; // First operand, or the first child of a SEQUENCE in sequence
+        int32_t right; // Second operand, or the number of children of a SEQUENCE
+        int32_t body; // Statement run by an IF or a LOOP
+    };
+
+    // A name to check
+    struct Symbol {
+        int32_t check; // A Check
+        string_view name;
+        size_t line;
+    };
+
+    // A func definition
+    struct Function {
+        string_view name;
+        size_t line;
+        int32_t body; // Node of its <block>
+        vector<Symbol> calls; // The calls in its body
+    };
+
+    // Data fields
+    string_view source; // The program text
+    vector<Lexeme> tokens; // The scanned source, ending with EOF_TK
+    size_t position; // Next token to parse
+    vector<Code> nodes; // The parsed program
+    int32_t root; // Node of the main <block>
+    vector<int32_t> sequence; // Children of every SEQUENCE, each a node index
+    vector<Symbol> symbols; // Declarations, uses and calls in source order
+    vector<Function> functions; // Every func, in order of definition
+    int32_t current_function; // Func whose body is being parsed, -1 outside
+    bool checking_uses; // Inside a read, print or set, whose variables must be declared
+    vector<string> variables; // Name of each variable, by address
+    vector<int32_t> temporaries; // Address of the temporary at each depth
+    vector<Vm_Instruction> code; // The generated program
+
+    // Scanning
+    constexpr void scan(); // Split the source into tokens
+    static constexpr bool is_keyword(string_view); // Check whether a word is a keyword
+
+    // Parsing
+    constexpr const Lexeme& current() const; // The token being parsed
+    constexpr bool at(TokenID, string_view) const; // Check the kind and text of the current token
+    constexpr bool at_keyword(string_view) const; // Check whether the current token is a keyword
+    constexpr bool at_operator(string_view) const; // Check whether the current token is an operator
+    constexpr void expect(TokenID, string_view, const char*); // Consume a token, failing with the message if it is not there
+    constexpr int32_t add_node(int32_t, int32_t = 0, int32_t = 0, int32_t = 0, int32_t = 0); // Append a node
+    constexpr int32_t address_of(string_view); // Address of a variable, allocated on first sight
+    constexpr void parse_program(); // <program> -> program <vars> <funcs> <block>
+    constexpr void parse_vars(); // <vars> -> empty | var <varList>
+    constexpr void parse_funcs(); // <funcs> -> empty | func identifier <block> <funcs>
+    constexpr int32_t parse_block(); // <block> -> start <vars> <stats> stop
+    constexpr int32_t parse_stat(); // <stat> -> <read> | <print> | <block> | <cond> | <iter> | <assign> | <call>
+    constexpr int32_t parse_compare(int32_t, const char*, const char*); // [ <exp> <relational> <exp> ] <stat> of an iff or iterate
+    constexpr int32_t parse_exp(); // <exp> -> <M> + <exp> | <M> - <exp> | <M>
+    constexpr int32_t parse_m(); // <M> -> <N> % <M> | <N>
+    constexpr int32_t parse_n(); // <N> -> <R> / <N> | -<N> | <R>
+    constexpr int32_t parse_r(); // <R> -> (<exp>) | identifier | integer
+
+    // Static semantics
+    constexpr void check(); // Check funcs and variables like Static_Semantics
+    constexpr int32_t find_function(string_view) const; // Index of a func, -1 if undefined
+    constexpr void check_recursion(int32_t, vector<int32_t>&) const; // Check that a func does not call itself
+
+    // Code generation
+    constexpr void emit(int32_t, int32_t = 0); // Append an instruction
+    constexpr int32_t temporary(size_t); // Address of the temporary at a depth
+    constexpr void generate_statement(int32_t); // Generate a statement
+    constexpr void generate_compare(const Code&, vector<size_t>&); // Compute left - right and branch past the statement when false
+    constexpr void generate_value(int32_t, size_t); // Leave an expression in the accumulator, with temporaries from a depth
+};
+
+// Text of a program, usable as a template argument so that it can be compiled in a constant expression
+template <size_t Length>
+struct Program_Text {
+    char text[Length];
+
+    // Constructors
+    constexpr Program_Text(const char (&literal)[Length]) {
+        for (size_t i = 0; i < Length; ++i) { text[i] = literal[i]; }
+    }
+
+    // Getters
+    constexpr string_view get_source() const { return string_view(text, Length - 1); }
+};
+
+// A program compiled at compile time, held in arrays sized to fit it
+template <size_t Instructions, size_t Name_Bytes>
+struct Embedded_Program {
+    array<Vm_Instruction, Instructions> code; // The program, ending with STOP
+    array<char, Name_Bytes> names; // Name of each variable followed by a NUL, by address
+
+    // Getters
+    vector<string> get_variables() const {
+        vector<string> variables;
+        string name;
+        for (size_t i = 0; i < Name_Bytes; ++i) {
+            if (names[i] == '\0') {
+                variables.push_back(name);
+                name.clear();
+            } else {
+                name += names[i];
+            }
+        }
+        return variables;
+    }
+
+    // Member functions
+    void load_into(Virtual_Machine& machine) const { machine.load(code.data(), code.size(), get_variables()); }
+};
+
+/** Compile a program while the C++ compiler evaluates the call, e.g.
+ *  constexpr auto program = embed_program<"program start print 1 ; stop">();
+ *  An invalid program is a compile error whose diagnostic shows the message and the line.
+ *  @return: The bytecode and the variable names
+ */
+template <Program_Text Source>
+consteval auto embed_program() {
+    // Compiled once for the sizes, which the arrays need as constants, and again to fill them
+    constexpr array<size_t, 2> sizes = [] {
+        Constexpr_Compiler compiler(Source.get_source());
+        compiler.compile();
+        return array<size_t, 2>{ compiler.get_code().size(), compiler.get_name_bytes() };
+    }();
+    constexpr size_t instructions = sizes[0];
+    constexpr size_t name_bytes = sizes[1];
+
+    Constexpr_Compiler compiler(Source.get_source());
+    compiler.compile();
+    Embedded_Program<instructions, name_bytes> program{};
+    for (size_t i = 0; i < instructions; ++i) { program.code[i] = compiler.get_code()[i]; }
+    size_t next = 0;
+    for (size_t i = 0; i < compiler.get_variables().size(); ++i) {
+        const string& name = compiler.get_variables()[i];
+        for (size_t j = 0; j < name.size(); ++j) { program.names[next++] = name[j]; }
+        program.names[next++] = '\0';
+    }
+    return program;
+}
+
+// Constexpr_Error
+
+// Member functions
+
+// The line, the message and the name, e.g. "Line 4: ERROR in static semantics: Variable used without declaration: y"
+inline string Constexpr_Error::describe() const {
+    string text = "Line " + std::to_string(line) + ": " + message;
+    if (!name.empty()) { text += ": " + name; }
+    return text;
+}
+
+// Constexpr_Compiler
+
+// Constructors
+constexpr Constexpr_Compiler::Constexpr_Compiler(string_view source)
+    : source(source), position(0), root(0), current_function(-1), checking_uses(false) {}
+
+// Getters
+constexpr const vector<Vm_Instruction>& Constexpr_Compiler::get_code() const { return code; }
+
+constexpr const vector<string>& Constexpr_Compiler::get_variables() const { return variables; }
+
+constexpr size_t Constexpr_Compiler::get_name_bytes() const {
+    size_t bytes = 0;
+    for (size_t i = 0; i < variables.size(); ++i) { bytes += variables[i].size() + 1; }
+    return bytes;
+}
+
+// Member functions
+
+// Compile the source, throwing a Constexpr_Error if it is invalid
+constexpr void Constexpr_Compiler::compile() {
+    tokens.clear();
+    position = 0;
+    nodes.clear();
+    root = 0;
+    sequence.clear();
+    symbols.clear();
+    functions.clear();
+    current_function = -1;
+    variables.clear();
+    temporaries.clear();
+    code.clear();
+
+    scan();
+    parse_program();
+    check();
+    generate_statement(root);
+    emit(VM_STOP);
+}
+
+/** Throw a Constexpr_Error. The throw is conditional because a constexpr function that can only
+ *  throw is rejected, but the message is never null.
+ *  @param message What is wrong
+ *  @param line Line of the source
+ *  @param name The variable or func it is about, if any
+ */
+constexpr void Constexpr_Compiler::fail(const char* message, size_t line, string_view name) {
+    if (std::is_constant_evaluated()) {
+        // Reading past the array stops the evaluation with a diagnostic that shows the value of the line
+        const bool error_at_line[1] = { true };
+        if (!error_at_line[line]) { return; }
+    }
+    if (message != nullptr) { throw Constexpr_Error{message, string(name), line}; }
+}
+
+// Scanning
+
+// Split the source into tokens like Scanner, which also skips @@comments@
+constexpr void Constexpr_Compiler::scan() {
+    size_t line = 1;
+    size_t i = 0;
+    while (true) {
+        // Skip whitespace and comments
+        while (i < source.size()) {
+            char c = source[i];
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+                if (c == '\n') { ++line; }
+                ++i;
+            } else if (c == '@' && i + 1 < source.size() && source[i + 1] == '@') {
+                i += 2;
+                while (i < source.size() && source[i] != '@') {
+                    if (source[i] == '\n') { ++line; }
+                    ++i;
+                }
+                if (i < source.size()) { ++i; } // The closing '@'
+            } else {
+                break;
+            }
+        }
+        if (i == source.size()) {
+            tokens.push_back(Lexeme{EOF_TK, "EOF", line});
+            return;
+        }
+
+        size_t start = i;
+        char c = source[i];
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        bool digit = c >= '0' && c <= '9';
+        if (alpha) {
+            ++i;
+            while (i < source.size() && ((source[i] >= 'a' && source[i] <= 'z') || (source[i] >= 'A' && source[i] <= 'Z') ||
+                                         (source[i] >= '0' && source[i] <= '9') || source[i] == '_')) { ++i; }
+            string_view word = source.substr(start, i - start);
+            tokens.push_back(Lexeme{is_keyword(word) ? KW_TK : IDENT_TK, word, line});
+        } else if (digit) {
+            while (i < source.size() && source[i] >= '0' && source[i] <= '9') { ++i; }
+            tokens.push_back(Lexeme{NUM_TK, source.substr(start, i - start), line});
+        } else if (string_view("~:;+-/%(){}[],=").find(c) != string_view::npos) {
+            ++i;
+            tokens.push_back(Lexeme{OP_TK, source.substr(start, 1), line});
+        } else if (c == '*' && i + 1 < source.size() && source[i + 1] == '*') {
+            i += 2;
+            tokens.push_back(Lexeme{OP_TK, source.substr(start, 2), line});
+        } else if (c == '.' && i + 3 < source.size() && (source[i + 1] == 'l' || source[i + 1] == 'g') &&
+                   (source[i + 2] == 'e' || source[i + 2] == 't') && source[i + 3] == '.') {
+            i += 4;
+            tokens.push_back(Lexeme{OP_TK, source.substr(start, 4), line});
+        } else {
+            fail("LEXICAL ERROR: Invalid token is found", line, source.substr(start, 1));
+        }
+    }
+}
+
+// Check whether a word is one of Scanner's keywords
+constexpr bool Constexpr_Compiler::is_keyword(string_view word) {
+    const string_view keywords[] = { "start", "stop", "iterate", "var", "exit", "read", "print", "iff", "then", "set", "func", "program" };
+    for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); ++i) {
+        if (keywords[i] == word) { return true; }
+    }
+    return false;
+}
+
+// Parsing
+
+// The token being parsed
+constexpr const Constexpr_Compiler::Lexeme& Constexpr_Compiler::current() const { return tokens[position]; }
+
+// Check the kind and text of the current token
+constexpr bool Constexpr_Compiler::at(TokenID id, string_view text) const {
+    return current().id == id && current().text == text;
+}
+
+constexpr bool Constexpr_Compiler::at_keyword(string_view text) const { return at(KW_TK, text); }
+
+constexpr bool Constexpr_Compiler::at_operator(string_view text) const { return at(OP_TK, text); }
+
+/** Consume a token of a kind, and with a text unless it is empty
+ *  @param id The kind expected
+ *  @param text The text expected, empty for any
+ *  @param message The error if the token is not there
+ */
+constexpr void Constexpr_Compiler::expect(TokenID id, string_view text, const char* message) {
+    if (current().id != id || (!text.empty() && current().text != text)) { fail(message, current().line); }
+    ++position;
+}
+
+// Append a node and return its index
+constexpr int32_t Constexpr_Compiler::add_node(int32_t kind, int32_t value, int32_t left, int32_t right, int32_t body) {
+    nodes.push_back(Code{kind, value, left, right, body});
+    return static_cast<int32_t>(nodes.size() - 1);
+}
+
+// Address of a variable, allocated on first sight
+constexpr int32_t Constexpr_Compiler::address_of(string_view name) {
+    for (size_t i = 0; i < variables.size(); ++i) {
+        if (variables[i] == name) { return static_cast<int32_t>(i); }
+    }
+    variables.push_back(string(name));
+    return static_cast<int32_t>(variables.size() - 1);
+}
+
+// <program> -> program <vars> <funcs> <block>
+constexpr void Constexpr_Compiler::parse_program() {
+    expect(KW_TK, "program", "Syntax error: Expected 'program' keyword.");
+    parse_vars();
+    parse_funcs();
+    root = parse_block();
+    expect(EOF_TK, "", "Syntax error: Unexpected token received, EOF_TK expected.");
+}
+
+// <vars> -> empty | var <varList>, <varList> -> identifier , integer ; | identifier , integer <varList>
+constexpr void Constexpr_Compiler::parse_vars() {
+    if (!at_keyword("var")) { return; }
+    ++position;
+
+    do {
+        const Lexeme& name = current();
+        expect(IDENT_TK, "", "Syntax error: Expected an identifier in <varList>.");
+        symbols.push_back(Symbol{DECLARE, name.text, name.line});
+        address_of(name.text);
+        expect(OP_TK, ",", "Syntax error: Expected a ',' in <varList>.");
+        expect(NUM_TK, "", "Syntax error: Expected an integer in <varList>."); // Variables start at 0 regardless
+    } while (!at_operator(";"));
+    ++position;
+}
+
+// <funcs> -> empty | func identifier <block> <funcs>
+constexpr void Constexpr_Compiler::parse_funcs() {
+    while (at_keyword("func")) {
+        ++position;
+        const Lexeme& name = current();
+        expect(IDENT_TK, "", "Syntax Error: Expected an identifier after 'func' in <funcs>.");
+
+        functions.push_back(Function{name.text, name.line, -1, vector<Symbol>()});
+        current_function = static_cast<int32_t>(functions.size() - 1);
+        int32_t body = parse_block();
+        functions[current_function].body = body;
+        current_function = -1;
+    }
+}
+
+// <block> -> start <vars> <stats> stop, with <stats> -> <stat> <mStat> and <mStat> -> empty | <stat> <mStat>
+constexpr int32_t Constexpr_Compiler::parse_block() {
+    expect(KW_TK, "start", "Syntax Error: Expected 'start' keyword at the beginning of <block>.");
+    parse_vars();
+
+    vector<int32_t> children;
+    children.push_back(parse_stat());
+    while (at_keyword("read") || at_keyword("print") || at_keyword("iff") || at_keyword("iterate") ||
+           at_keyword("set") || at_keyword("start") || at_keyword("func")) {
+        children.push_back(parse_stat());
+    }
+
+    expect(KW_TK, "stop", "Syntax Error: Expected 'stop' keyword at the end of <block>.");
+
+    int32_t first = static_cast<int32_t>(sequence.size());
+    sequence.insert(sequence.end(), children.begin(), children.end());
+    return add_node(SEQUENCE, 0, first, static_cast<int32_t>(children.size()));
+}
+
+// <stat> -> <read> | <print> | <block> | <cond> | <iter> | <assign> | <call>
+constexpr int32_t Constexpr_Compiler::parse_stat() {
+    if (current().id != KW_TK) { fail("Syntax Error: Expected a statement keyword in <stat>", current().line); }
+
+    if (at_keyword("read")) {
+        ++position;
+        const Lexeme& name = current();
+        expect(IDENT_TK, "", "Syntax Error: Expected an identifier after 'read' in <read>.");
+        symbols.push_back(Symbol{USE, name.text, name.line});
+        expect(OP_TK, ";", "Syntax Error: Expected ';' at the end of <read>.");
+        return add_node(READ, address_of(name.text));
+    }
+    if (at_keyword("print")) {
+        ++position;
+        checking_uses = true;
+        int32_t value = parse_exp();
+        checking_uses = false;
+        expect(OP_TK, ";", "Syntax Error: Expected ';' at the end of <print>.");
+        return add_node(PRINT, 0, value);
+    }
+    if (at_keyword("start")) { return parse_block(); }
+    if (at_keyword("iff")) {
+        ++position;
+        return parse_compare(IF, "Syntax Error: Expected '[' after 'iff' in <cond>.", "Syntax error: Expected ']' in <cond>.");
+    }
+    if (at_keyword("iterate")) {
+        ++position;
+        return parse_compare(LOOP, "Syntax Error: Expected '[' after 'iterate' in <iter>.", "Syntax error: Expected ']' in <iter>.");
+    }
+    if (at_keyword("set")) {
+        ++position;
+        const Lexeme& name = current();
+        expect(IDENT_TK, "", "Syntax Error: Expected an identifier after 'set' in <assign>.");
+        symbols.push_back(Symbol{USE, name.text, name.line});
+        checking_uses = true;
+        int32_t value = parse_exp();
+        checking_uses = false;
+        expect(OP_TK, ";", "Syntax Error: Expected ';' at the end of <assign>.");
+        return add_node(ASSIGN, address_of(name.text), value);
+    }
+    if (at_keyword("func")) {
+        ++position;
+        const Lexeme& name = current();
+        expect(IDENT_TK, "", "Syntax Error: Expected an identifier after 'func' in <call>.");
+        expect(OP_TK, ";", "Syntax Error: Expected ';' at the end of <call>.");
+        symbols.push_back(Symbol{CALLED, name.text, name.line});
+        if (current_function >= 0) { functions[current_function].calls.push_back(Symbol{CALLED, name.text, name.line}); }
+        return add_node(CALL); // Its func is found once all are defined
+    }
+
+    fail("Syntax Error: Unexpected keyword in <stat>", current().line, current().text);
+    return 0;
+}
+
+/** Parse the [ <exp> <relational> <exp> ] <stat> of an iff or iterate
+ *  @param kind IF or LOOP
+ *  @param open_error The error if '[' is missing
+ *  @param close_error The error if ']' is missing
+ *  @return: The node
+ */
+constexpr int32_t Constexpr_Compiler::parse_compare(int32_t kind, const char* open_error, const char* close_error) {
+    expect(OP_TK, "[", open_error);
+    int32_t left = parse_exp();
+
+    // <relational> -> .le. | .ge. | .lt. | .gt. | ** | ~
+    int32_t relation = GE;
+    if (at_operator(".ge.")) { relation = GE; }
+    else if (at_operator(".le.")) { relation = LE; }
+    else if (at_operator(".gt.")) { relation = GT; }
+    else if (at_operator(".lt.")) { relation = LT; }
+    else if (at_operator("**")) { relation = EQ; }
+    else if (at_operator("~")) { relation = NE; }
+    else { fail("Syntax Error: Expected a relational operator in <relational>.", current().line); }
+    ++position;
+
+    int32_t right = parse_exp();
+    expect(OP_TK, "]", close_error);
+    int32_t body = parse_stat();
+    return add_node(kind, relation, left, right, body);
+}
+
+// <exp> -> <M> + <exp> | <M> - <exp> | <M>, grouped from the right like the Generator
+constexpr int32_t Constexpr_Compiler::parse_exp() {
+    vector<int32_t> operands;
+    vector<int32_t> operators;
+    operands.push_back(parse_m());
+    while (at_operator("+") || at_operator("-")) {
+        bool add = at_operator("+");
+        ++position;
+        if (add && at_operator("+")) { fail("Syntax Error: Expected an integer or an identifier after '+' in <exp>.", current().line); }
+        operators.push_back(add ? ADD : SUBTRACT);
+        operands.push_back(parse_m());
+    }
+
+    int32_t value = operands.back();
+    for (size_t i = operators.size(); i-- > 0;) { value = add_node(operators[i], 0, operands[i], value); }
+    return value;
+}
+
+// <M> -> <N> % <M> | <N>
+constexpr int32_t Constexpr_Compiler::parse_m() {
+    int32_t left = parse_n();
+    if (!at_operator("%")) { return left; }
+    ++position;
+    return add_node(MULTIPLY, 0, left, parse_m());
+}
+
+// <N> -> <R> / <N> | -<N> | <R>, where only an identifier or an integer may follow '/'
+constexpr int32_t Constexpr_Compiler::parse_n() {
+    if (at_operator("-")) {
+        ++position;
+        return add_node(NEGATE, 0, parse_n());
+    }
+
+    vector<int32_t> operands;
+    operands.push_back(parse_r());
+    while (at_operator("/")) {
+        ++position;
+        if (current().id != IDENT_TK && current().id != NUM_TK) {
+            fail("Syntax Error: Expected an identifier or an integer after '/' in <N>.", current().line);
+        }
+        operands.push_back(parse_r());
+    }
+
+    int32_t value = operands.back();
+    for (size_t i = operands.size() - 1; i-- > 0;) { value = add_node(DIVIDE, 0, operands[i], value); }
+    return value;
+}
+
+// <R> -> (<exp>) | identifier | integer
+constexpr int32_t Constexpr_Compiler::parse_r() {
+    const Lexeme& token = current();
+    if (at_operator("(")) {
+        ++position;
+        int32_t value = parse_exp();
+        expect(OP_TK, ")", "Syntax Error: Expected ')' in <R>.");
+        return value;
+    }
+    if (token.id == IDENT_TK) {
+        ++position;
+        if (checking_uses) { symbols.push_back(Symbol{USE, token.text, token.line}); }
+        return add_node(VARIABLE, address_of(token.text));
+    }
+    if (token.id == NUM_TK) {
+        ++position;
+        uint32_t value = 0; // Wraps around like the assembler's integers
+        for (size_t i = 0; i < token.text.size(); ++i) { value = value * 10 + static_cast<uint32_t>(token.text[i] - '0'); }
+        return add_node(CONSTANT, static_cast<int32_t>(value));
+    }
+
+    fail("Syntax Error: Expected '(', an identifier or an integer in <R>.", token.line);
+    return 0;
+}
+
+// Static semantics
+
+/** Check funcs and variables like Static_Semantics: func redefinitions and recursion first, then
+ *  declarations, uses and calls in the order of the tree walk, over one flat table. Only the
+ *  variables of a read, print or set must be declared before they are used.
+ */
+constexpr void Constexpr_Compiler::check() {
+    for (size_t i = 0; i < functions.size(); ++i) {
+        if (find_function(functions[i].name) != static_cast<int32_t>(i)) {
+            fail("ERROR in static semantics: Function redefined", functions[i].line, functions[i].name);
+        }
+    }
+    for (size_t i = 0; i < functions.size(); ++i) {
+        vector<int32_t> path;
+        check_recursion(static_cast<int32_t>(i), path);
+    }
+
+    vector<string_view> declared;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        const Symbol& symbol = symbols[i];
+        bool found = false;
+        for (size_t j = 0; j < declared.size() && !found; ++j) { found = declared[j] == symbol.name; }
+
+        if (symbol.check == DECLARE) {
+            if (found) { fail("ERROR in static semantics: Variable redefined", symbol.line, symbol.name); }
+            declared.push_back(symbol.name);
+        } else if (symbol.check == USE) {
+            if (!found) { fail("ERROR in static semantics: Variable used without declaration", symbol.line, symbol.name); }
+        } else if (find_function(symbol.name) < 0) {
+            fail("ERROR in static semantics: Function called without definition", symbol.line, symbol.name);
+        }
+    }
+
+    // Every call now has a func to stand for
+    size_t next_call = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].kind != CALL) { continue; }
+        while (symbols[next_call].check != CALLED) { ++next_call; }
+        nodes[i].value = find_function(symbols[next_call++].name);
+    }
+}
+
+// Index of the first func with a name, -1 if it is undefined
+constexpr int32_t Constexpr_Compiler::find_function(string_view name) const {
+    for (size_t i = 0; i < functions.size(); ++i) {
+        if (functions[i].name == name) { return static_cast<int32_t>(i); }
+    }
+    return -1;
+}
+
+/** Check that a func does not call itself, directly or through other funcs; each call is replaced
+ *  by the body of its func, so recursion could not be generated.
+ *  @param function The func to check
+ *  @param path The funcs being called on the way to this one
+ */
+constexpr void Constexpr_Compiler::check_recursion(int32_t function, vector<int32_t>& path) const {
+    path.push_back(function);
+    const vector<Symbol>& calls = functions[function].calls;
+    for (size_t i = 0; i < calls.size(); ++i) {
+        int32_t callee = find_function(calls[i].name);
+        if (callee < 0) { continue; } // Reported as a call without definition
+        for (size_t j = 0; j < path.size(); ++j) {
+            if (path[j] == callee) { fail("ERROR in static semantics: Function called recursively", calls[i].line, calls[i].name); }
+        }
+        check_recursion(callee, path);
+    }
+    path.pop_back();
+}
+
+// Code generation
+
+// Append an instruction
+constexpr void Constexpr_Compiler::emit(int32_t opcode, int32_t operand) { code.push_back(Vm_Instruction{opcode, operand}); }
+
+// Address of the temporary at a depth, allocated after the variables on first use
+constexpr int32_t Constexpr_Compiler::temporary(size_t depth) {
+    while (temporaries.size() <= depth) {
+        string name = "$T"; // Named like the temporaries of compile
+        size_t number = temporaries.size();
+        string digits;
+        do {
+            digits.insert(digits.begin(), static_cast<char>('0' + number % 10));
+            number /= 10;
+        } while (number != 0);
+        temporaries.push_back(static_cast<int32_t>(variables.size()));
+        variables.push_back(name + digits);
+    }
+    return temporaries[depth];
+}
+
+// Generate a statement
+constexpr void Constexpr_Compiler::generate_statement(int32_t index) {
+    const Code node = nodes[index];
+    switch (node.kind) {
+    case READ:
+        emit(VM_READ, node.value);
+        break;
+    case PRINT: {
+        const Code& value = nodes[node.left];
+        if (value.kind == CONSTANT) { emit(VM_WRITE_I, value.value); }
+        else if (value.kind == VARIABLE) { emit(VM_WRITE, value.value); }
+        else {
+            generate_value(node.left, 0);
+            emit(VM_STORE, temporary(0));
+            emit(VM_WRITE, temporary(0));
+        }
+        break;
+    }
+    case ASSIGN:
+        generate_value(node.left, 0);
+        emit(VM_STORE, node.value);
+        break;
+    case IF: {
+        vector<size_t> exits;
+        generate_compare(node, exits);
+        generate_statement(node.body);
+        for (size_t i = 0; i < exits.size(); ++i) { code[exits[i]].operand = static_cast<int32_t>(code.size()); }
+        break;
+    }
+    case LOOP: {
+        int32_t top = static_cast<int32_t>(code.size());
+        vector<size_t> exits;
+        generate_compare(node, exits);
+        generate_statement(node.body);
+        emit(VM_BR, top);
+        for (size_t i = 0; i < exits.size(); ++i) { code[exits[i]].operand = static_cast<int32_t>(code.size()); }
+        break;
+    }
+    case SEQUENCE:
+        for (int32_t i = 0; i < node.right; ++i) { generate_statement(sequence[node.left + i]); }
+        break;
+    case CALL:
+        generate_statement(functions[node.value].body);
+        break;
+    }
+}
+
+/** Compute left - right and branch past the statement when the comparison is false
+ *  @param node The IF or LOOP
+ *  @param exits Receives the branches, whose targets are set once the statement is generated
+ */
+constexpr void Constexpr_Compiler::generate_compare(const Code& node, vector<size_t>& exits) {
+    int32_t difference = add_node(SUBTRACT, 0, node.left, node.right);
+    generate_value(difference, 0);
+
+    // Branches taken when the comparison is false
+    int32_t branches[2] = { VM_BRNEG, -1 };
+    switch (node.value) {
+    case GE: branches[0] = VM_BRNEG; break;
+    case LE: branches[0] = VM_BRPOS; break;
+    case GT: branches[0] = VM_BRZNEG; break;
+    case LT: branches[0] = VM_BRZPOS; break;
+    case EQ: branches[0] = VM_BRNEG; branches[1] = VM_BRPOS; break;
+    case NE: branches[0] = VM_BRZERO; break;
+    }
+    for (size_t i = 0; i < 2 && branches[i] >= 0; ++i) {
+        exits.push_back(code.size());
+        emit(branches[i]);
+    }
+}
+
+/** Leave an expression in the accumulator. A right operand other than a variable or an integer is
+ *  computed first into the temporary of the depth, and deeper temporaries are left to its operands.
+ *  @param index The expression
+ *  @param depth The first temporary free to use
+ */
+constexpr void Constexpr_Compiler::generate_value(int32_t index, size_t depth) {
+    const Code node = nodes[index];
+    if (node.kind == CONSTANT) {
+        emit(VM_LOAD_I, node.value);
+        return;
+    }
+    if (node.kind == VARIABLE) {
+        emit(VM_LOAD, node.value);
+        return;
+    }
+    if (node.kind == NEGATE) {
+        generate_value(node.left, depth);
+        emit(VM_MULT_I, -1);
+        return;
+    }
+
+    int32_t opcode = VM_ADD;
+    switch (node.kind) {
+    case ADD: opcode = VM_ADD; break;
+    case SUBTRACT: opcode = VM_SUB; break;
+    case MULTIPLY: opcode = VM_MULT; break;
+    case DIVIDE: opcode = VM_DIV; break;
+    }
+
+    const Code right = nodes[node.right];
+    if (right.kind == CONSTANT) {
+        generate_value(node.left, depth);
+        emit(opcode + 1, right.value); // The _I opcode follows each operator's
+    } else if (right.kind == VARIABLE) {
+        generate_value(node.left, depth);
+        emit(opcode, right.value);
+    } else {
+        generate_value(node.right, depth);
+        emit(VM_STORE, temporary(depth));
+        generate_value(node.left, depth + 1);
+        emit(opcode, temporary(depth));
+    }
+}
+
+#endif // CONSTEXPR_COMPILER_H
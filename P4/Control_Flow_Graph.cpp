@@ -0,0 +1,307 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Control_Flow_Graph.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+using std::pair;
+using std::set;
+
+const size_t Control_Flow_Graph::none = static_cast<size_t>(-1);
+
+// Constructors
+Control_Flow_Graph::Control_Flow_Graph() {}
+
+Control_Flow_Graph::Control_Flow_Graph(const Program& program) { build(program); }
+
+// Getters
+const vector<Control_Flow_Graph::Basic_Block>& Control_Flow_Graph::get_blocks() const { return blocks; }
+
+const vector<Control_Flow_Graph::Loop>& Control_Flow_Graph::get_loops() const { return loops; }
+
+const vector<size_t>& Control_Flow_Graph::get_dominators() const { return idom; }
+
+const vector<size_t>& Control_Flow_Graph::get_reverse_postorder() const { return order; }
+
+size_t Control_Flow_Graph::find_block(const string& label) const {
+    map<string, size_t>::const_iterator found = labels.find(label);
+    return found == labels.end() ? none : found->second;
+}
+
+size_t Control_Flow_Graph::get_block_of(size_t instruction) const { return block_of.at(instruction); }
+
+// Member functions
+
+/** Rebuild the graph for a program.
+ *  @param program The lowered program
+ */
+void Control_Flow_Graph::build(const Program& program) {
+    instructions = program.get_instructions();
+    blocks.clear();
+    loops.clear();
+    idom.clear();
+    order.clear();
+    labels.clear();
+    block_of.clear();
+
+    find_blocks();
+    connect_blocks();
+    compute_order();
+    compute_dominators();
+    find_loops();
+}
+
+// Check if control can reach a block from the first instruction
+bool Control_Flow_Graph::is_reachable(size_t block) const { return idom.at(block) != none; }
+
+// Check if block a dominates block b
+bool Control_Flow_Graph::dominates(size_t a, size_t b) const {
+    if (!is_reachable(a) || !is_reachable(b)) { return false; }
+
+    while (true) {
+        if (a == b) { return true; }
+        if (idom.at(b) == b) { return false; } // Reached the entry
+        b = idom.at(b);
+    }
+}
+
+/** Convert the graph to Graphviz DOT.
+ *  Each block shows its instructions and loop depth; back edges are dashed
+ *  and the dominator tree is drawn in dotted gray without affecting the layout.
+ *  @return: the DOT text
+ */
+string Control_Flow_Graph::to_dot() const {
+    ostringstream dot;
+    dot << "digraph cfg {\n";
+    dot << "    node [shape=box, fontname=\"monospace\"];\n";
+
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const Basic_Block& block = blocks.at(i);
+        dot << "    B" << i << " [label=\"B" << i;
+        if (block.loop_depth > 0) { dot << " (loop depth " << block.loop_depth << ")"; }
+        dot << "\\l";
+        for (size_t j = block.first; j < block.end; ++j) {
+            dot << instructions.at(j).to_string() << "\\l";
+        }
+        dot << "\"";
+        if (!is_reachable(i)) { dot << ", style=dashed"; }
+        else if (block.loop != none && loops.at(block.loop).header == i) { dot << ", style=bold"; }
+        dot << "];\n";
+    }
+
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const vector<size_t>& successors = blocks.at(i).successors;
+        for (size_t j = 0; j < successors.size(); ++j) {
+            dot << "    B" << i << " -> B" << successors.at(j);
+            if (dominates(successors.at(j), i)) { dot << " [style=dashed]"; }
+            dot << ";\n";
+        }
+    }
+
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (is_reachable(i) && idom.at(i) != i) {
+            dot << "    B" << idom.at(i) << " -> B" << i << " [style=dotted, color=gray, constraint=false];\n";
+        }
+    }
+
+    dot << "}\n";
+    return dot.str();
+}
+
+// Split the instructions at labels and after the instructions that do not simply fall through
+void Control_Flow_Graph::find_blocks() {
+    block_of.resize(instructions.size());
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        const Instruction& instruction = instructions.at(i);
+        bool leader = i == 0 || !instruction.label.empty() || instructions.at(i - 1).ends_block();
+
+        if (leader) {
+            Basic_Block block;
+            block.id = blocks.size();
+            block.label = instruction.label;
+            block.first = i;
+            block.end = i;
+            block.loop = none;
+            block.loop_depth = 0;
+            blocks.push_back(block);
+            if (!instruction.label.empty()) { labels[instruction.label] = block.id; }
+        }
+
+        blocks.back().end = i + 1;
+        block_of.at(i) = blocks.size() - 1;
+    }
+}
+
+/** Add the edges of every block: the target of its last instruction if that is a branch,
+ *  and the next block unless the last instruction is BR or STOP. A branch to a label
+ *  no instruction has leads nowhere, and neither does falling off the last instruction.
+ */
+void Control_Flow_Graph::connect_blocks() {
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const Instruction& last = instructions.at(blocks.at(i).end - 1);
+
+        if (last.is_branch()) {
+            size_t target = find_block(last.operand);
+            if (target != none) { add_edge(i, target); }
+        }
+        if (last.opcode != "BR" && last.opcode != "STOP" && i + 1 < blocks.size()) {
+            add_edge(i, i + 1);
+        }
+    }
+}
+
+// Record a control-flow edge once, e.g. a conditional branch to the next block is a single edge
+void Control_Flow_Graph::add_edge(size_t from, size_t to) {
+    vector<size_t>& successors = blocks.at(from).successors;
+    if (std::find(successors.begin(), successors.end(), to) != successors.end()) { return; }
+
+    successors.push_back(to);
+    blocks.at(to).predecessors.push_back(from);
+}
+
+// Order the blocks reachable from the entry by reverse postorder, without recursion
+void Control_Flow_Graph::compute_order() {
+    if (blocks.empty()) { return; }
+
+    vector<bool> visited(blocks.size(), false);
+    vector<size_t> postorder;
+    vector<pair<size_t, size_t> > stack; // Block and index of the next successor to visit
+    stack.push_back(std::make_pair(0, 0));
+    visited.at(0) = true;
+
+    while (!stack.empty()) {
+        size_t block = stack.back().first;
+        const vector<size_t>& successors = blocks.at(block).successors;
+
+        if (stack.back().second < successors.size()) {
+            size_t next = successors.at(stack.back().second++);
+            if (!visited.at(next)) {
+                visited.at(next) = true;
+                stack.push_back(std::make_pair(next, 0));
+            }
+        } else {
+            postorder.push_back(block);
+            stack.pop_back();
+        }
+    }
+
+    order.assign(postorder.rbegin(), postorder.rend());
+}
+
+// Immediate dominator of each reachable block (Cooper, Harvey and Kennedy)
+void Control_Flow_Graph::compute_dominators() {
+    idom.assign(blocks.size(), none);
+    if (order.empty()) { return; }
+
+    vector<size_t> position(blocks.size(), none);
+    for (size_t i = 0; i < order.size(); ++i) { position.at(order.at(i)) = i; }
+    idom.at(order.at(0)) = order.at(0);
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < order.size(); ++i) {
+            size_t block = order.at(i);
+            size_t new_idom = none;
+
+            const vector<size_t>& predecessors = blocks.at(block).predecessors;
+            for (size_t j = 0; j < predecessors.size(); ++j) {
+                size_t other = predecessors.at(j);
+                if (idom.at(other) == none) { continue; } // Not processed yet or unreachable
+
+                if (new_idom == none) {
+                    new_idom = other;
+                    continue;
+                }
+
+                // Walk both blocks up the tree until they meet
+                size_t a = other;
+                size_t b = new_idom;
+                while (a != b) {
+                    while (position.at(a) > position.at(b)) { a = idom.at(a); }
+                    while (position.at(b) > position.at(a)) { b = idom.at(b); }
+                }
+                new_idom = a;
+            }
+
+            if (idom.at(block) != new_idom) {
+                idom.at(block) = new_idom;
+                changed = true;
+            }
+        }
+    }
+}
+
+/** Find the natural loops and how they nest.
+ *  An edge is a back edge when its target dominates its source; the back edges to one header
+ *  form a single loop. A retreating edge to a block that does not dominate it (an irreducible
+ *  loop, which the Generator never emits) forms no loop.
+ */
+void Control_Flow_Graph::find_loops() {
+    map<size_t, set<size_t> > bodies; // Blocks of the loop of each header
+    map<size_t, vector<size_t> > latches; // Back edges of each header
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        size_t latch = order.at(i);
+        const vector<size_t>& successors = blocks.at(latch).successors;
+
+        for (size_t j = 0; j < successors.size(); ++j) {
+            size_t header = successors.at(j);
+            if (!dominates(header, latch)) { continue; }
+
+            latches[header].push_back(latch);
+            set<size_t>& body = bodies[header];
+            body.insert(header);
+
+            // Everything that reaches the latch without passing through the header
+            vector<size_t> work;
+            if (body.insert(latch).second) { work.push_back(latch); }
+            while (!work.empty()) {
+                size_t block = work.back();
+                work.pop_back();
+                const vector<size_t>& predecessors = blocks.at(block).predecessors;
+                for (size_t k = 0; k < predecessors.size(); ++k) {
+                    if (is_reachable(predecessors.at(k)) && body.insert(predecessors.at(k)).second) { work.push_back(predecessors.at(k)); }
+                }
+            }
+        }
+    }
+
+    // Larger loops first, so a loop always comes after every loop holding it
+    vector<pair<size_t, size_t> > by_size; // Minus the size, so that sorting puts the largest first, and the header
+    for (map<size_t, set<size_t> >::const_iterator it = bodies.begin(); it != bodies.end(); ++it) {
+        by_size.push_back(std::make_pair(blocks.size() - it->second.size(), it->first));
+    }
+    std::sort(by_size.begin(), by_size.end());
+
+    for (size_t i = 0; i < by_size.size(); ++i) {
+        size_t header = by_size.at(i).second;
+        Loop loop;
+        loop.header = header;
+        loop.latches = latches[header];
+        loop.blocks.assign(bodies[header].begin(), bodies[header].end());
+        loop.parent = none;
+        loop.depth = 1;
+
+        // The innermost enclosing loop is the last earlier loop holding the header
+        for (size_t j = loops.size(); j-- > 0;) {
+            if (bodies[loops.at(j).header].count(header)) {
+                loop.parent = j;
+                loop.depth = loops.at(j).depth + 1;
+                break;
+            }
+        }
+        loops.push_back(loop);
+
+        // Inner loops come later, so the last loop to claim a block is the innermost
+        for (size_t j = 0; j < loop.blocks.size(); ++j) {
+            blocks.at(loop.blocks.at(j)).loop = loops.size() - 1;
+            blocks.at(loop.blocks.at(j)).loop_depth = loop.depth;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef CONTROL_FLOW_GRAPH_H
+#define CONTROL_FLOW_GRAPH_H
+
+#include "Program.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::string;
+using std::vector;
+
+// The basic blocks of a lowered program with their edges, dominator tree and loop nesting
+class Control_Flow_Graph {
+public:
+    static const size_t none; // No block or no loop
+
+    // A maximal run of instructions entered only at its first and left only at its last
+    struct Basic_Block {
+        size_t id; // Index of the block, block 0 holds the first instruction
+        string label; // Label of the first instruction, empty if none
+        size_t first; // Index of the first instruction
+        size_t end; // Index one past the last instruction
+        vector<size_t> predecessors; // Blocks that branch or fall through here
+        vector<size_t> successors; // Blocks control can go to next, the branch target first
+        size_t loop; // Innermost loop holding the block, none if outside every loop
+        size_t loop_depth; // Number of loops holding the block
+    };
+
+    // A natural loop: the blocks that reach a back edge without passing through its header
+    struct Loop {
+        size_t header; // The block every iteration starts in
+        vector<size_t> latches; // Blocks with a back edge to the header
+        vector<size_t> blocks; // Every block of the loop, header included, in increasing order
+        size_t parent; // Innermost loop holding this one, none if outermost
+        size_t depth; // 1 for an outermost loop
+    };
+
+    // Constructors
+    Control_Flow_Graph();
+    Control_Flow_Graph(const Program&);
+
+    // Getters
+    const vector<Basic_Block>& get_blocks() const;
+    const vector<Loop>& get_loops() const;
+    const vector<size_t>& get_dominators() const; // Immediate dominator of each block
+    const vector<size_t>& get_reverse_postorder() const; // Reachable blocks in reverse postorder
+    size_t find_block(const string&) const; // Block starting at a label, none if no instruction has it
+    size_t get_block_of(size_t) const; // Block holding an instruction
+
+    // Member functions
+    void build(const Program&); // Rebuild the graph for a program
+    bool is_reachable(size_t) const; // Check if control can reach a block from the first instruction
+    bool dominates(size_t, size_t) const; // Check if every path to the second block passes through the first
+    string to_dot() const; // Convert the graph to Graphviz DOT
+
+private:
+    // Data fields
+    vector<Instruction> instructions; // The instructions of the program
+    vector<Basic_Block> blocks; // Blocks in program order
+    vector<Loop> loops; // Loops, outer loops before the loops they hold
+    vector<size_t> idom; // Immediate dominator of each block, the entry is its own, none if unreachable
+    vector<size_t> order; // Reachable blocks in reverse postorder
+    map<string, size_t> labels; // Block starting at each label
+    vector<size_t> block_of; // Block holding each instruction
+
+    // Member functions
+    void find_blocks(); // Split the instructions at labels and after branches
+    void connect_blocks(); // Add the edges of every block
+    void add_edge(size_t, size_t); // Record a control-flow edge once
+    void compute_order(); // Order the reachable blocks by reverse postorder
+    void compute_dominators(); // Compute the immediate dominators
+    void find_loops(); // Find the natural loops and how they nest
+};
+
+#endif // CONTROL_FLOW_GRAPH_H
@@ -0,0 +1,62 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Expression.h"
+
+#include <cctype>
+#include <cstdlib>
+
+// Constructors
+Expression::Expression(const string& value) : kind(EXPRESSION_LEAF), value(value) {}
+
+Expression::Expression(Kind kind, const Expression& operand) : kind(kind) {
+    operands.push_back(operand);
+}
+
+Expression::Expression(Kind kind, const Expression& left, const Expression& right) : kind(kind) {
+    operands.push_back(left);
+    operands.push_back(right);
+}
+
+// Member functions
+
+// Check if the expression is a single operand
+bool Expression::is_leaf() const {
+    return kind == EXPRESSION_LEAF;
+}
+
+// Check if the expression is the given integer
+bool Expression::is_constant(long long constant) const {
+    long long value;
+    return get_constant(value) && value == constant;
+}
+
+/** Get the integer of a literal leaf.
+ *  @param constant Receives the integer
+ *  @return True if the expression is an integer literal, false otherwise
+ */
+bool Expression::get_constant(long long& constant) const {
+    if (kind != EXPRESSION_LEAF || value.empty() || !isdigit(static_cast<unsigned char>(value.at(0)))) { return false; }
+    constant = atoll(value.c_str());
+    return true;
+}
+
+// Check if the operands can be swapped
+bool Expression::is_commutative() const {
+    return kind == EXPRESSION_ADD || kind == EXPRESSION_MUL;
+}
+
+/** Converts the expression to text.
+ *  @return: the expression with every operator parenthesized, e.g. "(x + (y % 2))"
+ */
+string Expression::to_string() const {
+    static const char* symbols[] = { "", "+", "-", "%", "/", "-" };
+
+    if (kind == EXPRESSION_LEAF) { return value; }
+    if (kind == EXPRESSION_NEG) { return "(- " + operands.at(0).to_string() + ")"; }
+
+    ostringstream oss;
+    oss << "(" << operands.at(0).to_string() << " " << symbols[kind] << " " << operands.at(1).to_string() << ")";
+    return oss.str();
+}
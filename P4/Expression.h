@@ -0,0 +1,44 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+
+using std::string;
+using std::vector;
+using std::ostringstream;
+
+// An arithmetic expression, grouped the way the parse tree groups it
+struct Expression {
+    enum Kind {
+        EXPRESSION_LEAF, // An identifier, a non-negative integer or a temporary
+        EXPRESSION_ADD, // operands[0] + operands[1]
+        EXPRESSION_SUB, // operands[0] - operands[1]
+        EXPRESSION_MUL, // operands[0] % operands[1]
+        EXPRESSION_DIV, // operands[0] / operands[1]
+        EXPRESSION_NEG // - operands[0]
+    };
+
+    Kind kind;
+    string value; // The operand of a leaf
+    vector<Expression> operands; // The subexpressions of an operator
+
+    // Constructors
+    Expression(const string& = "0"); // A leaf
+    Expression(Kind, const Expression&); // A unary operator
+    Expression(Kind, const Expression&, const Expression&); // A binary operator
+
+    // Member functions
+    bool is_leaf() const; // Check if the expression is a single operand
+    bool is_constant(long long) const; // Check if the expression is the given integer
+    bool get_constant(long long&) const; // Get the integer of a literal leaf
+    bool is_commutative() const; // Check if the operands can be swapped
+    string to_string() const; // Convert the expression to fully parenthesized text
+};
+
+#endif // EXPRESSION_H
@@ -3,17 +3,50 @@
 // Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2024-12-11
 
 #include "Generator.h"
+#include "Utility.h"
+
+#include <algorithm>
 
 // Constructor
-Generator::Generator(const Tree& parse_tree) : tree(parse_tree), label_count(0), temp_count(0) {}
+Generator::Generator(const Tree& parse_tree) : tree(parse_tree), current_line(0), label_count(0), temp_count(0), unroll_factor(4), unroll_budget(128), max_trip_count(100000),
+    simplify_expressions(true), hoist_loop_invariants(true), unroll_loops(true), instrument(false), inline_functions(true), inline_budget(32) {}
+
+// Getters
+string Generator::get_code() const { return program.to_string(); }
+Program Generator::get_program() const { return program; }
+const map<string, size_t>& Generator::get_rule_counts() const { return rewriter.get_rule_counts(); }
+
+// Setters
+void Generator::set_unroll_factor(size_t factor) { unroll_factor = factor; }
+void Generator::set_unroll_budget(size_t budget) { unroll_budget = budget; }
+void Generator::set_simplify_expressions(bool enabled) { simplify_expressions = enabled; }
+void Generator::set_hoist_invariants(bool enabled) { hoist_loop_invariants = enabled; }
+void Generator::set_unroll_loops(bool enabled) { unroll_loops = enabled; }
+void Generator::set_instrumentation(bool enabled) { instrument = enabled; }
+void Generator::set_profile(const vector<long long>& values) { profile = values; }
+void Generator::set_inline_functions(bool enabled) { inline_functions = enabled; }
+void Generator::set_inline_budget(size_t budget) { inline_budget = budget; }
 
-// Getter
-string Generator::get_code() const { return code.str(); }
+// Member functions
 
-// Setter
-void Generator::set_code(const string& new_code) { code.str(new_code); }
+/** Append an instruction to the program, attaching the pending label if there is one.
+ *  @param opcode The instruction name
+ *  @param operand The operand, if any
+ */
+void Generator::emit(const string& opcode, const string& operand) {
+    Instruction instruction(opcode, operand, pending_label);
+    instruction.line = current_line;
+    program.add_instruction(instruction);
+    pending_label.clear();
+}
 
-// Member functions
+// Attach a label to the next emitted instruction
+void Generator::emit_label(const string& label) {
+    if (!pending_label.empty()) {
+        emit("NOOP"); // Two labels in a row need an instruction in between
+    }
+    pending_label = label;
+}
 
 // Create a unique label
 string Generator::create_label() {
@@ -24,18 +57,16 @@ string Generator::create_label() {
 
 // Create a unique temporary variable
 string Generator::create_temp() {
-    ostringstream temp;
-    temp << "T" << temp_count++;
-    string temp_str = temp.str();
-    allocate_storage(temp_str);  // Track the temporary variable
-    
-    return temp.str();
+    string temp = generated_name('T', temp_count++);
+    allocate_storage(temp);  // Track the temporary variable
+
+    return temp;
 }
 
 // Track the storage of a variable
 void Generator::allocate_storage(const string& variable_name) {
-    // Track declared variable
-    if (!variable_name.empty()) {
+    // Track declared variable once, even if an inner block declares it again
+    if (!variable_name.empty() && std::find(declared_variables.begin(), declared_variables.end(), variable_name) == declared_variables.end()) {
         declared_variables.push_back(variable_name);
     }
 }
@@ -56,11 +87,9 @@ void Generator::traverse(const Node& node) {
     else if (data == "<assign>") { handle_assign(node); }
     else if (data == "<cond>") { handle_cond(node); }
     else if (data == "<iter>") { handle_iter(node); }
-    else if (data == "<relational>") { handle_relational(node); }
-    else if (data == "<exp>") { handle_exp(node); }
-    else if (data == "<M>") { handle_m(node); }
-    else if (data == "<N>") { handle_n(node); }
-    else if (data == "<R>") { handle_r(node); }
+    else if (data == "<call>") { handle_call(node); }
+    else if (data == "<funcs>") { return; } // Funcs are emitted where they are called, or after STOP
+    else if (data == "<exp>" || data == "<M>" || data == "<N>" || data == "<R>") { handle_expression(node); }
     else {
         const vector<Node>& children = node.get_children();
         for (size_t i = 0; i < children.size(); ++i) {
@@ -71,12 +100,32 @@ void Generator::traverse(const Node& node) {
 
 // Generate the code
 void Generator::generate() {
-        traverse(tree.get_root());
-        code << "STOP\n";
+        // The sites are numbered on the same copy of the tree that is traversed
+        Node root = tree.get_root();
+        number_sites(root);
+        if (!profile.empty()) { use_profile(); }
+
+        traverse(root);
+
+        if (instrument) {
+            // The number of sites, then the two counters of each site, follow the output of the program
+            string count = create_temp();
+            emit("LOAD", to_string(site_ids.size()));
+            emit("STORE", count);
+            emit("WRITE", count);
+            for (size_t i = 0; i < 2 * site_ids.size(); ++i) {
+                string counter = generated_name('P', i);
+                allocate_storage(counter);
+                emit("WRITE", counter);
+            }
+        }
+        emit("STOP");
+        emit_cold_blocks();
+        emit_functions();
 
         // Add storage for global variables
         for (size_t i = 0; i < declared_variables.size(); ++i) {
-            code << declared_variables.at(i) << " 0\n";
+            program.add_storage(declared_variables.at(i));
         }
 
 }
@@ -85,7 +134,8 @@ void Generator::generate() {
 void Generator::handle_program(const Node& node) {
     const vector<Node>& children = node.get_children();
     if (children.size() > 1) { traverse(children.at(1));} // Traverse <vars>
-    if (children.size() > 2) { traverse(children.at(2));} // Traverse <block> 
+    if (children.size() > 3) { prepare_functions(node);} // Decide how to call each func
+    if (children.size() > 2) { traverse(children.back());} // Traverse <block> 
 }
 
 // Handle the <vars> node
@@ -123,19 +173,17 @@ void Generator::handle_print(const Node& node) {
    const vector<Node>& children = node.get_children();
 
     if (!children.empty()) {
-        const Node& exp_node = children.at(1);
-        
-        // Traverse to evaluate the expression node
-        traverse(exp_node);
-        const string& value = get_terminal_value(exp_node);
-
-        // Check if the value is an identifier or a literal
-        if (!value.empty() && isalpha(value.at(0))) {
-            code << "WRITE " << value << "\n"; // Write the value of the variable
+        Expression expression = get_expression(children.at(1));
+
+        // Check if the expression is a single identifier
+        if (expression.is_leaf() && isalpha(expression.value.at(0))) {
+            emit("WRITE", expression.value); // Write the value of the variable
         } else {
+            // Evaluate the expression
+            emit_expression(expression);
             string temp = create_temp();  // Create a temporary variable
-            code << "STORE " << temp << "\n";  // Store the literal value in the temporary
-            code << "WRITE " << temp << "\n";  // Write the value from the temporary
+            emit("STORE", temp);  // Store the value of the expression in the temporary
+            emit("WRITE", temp);  // Write the value from the temporary
         }
     }
 }
@@ -152,6 +200,10 @@ void Generator::handle_stat(const Node& node) {
 
     const string& child_label = children.at(0).get_data();
 
+    // The instructions of the statement map to its line, and those after a nested statement to the enclosing one
+    size_t enclosing_line = current_line;
+    current_line = node.get_line_number();
+
     // Determine which type of <stat> to process based on the child node's label
     if (child_label == "<read>") {
         handle_read(children.at(0));
@@ -165,9 +217,12 @@ void Generator::handle_stat(const Node& node) {
         handle_iter(children.at(0));
     } else if (child_label == "<assign>") {
         handle_assign(children.at(0));
+    } else if (child_label == "<call>") {
+        handle_call(children.at(0));
     } else {
         cerr << "Error: Unknown statement type in <stat> node: " << child_label << endl;
     }
+    current_line = enclosing_line;
 }
 
 // Handle the <stats> node
@@ -200,10 +255,9 @@ void Generator::handle_m_stat(const Node& node) {
 // Handle the <vars> node
 void Generator::handle_vars(const Node& node) {
     const vector<Node>& children = node.get_children();
+    // A block without variables is not worth a message: standard output belongs to the program under -fjit
     if (children.size() > 1 && children.at(0).get_data() == "var") {
         traverse(children.at(1));  // Traverse <varList>
-    } else {
-        cout << "No variables to declare\n";
     }
 }
 
@@ -211,344 +265,755 @@ void Generator::handle_vars(const Node& node) {
 void Generator::handle_iter(const Node& node) {
     const vector<Node>& children = node.get_children();
 
+    if (instrument) { emit_counter(2 * site_ids[&node]); }
+
+    // Invariant expressions are only valid for the duration of this loop
+    map<string, string> outer_invariants = invariant_temps;
+
+    // Find the variables the body writes
+    set<string> writes;
+    collect_writes(children.at(6), writes);
+
+    // Loops with a trip count known at compile time are unrolled
+    string counter;
+    long long final_value = 0;
+    bool unrolled = unroll_loops && unroll_loop(node, writes, counter, final_value);
+
+    // Values known before the loop do not survive its body
+    forget_values(writes);
+
+    if (unrolled) {
+        known_values[counter] = final_value;
+    } else if (is_cold(node)) {
+        // The profile shows the loop is never entered, so the whole loop goes out of line
+        move_out_of_line(node, writes);
+    } else {
+        handle_loop(node, writes);
+    }
+
+    invariant_temps = outer_invariants;
+}
+
+/** Emit an <iter> loop rotated into a guarded do-while with a loop-invariant preheader.
+ *  @param node The <iter> node
+ *  @param writes The variables written by the loop body
+ */
+void Generator::handle_loop(const Node& node, const set<string>& writes) {
+    const vector<Node>& children = node.get_children();
+
     // Generate labels for the loop
     string loop_start = create_label();
     string loop_end = create_label();
 
+    // Hoist the condition operands that do not depend on the body
+    vector<Node> invariants;
+    if (hoist_loop_invariants) {
+        collect_invariants(children.at(2), writes, true, invariants);
+        collect_invariants(children.at(4), writes, true, invariants);
+        hoist_invariants(invariants);
+    }
+
+    // The loop is rotated into a guarded do-while: the condition is tested once on entry
+    // and again after the body, so each iteration only pays for the conditional back-edge
+    handle_relational(children.at(2), children.at(3), children.at(4), loop_end, false);
+
+    // The preheader for the body runs only when the loop is entered
+    if (hoist_loop_invariants) {
+        bool seen_io = false;
+        collect_body_invariants(children.at(6), writes, true, seen_io, invariants);
+        hoist_invariants(invariants);
+    }
+
     // Start of the loop
-    code << loop_start << ": ";
+    emit_label(loop_start);
 
-    // Evaluate the left-hand <exp> 
-    traverse(children.at(2));
-    string left_temp = create_temp();
-    code << "STORE " << left_temp << "\n";
+    // Traverse the <stat>
+    emit_body(node);
 
-    // Evaluate the right-hand <exp>
-    traverse(children.at(4));
-    string right_temp = create_temp();
-    code << "STORE " << right_temp << "\n";
+    // Jump back to the start of the loop while the condition holds
+    handle_relational(children.at(2), children.at(3), children.at(4), loop_start, true);
 
-    // Generate code for the condition (left - right)
-    code << "LOAD " << left_temp << "\n";
-    code << "SUB " << right_temp << "\n";
+    // Add the end of the loop
+    emit_label(loop_end);
+    emit("NOOP");
+}
 
-    // Handle the relational operator
-    const Node& relational_node = children.at(3);
+/** Unroll an <iter> loop whose trip count is known at compile time.
+ *  The loop must compare a counter with a literal, the counter must hold a known value on entry,
+ *  and the body must update it exactly once, unconditionally, by a constant step.
+ *  The loop is unrolled fully when it fits the size budget, otherwise by the unroll factor
+ *  with the remaining iterations peeled in front.
+ *  @param node The <iter> node
+ *  @param writes The variables written by the loop body
+ *  @param counter Receives the loop counter
+ *  @param final_value Receives the value of the counter after the loop
+ *  @return True if the loop was unrolled, false otherwise
+ */
+bool Generator::unroll_loop(const Node& node, const set<string>& writes, string& counter, long long& final_value) {
+    const vector<Node>& children = node.get_children();
+    string left;
+    string right;
+    string rel_op = get_relational_operator(children.at(3));
+
+    if (!get_leaf_value(children.at(2), left) || !get_leaf_value(children.at(4), right)) { return false; }
+
+    // Normalize the condition to: counter <rel_op> bound
+    long long bound = 0;
+    if (isalpha(left.at(0)) && isdigit(right.at(0))) {
+        counter = left;
+        bound = atoll(right.c_str());
+    } else if (isdigit(left.at(0)) && isalpha(right.at(0))) {
+        counter = right;
+        bound = atoll(left.c_str());
+        rel_op = swap_relational_operator(rel_op);
+    } else {
+        return false;
+    }
 
-    if (relational_node.get_children().empty()) {
-        handle_relational(relational_node);  // Directly process if not nested
+    map<string, long long>::const_iterator known = known_values.find(counter);
+    long long step = 0;
+    if (known == known_values.end() || !get_counter_step(children.at(6), counter, step) || step == 0) { return false; }
+
+    // Count the iterations, giving up on anything that would leave the range of a machine word
+    const long long word_limit = 2147483647LL;
+    long long value = known->second;
+    size_t trip_count = 0;
+    while (evaluate_relation(rel_op, value - bound)) {
+        value += step;
+        if (++trip_count > max_trip_count || value > word_limit || value < -word_limit) { return false; }
+    }
+
+    // Measure the body and check the unrolled size against the budget
+    size_t body_size = measure_code(children.at(6));
+    size_t factor = unroll_factor;
+    if (trip_count * body_size <= unroll_budget) {
+        factor = trip_count;  // Unroll fully
+    } else if (factor < 2 || trip_count < factor || (2 * factor - 1) * body_size > unroll_budget) {
+        return false;
+    }
+
+    // Peel the iterations that do not fill a whole unrolled body
+    size_t remainder = (factor == 0) ? 0 : trip_count % factor;
+    for (size_t i = 0; i < remainder; ++i) {
+        emit_body(node);
+    }
+
+    if (factor > 0 && trip_count >= factor) {
+        if (factor == trip_count) {
+            // Straight-line copies, no tests at all
+            for (size_t i = 0; i < factor; ++i) {
+                emit_body(node);
+            }
+        } else {
+            // The trip count is a multiple of the factor from here on, so the test only runs after each group
+            if (hoist_loop_invariants) {
+                vector<Node> invariants;
+                bool seen_io = false;
+                collect_body_invariants(children.at(6), writes, true, seen_io, invariants);
+                hoist_invariants(invariants);
+            }
+
+            string loop_start = create_label();
+            emit_label(loop_start);
+            for (size_t i = 0; i < factor; ++i) {
+                emit_body(node);
+            }
+            handle_relational(children.at(2), children.at(3), children.at(4), loop_start, true);
+        }
+    }
+
+    final_value = value;
+    return true;
+}
+
+/** Find the constant step of a loop counter.
+ *  The body must contain exactly one write to the counter, outside any nested <cond> or <iter>,
+ *  of the form: set counter counter + integer ; | set counter integer + counter ; | set counter counter - integer ;
+ *  @param body The loop body
+ *  @param counter The loop counter
+ *  @param step Receives the step
+ *  @return True if the step was found, false otherwise
+ */
+bool Generator::get_counter_step(const Node& body, const string& counter, long long& step) {
+    vector<Node> updates;
+    size_t write_count = 0;
+    find_counter_updates(body, counter, true, updates, write_count);
+    if (write_count != 1 || updates.size() != 1) { return false; }
+
+    const vector<Node>& exp = updates.at(0).get_children().at(2).get_children();
+    if (exp.size() != 3) { return false; }
+
+    string left;
+    string right;
+    if (!get_leaf_value(exp.at(0), left) || !get_leaf_value(exp.at(2), right)) { return false; }
+
+    const string& op = exp.at(1).get_data();
+    if (left == counter && isdigit(right.at(0))) {
+        step = atoll(right.c_str());
+        if (op == "-") { step = -step; }
+        return op == "+" || op == "-";
+    }
+    if (right == counter && isdigit(left.at(0)) && op == "+") {
+        step = atoll(left.c_str());
+        return true;
+    }
+    return false;
+}
+
+/** Find the statements that write a loop counter.
+ *  @param node The node to search
+ *  @param counter The loop counter
+ *  @param unconditional True if the node runs on every iteration
+ *  @param updates Receives the unconditional <assign> statements to the counter
+ *  @param write_count Counts every write to the counter
+ */
+void Generator::find_counter_updates(const Node& node, const string& counter, bool unconditional, vector<Node>& updates, size_t& write_count) {
+    const vector<Node>& children = node.get_children();
+    const string& data = node.get_data();
+
+    if ((data == "<assign>" || data == "<read>") && children.size() > 1) {
+        if (children.at(1).get_data() == counter) {
+            ++write_count;
+            if (data == "<assign>" && unconditional) { updates.push_back(node); }
+        }
+        return;
+    }
+
+    if (data == "<cond>" || data == "<iter>") { unconditional = false; }
+    if (data == "<call>") {
+        find_counter_updates(*functions[children.at(1).get_data()].body, counter, unconditional, updates, write_count);
+        return;
+    }
+
+    for (size_t i = 0; i < children.size(); ++i) {
+        find_counter_updates(children.at(i), counter, unconditional, updates, write_count);
+    }
+}
+
+/** Count the instructions generated for a node without emitting them.
+ *  @param node The node to measure
+ *  @return The number of instructions
+ */
+size_t Generator::measure_code(const Node& node) {
+    // Save the generator state
+    size_t saved_size = program.get_instructions().size();
+    string saved_label = pending_label;
+    size_t saved_labels = label_count;
+    size_t saved_temps = temp_count;
+    size_t saved_variables = declared_variables.size();
+    map<string, string> saved_invariants = invariant_temps;
+    map<string, long long> saved_values = known_values;
+    size_t saved_blocks = cold_blocks.size();
+    map<string, Function> saved_functions = functions;
+
+    traverse(node);
+    size_t count = program.get_instructions().size() - saved_size;
+
+    // Restore the generator state
+    program.get_instructions().resize(saved_size);
+    pending_label = saved_label;
+    label_count = saved_labels;
+    temp_count = saved_temps;
+    declared_variables.resize(saved_variables);
+    invariant_temps = saved_invariants;
+    known_values = saved_values;
+    cold_blocks.resize(saved_blocks);
+    functions = saved_functions;
+
+    return count;
+}
+
+// Forget the known values of the given variables
+void Generator::forget_values(const set<string>& variables) {
+    for (set<string>::const_iterator it = variables.begin(); it != variables.end(); ++it) {
+        known_values.erase(*it);
+    }
+}
+
+// Swap the operands of a relational operator
+string Generator::swap_relational_operator(const string& rel_op) {
+    if (rel_op == ".ge.") { return ".le."; }
+    if (rel_op == ".le.") { return ".ge."; }
+    if (rel_op == ".gt.") { return ".lt."; }
+    if (rel_op == ".lt.") { return ".gt."; }
+    return rel_op; // ** and ~ are symmetric
+}
+
+// Evaluate a relational operator given (left - right)
+bool Generator::evaluate_relation(const string& rel_op, long long difference) {
+    if (rel_op == ".ge.") { return difference >= 0; }
+    if (rel_op == ".le.") { return difference <= 0; }
+    if (rel_op == ".gt.") { return difference > 0; }
+    if (rel_op == ".lt.") { return difference < 0; }
+    if (rel_op == "**") { return difference == 0; }
+    return difference != 0;
+}
+
+/** Collect the variables written by <assign> and <read> statements under a node.
+ *  @param node The node to search
+ *  @param writes Receives the written variables
+ */
+void Generator::collect_writes(const Node& node, set<string>& writes) {
+    const vector<Node>& children = node.get_children();
+    const string& data = node.get_data();
+
+    if ((data == "<assign>" || data == "<read>") && children.size() > 1) {
+        writes.insert(children.at(1).get_data());
+        return;
+    }
+    if (data == "<call>") {
+        // Funcs cannot recurse, so the search ends
+        collect_writes(*functions[children.at(1).get_data()].body, writes);
+        return;
+    }
+
+    for (size_t i = 0; i < children.size(); ++i) {
+        collect_writes(children.at(i), writes);
+    }
+}
+
+/** Collect the largest non-leaf subexpressions that read none of the written variables.
+ *  @param node The expression node to search
+ *  @param writes The variables written inside the loop
+ *  @param allow_division False to skip subexpressions that divide, since hoisting them may trap
+ *  @param invariants Receives the invariant subexpressions
+ */
+void Generator::collect_invariants(const Node& node, const set<string>& writes, bool allow_division, vector<Node>& invariants) {
+    const vector<Node>& children = node.get_children();
+    if (children.empty()) { return; }
+
+    string value;
+    if (!get_leaf_value(node, value) && is_invariant(node, writes) && (allow_division || !contains_division(node))) {
+        invariants.push_back(node);
+        return;
+    }
+
+    for (size_t i = 0; i < children.size(); ++i) {
+        collect_invariants(children.at(i), writes, allow_division, invariants);
+    }
+}
+
+/** Collect the invariant subexpressions of the statements in a loop body. A division is only
+ *  hoisted from a statement that runs on every iteration before any input or output, so that
+ *  one that traps still fails after the output the loop would have produced.
+ *  @param node The statement node to search
+ *  @param writes The variables written inside the loop
+ *  @param unconditional True if the statement runs on every iteration
+ *  @param seen_io Set once a statement that may read or print has been passed
+ *  @param invariants Receives the invariant subexpressions
+ */
+void Generator::collect_body_invariants(const Node& node, const set<string>& writes, bool unconditional, bool& seen_io, vector<Node>& invariants) {
+    const vector<Node>& children = node.get_children();
+    const string& data = node.get_data();
+    bool allow_division = unconditional && !seen_io;
+
+    if (data == "<assign>") {
+        collect_invariants(children.at(2), writes, allow_division, invariants);
+    } else if (data == "<print>") {
+        collect_invariants(children.at(1), writes, allow_division, invariants);
+        seen_io = true;
+    } else if (data == "<read>" || data == "<call>") {
+        seen_io = true; // A function body may read or print
+    } else if (data == "<cond>" || data == "<iter>") {
+        collect_invariants(children.at(2), writes, allow_division, invariants);
+        collect_invariants(children.at(4), writes, allow_division, invariants);
+        collect_body_invariants(children.at(6), writes, false, seen_io, invariants);
     } else {
-        const string& rel_op = relational_node.get_children().at(0).get_data();
-        handle_relational(relational_node.get_children().at(0));
+        for (size_t i = 0; i < children.size(); ++i) {
+            collect_body_invariants(children.at(i), writes, unconditional, seen_io, invariants);
+        }
     }
+}
 
-    code << loop_end << "\n";
+/** Evaluate invariant expressions once and keep each result in a dedicated temporary.
+ *  @param invariants The expressions to hoist
+ */
+void Generator::hoist_invariants(const vector<Node>& invariants) {
+    for (size_t i = 0; i < invariants.size(); ++i) {
+        string key = get_expression_key(invariants.at(i));
+        if (invariant_temps.find(key) != invariant_temps.end()) { continue; } // Already available
 
-    // Traverse the <stat>
-    traverse(children.at(6));
+        traverse(invariants.at(i));
+        string temp = create_temp();
+        emit("STORE", temp);
+        invariant_temps[key] = temp;
+    }
+}
 
-    // Jump back to the start of the loop
-    code << "BR " << loop_start << "\n";
+/** Check whether an expression reads none of the given variables.
+ *  @param node The expression node to check
+ *  @param writes The variables written inside the loop
+ *  @return True if the expression is invariant, false otherwise
+ */
+bool Generator::is_invariant(const Node& node, const set<string>& writes) {
+    const vector<Node>& children = node.get_children();
+    if (children.empty()) {
+        return writes.find(node.get_data()) == writes.end();
+    }
 
-    // Add the end of the loop
-    code << loop_end << ": NOOP\n";
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (!is_invariant(children.at(i), writes)) { return false; }
+    }
+    return true;
+}
+
+// Check whether an expression contains a division
+bool Generator::contains_division(const Node& node) {
+    const vector<Node>& children = node.get_children();
+    if (children.empty()) { return node.get_data() == "/"; }
+
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (contains_division(children.at(i))) { return true; }
+    }
+    return false;
+}
+
+// Get the tokens of an expression as a single string
+string Generator::get_expression_key(const Node& node) {
+    const vector<Node>& children = node.get_children();
+    if (children.empty()) { return node.get_data(); }
+
+    string key;
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (i > 0) { key += " "; }
+        key += get_expression_key(children.at(i));
+    }
+    return key;
 }
 
 // Handle the <read> node
 void Generator::handle_read(const Node& node) {
     const string& var_name = node.get_children().at(1).get_data();
-    code << "READ " << var_name << "\n"; 
+    emit("READ", var_name); 
+    known_values.erase(var_name);
 }
 
 // Handle the <cond> node
 void Generator::handle_cond(const Node& node) {
     const vector<Node>& children = node.get_children();
 
-    // Traverse and evaluate the expressions
-    traverse(children.at(2));  // Left-hand <exp>
-    string left = create_temp();
-    code << "STORE " << left << "\n";
+    if (instrument) { emit_counter(2 * site_ids[&node]); }
 
-    traverse(children.at(4));  // Right-hand <exp>
-    string right = create_temp();
-    code << "STORE " << right << "\n";
+    set<string> writes;
+    collect_writes(children.at(6), writes);
 
-    code << "LOAD " << left << "\n";
-    code << "SUB " << right << "\n";
+    if (is_cold(node)) {
+        // The profile shows the statement rarely runs, so the skip falls through
+        move_out_of_line(node, writes);
+    } else {
+        // Generate labels for branching
+        string label = create_label();
 
-    // Generate labels for branching
-    string label = create_label();
+        // Skip the statement when the condition is false
+        handle_relational(children.at(2), children.at(3), children.at(4), label, false);
 
-    // Handle the relational operator
-    const Node& relational_node = children.at(3);
-    
+        // Process the statement inside the condition
+        emit_body(node); // Traverse the <stat>
 
-    if (relational_node.get_children().empty()) {
-        handle_relational(relational_node);  // Directly process if not nested
-    } else {
-        const string& rel_op = relational_node.get_children().at(0).get_data();
-    
-        handle_relational(relational_node.get_children().at(0));
+        // Add label to the code
+        emit_label(label);
+        emit("NOOP");
     }
 
-    code << label << "\n";
+    // The statement may not have run, so its writes are no longer known
+    forget_values(writes);
+}
 
-    // Process the statement inside the condition
-    traverse(children.at(6)); // Traverse the <stat>
+/** Evaluate <exp> <relational> <exp> and branch on the outcome.
+ *  Both sides are simplified first, so that the accumulator ends up holding
+ *  (left - right) with as few instructions as possible.
+ *  @param left The left-hand <exp>
+ *  @param relational The <relational> node
+ *  @param right The right-hand <exp>
+ *  @param target The label to branch to
+ *  @param branch_on_true True to branch when the relation holds, false to branch when it fails
+ */
+void Generator::handle_relational(const Node& left, const Node& relational, const Node& right, const string& target, bool branch_on_true) {
+    Expression left_expression = get_expression(left);
+    Expression right_expression = get_expression(right);
+
+    if (right_expression.is_constant(0)) {
+        // Comparing against zero: the left value itself decides the branch
+        emit_expression(left_expression);
+    } else {
+        // The accumulator ends up holding (left - right), with a temporary only if the right is not a leaf
+        emit_expression(Expression(Expression::EXPRESSION_SUB, left_expression, right_expression));
+    }
 
-    // Add label to the code
-    code << label << ": NOOP\n";
+    emit_branch(get_relational_operator(relational), target, branch_on_true);
 }
 
-// Handle the <relational> node
-void Generator::handle_relational(const Node& node) {
-
-    const string& rel_op = node.get_data();  // Get the relational operator
+/** Emit the branch sequence for a relational operator, assuming the accumulator holds (left - right).
+ *  @param rel_op The relational operator
+ *  @param target The label to branch to
+ *  @param branch_on_true True to branch when the relation holds, false to branch when it fails
+ */
+void Generator::emit_branch(const string& rel_op, const string& target, bool branch_on_true) {
     if (rel_op == ".ge.") {
-        code << "BRNEG ";
+        emit(branch_on_true ? "BRZPOS" : "BRNEG", target);
     } else if (rel_op == ".le.") {
-        code << "BRPOS ";
+        emit(branch_on_true ? "BRZNEG" : "BRPOS", target);
     } else if (rel_op == ".gt.") {
-        code << "BRZNEG ";
+        emit(branch_on_true ? "BRPOS" : "BRZNEG", target);
     } else if (rel_op == ".lt.") {
-        code << "BRZPOS ";
+        emit(branch_on_true ? "BRNEG" : "BRZPOS", target);
     } else if (rel_op == "**") {
-        code << "BRZERO ";  // Branch if equal
+        // Equal
+        if (branch_on_true) {
+            emit("BRZERO", target);
+        } else {
+            emit("BRNEG", target);
+            emit("BRPOS", target);
+        }
     } else if (rel_op == "~") {
-        // Emulate "branch if not equal" using BRZERO and BR
-        string false_label = create_label();  // Create a label for the false branch
-        code << "BRZERO " << false_label << "\n";  // Skip if equal
-        code << "BR ";                             // Unconditional branch (to true branch)
-        code << false_label << ": NOOP\n";         // Define the false label
+        // Not equal
+        if (branch_on_true) {
+            emit("BRNEG", target);
+            emit("BRPOS", target);
+        } else {
+            emit("BRZERO", target);
+        }
+    } else {
+        cerr << "Error: Unknown relational operator: " << rel_op << endl;
     }
 }
 
-// Handle the <exp> node
-void Generator::handle_exp(const Node& node) {
+// Get the operator of a <relational> node
+string Generator::get_relational_operator(const Node& node) {
+    const vector<Node>& children = node.get_children();
+    if (children.empty()) {
+        return node.get_data(); // The operator itself
+    }
+    return children.at(0).get_data();
+}
+
+/** Check whether an <exp> reduces to a single identifier or integer.
+ *  @param node The node to check
+ *  @param value Receives the identifier or integer when the node is a leaf
+ *  @return True if the node is a leaf, false otherwise
+ */
+bool Generator::get_leaf_value(const Node& node, string& value) {
     const vector<Node>& children = node.get_children();
 
-    // Ensure there are children before proceeding
+    // A terminal node
     if (children.empty()) {
-        cerr << "Error: <exp> node has no children!" << endl;
-        return;
+        const string& data = node.get_data();
+        if (data.empty() || data.at(0) == '<') { return false; }
+        value = data;
+        return true;
     }
 
-    if (children.size() > 3) {
-        // Process complex expressions with more than three children
-        const string& op = children.at(1).get_data();
+    // A single-child chain: <exp> -> <M> -> <N> -> <R> -> terminal
+    if (children.size() == 1) {
+        return get_leaf_value(children.at(0), value);
+    }
 
-        if (op == "+" || op == "-") {
-            // Create a sub-expression node for the right-hand side
-            Node sub_exp;
-            sub_exp.set_data("<exp>");
-            for (size_t i = 2; i < children.size(); i++) {
-                sub_exp.add_child(children.at(i));
-            }
+    // A parenthesized expression: ( <exp> )
+    if (children.size() == 3 && children.at(0).get_data() == "(" && children.at(2).get_data() == ")") {
+        return get_leaf_value(children.at(1), value);
+    }
 
-            handle_exp(sub_exp); // Process the sub-expression
+    return false;
+}
 
-            // Store the result of the sub-expression in a temporary
-            string right_temp = create_temp();
-            code << "STORE " << right_temp << "\n";
+// Handle an <exp>, <M>, <N> or <R> node: simplify it and leave its value in the accumulator
+void Generator::handle_expression(const Node& node) {
+    emit_expression(get_expression(node));
+}
 
-            // Process the left-hand side
-            handle_m(children.at(0));
+// Build the expression tree of a node and simplify it
+Expression Generator::get_expression(const Node& node) {
+    const string& data = node.get_data();
+    Expression expression;
 
-            // Generate the operation
-            if (op == "+") {
-                code << "ADD " << right_temp << "\n";
-            } else if (op == "-") {
-                code << "SUB " << right_temp << "\n";
-            }
-        } else {
-            // Treat the entire node as an expression
-            for (size_t i = 0; i < children.size(); i++) {
-                handle_m(children.at(i));
-                if (i < children.size() - 1) {
-                    const string& sub_op = children[i + 1].get_data();
-                    string temp = create_temp();
-                    code << "STORE " << temp << "\n";
-                    if (sub_op == "%") {
-                        code << "MULT " << temp << "\n";
-                    } else if (sub_op == "/") {
-                        code << "DIV " << temp << "\n";
-                    }
-                }
-            }
-        }
-    } else if (children.size() == 3) {
-        // Process binary operations
-        handle_m(children.at(2)); // Right-hand operand
-        string right_temp = create_temp();
-        code << "STORE " << right_temp << "\n";
+    if (data == "<exp>") { expression = build_exp(node); }
+    else if (data == "<M>") { expression = build_m(node); }
+    else if (data == "<N>") { expression = build_n(node); }
+    else { expression = build_r(node); }
+
+    if (simplify_expressions) { rewriter.simplify(expression); }
+    return expression;
+}
 
-        handle_m(children.at(0)); // Left-hand operand
+/** Emit the code that leaves the value of an expression in the accumulator.
+ *  A leaf right operand is used directly, and so is a leaf left operand of a commutative
+ *  operator; otherwise the right operand is computed first and kept in a temporary.
+ *  Rewriter::get_cost must follow the same shapes.
+ *  @param expression The expression
+ */
+void Generator::emit_expression(const Expression& expression) {
+    static const char* opcodes[] = { "LOAD", "ADD", "SUB", "MULT", "DIV" };
+    const vector<Expression>& operands = expression.operands;
+
+    if (expression.is_leaf()) {
+        emit("LOAD", expression.value);
+        return;
+    }
 
-        const string& operator_token = children.at(1).get_data();
-        if (operator_token == "+") {
-            code << "ADD " << right_temp << "\n";
-        } else if (operator_token == "-") {
-            code << "SUB " << right_temp << "\n";
+    if (expression.kind == Expression::EXPRESSION_NEG) {
+        // Negate by subtracting from zero
+        string operand = operands.at(0).value;
+        if (!operands.at(0).is_leaf()) {
+            emit_expression(operands.at(0));
+            operand = create_temp();
+            emit("STORE", operand);
         }
-    } else if (children.size() == 1) {
-        // Process a single operand
-        handle_m(children.at(0));
+        emit("LOAD", "0");
+        emit("SUB", operand);
+        return;
+    }
+
+    const string opcode = opcodes[expression.kind];
+    if (operands.at(1).is_leaf()) {
+        emit_expression(operands.at(0));
+        emit(opcode, operands.at(1).value);
+    } else if (operands.at(0).is_leaf() && expression.is_commutative()) {
+        emit_expression(operands.at(1));
+        emit(opcode, operands.at(0).value);
     } else {
-        cerr << "Error: Invalid <exp> node structure.\n";
+        emit_expression(operands.at(1));
+        string right_temp = create_temp();
+        emit("STORE", right_temp);
+        emit_expression(operands.at(0));
+        emit(opcode, right_temp);
     }
 }
 
-// Handle the <M> node
-void Generator::handle_m(const Node& node) {
+// Use the temporary of a hoisted loop invariant as a leaf, if there is one
+bool Generator::find_invariant(const Node& node, Expression& expression) {
+    if (invariant_temps.empty()) { return false; }
+
+    map<string, string>::const_iterator it = invariant_temps.find(get_expression_key(node));
+    if (it == invariant_temps.end()) { return false; }
+
+    expression = Expression(it->second);
+    return true;
+}
+
+/** Build the tree of <M> + <exp> | <M> - <exp> | <M>.
+ *  The parser flattens the operators into one list, which groups to the right.
+ *  @param node The <exp> node
+ *  @return: the expression
+ */
+Expression Generator::build_exp(const Node& node) {
     const vector<Node>& children = node.get_children();
+    Expression expression;
 
-    // Ensure the node has children
-    if (children.empty()) {
-        cerr << "Error: <M> node has no children!" << endl;
-        return;
-    }
+    // Reuse the value of a hoisted loop invariant
+    if (find_invariant(node, expression)) { return expression; }
 
-    if (children.size() == 1) {
-        // Base case: Single <N> node
-        handle_n(children.at(0));
-    } else if (children.size() == 3 && children.at(1).get_data() == "%") {
-        // Case: Simple <M> -> <N> % <M>
-        handle_m(children.at(2)); // Process the right-hand side
-        string right_temp = create_temp();
-        code << "STORE " << right_temp << "\n";
-
-        handle_n(children.at(0)); // Process the left-hand side
-        code << "MULT " << right_temp << "\n";
-    } else if (children.size() > 3 && children.at(1).get_data() == "%") {
-        // Case: Complex <M> with multiple % operators
-        Node sub_m;
-        sub_m.set_data("<M>");
-        for (size_t i = 2; i < children.size(); i++) {
-            sub_m.add_child(children.at(i));
+    if (children.size() >= 3 && (children.at(1).get_data() == "+" || children.at(1).get_data() == "-")) {
+        Expression right;
+        if (children.size() == 3) {
+            right = build_m(children.at(2));
+        } else {
+            // Create a sub-expression node for the right-hand side
+            Node sub_exp("<exp>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_exp.add_child(children.at(i)); }
+            right = build_exp(sub_exp);
         }
 
-        handle_m(sub_m); // Process the remaining part of <M>
+        Expression::Kind kind = children.at(1).get_data() == "+" ? Expression::EXPRESSION_ADD : Expression::EXPRESSION_SUB;
+        return Expression(kind, build_m(children.at(0)), right);
+    }
 
-        string right_temp = create_temp();
-        code << "STORE " << right_temp << "\n";
+    if (children.size() == 1) { return build_m(children.at(0)); }
 
-        handle_n(children.at(0)); // Process the left-most child
-        code << "MULT " << right_temp << "\n";
-    } else {
-        // Case: Default (delegate to <N>)
-        handle_n(node);
-    }
+    cerr << "Error: Invalid <exp> node structure.\n";
+    return expression;
 }
 
-// Handle the <N> node
-void Generator::handle_n(const Node& node) {
+// Build the tree of <N> % <M> | <N>
+Expression Generator::build_m(const Node& node) {
     const vector<Node>& children = node.get_children();
+    Expression expression;
 
-    // Ensure the node has children to process
-    if (children.empty()) {
-        cerr << "Error: <N> node has no children!" << endl;
-        return;
-    }
+    // Reuse the value of a hoisted loop invariant
+    if (find_invariant(node, expression)) { return expression; }
 
-    if (children.size() == 1) {
-        // Base case: Single <R> node
-        handle_r(children.at(0));
-    } else if (children.size() == 2 && children.at(0).get_data() == "-") {
-        // Unary negation: -<N>
-        handle_n(children.at(1)); // Process the operand
-        string temp = create_temp();
-        code << "STORE " << temp << "\n"; // Store the result of the operand
-        code << "LOAD 0\n";               // Load 0 into the accumulator
-        code << "SUB " << temp << "\n";   // Subtract the operand from 0 to negate
-    } else if (children.size() == 3 && children.at(1).get_data() == "/") {
-        // Binary division: <R> / <N>
-        handle_r(children.at(0)); // Process the left operand
-        string left_temp = create_temp();
-        code << "STORE " << left_temp << "\n";
-
-        // Traverse the right operand properly
-        traverse(children.at(2)); // Process the right operand
-        string right_temp = create_temp();
-        code << "STORE " << right_temp << "\n";
-
-        code << "LOAD " << left_temp << "\n"; // Load the left operand back into the accumulator
-        code << "DIV " << right_temp << "\n"; // Divide left by right
-    } else if (children.size() > 3 && children.at(1).get_data() == "/") {
-        // Complex division case
-
-        // Handle the sub-expression for the right side
-        Node sub_n;
-        sub_n.set_data("<N>");
-        for (size_t i = 2; i < children.size(); ++i) {
-            sub_n.add_child(children.at(i));
+    if (children.size() == 1) { return build_n(children.at(0)); }
+
+    if (children.size() >= 3 && children.at(1).get_data() == "%") {
+        Expression right;
+        if (children.size() == 3) {
+            right = build_m(children.at(2));
+        } else {
+            // Complex <M> with multiple % operators
+            Node sub_m("<M>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_m.add_child(children.at(i)); }
+            right = build_m(sub_m);
         }
+        return Expression(Expression::EXPRESSION_MUL, build_n(children.at(0)), right);
+    }
 
-        traverse(sub_n); // Process the remaining part of <N>
-        string right_temp = create_temp();
-        code << "STORE " << right_temp << "\n";
+    // Default: delegate to <N>
+    return build_n(node);
+}
+
+// Build the tree of <R> / <N> | - <N> | <R>
+Expression Generator::build_n(const Node& node) {
+    const vector<Node>& children = node.get_children();
+    Expression expression;
 
-        handle_r(children.at(0)); // Process the left-most child
-        string left_temp = create_temp();
-        code << "STORE " << left_temp << "\n";
+    // Reuse the value of a hoisted loop invariant
+    if (find_invariant(node, expression)) { return expression; }
 
-        code << "LOAD " << left_temp << "\n";
-        code << "DIV " << right_temp << "\n";
-    } else {
-        // Default error case for unexpected structures
-        cerr << "Error: Unexpected structure in <N> node." << endl;
+    if (children.size() == 1) { return build_r(children.at(0)); }
+
+    if (children.size() == 2 && children.at(0).get_data() == "-") {
+        // Unary negation: -<N>
+        return Expression(Expression::EXPRESSION_NEG, build_n(children.at(1)));
     }
 
+    if (children.size() >= 3 && children.at(1).get_data() == "/") {
+        Expression right;
+        if (children.size() == 3) {
+            right = get_expression(children.at(2));
+        } else {
+            // Complex division with multiple / operators
+            Node sub_n("<N>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_n.add_child(children.at(i)); }
+            right = build_n(sub_n);
+        }
+        return Expression(Expression::EXPRESSION_DIV, build_r(children.at(0)), right);
+    }
+
+    cerr << "Error: Unexpected structure in <N> node." << endl;
+    return expression;
 }
 
-// Handle the <R> node
-void Generator::handle_r(const Node& node) {
+// Build the tree of ( <exp> ) | identifier | integer
+Expression Generator::build_r(const Node& node) {
     const vector<Node>& children = node.get_children();
+    Expression expression;
 
-    // Ensure the node has children to process
-    if (children.empty()) {
-        cerr << "Error: <R> node has no children!" << endl;
-        return;
-    }
+    // Reuse the value of a hoisted loop invariant
+    if (find_invariant(node, expression)) { return expression; }
 
-    // Case 1: Single terminal node (variable or literal)
+    // Single terminal node (variable or literal)
     if (children.size() == 1) {
         const string& data = children.at(0).get_data();
         if (data.empty()) {
             cerr << "Error: Terminal node in <R> is empty!" << endl;
-            return;
-        }
-
-        // Determine if the terminal node is a variable or literal
-        if (isalpha(data.at(0))) {
-            // If the first character is alphabetic, it's a variable
-            code << "LOAD " << data << "\n";
-        } else {
-            // Otherwise, it's treated as a literal
-            code << "LOAD " << data << "\n";
+            return expression;
         }
+        return Expression(data);
     }
 
-    // Case 2: Parenthesized expression
-    else if (children.size() == 3 && children.at(0).get_data() == "(" && children.at(2).get_data() == ")") {
-        handle_exp(children.at(1)); // Process the expression inside parentheses
+    // Parenthesized expression
+    if (children.size() == 3 && children.at(0).get_data() == "(" && children.at(2).get_data() == ")") {
+        return build_exp(children.at(1));
     }
 
-    // Case 3: Complex expression in <R>
-    else if (children.size() > 1) {
-
-        // Create a new <exp> node for the inner expression
-        Node exp;
-        exp.set_data("<exp>");
-        for (size_t i = 0; i < children.size(); ++i) {
-            exp.add_child(children.at(i));
-        }
-        handle_exp(exp); // Process the new expression node
+    // Complex expression in <R>
+    if (children.size() > 1) {
+        Node exp("<exp>");
+        for (size_t i = 0; i < children.size(); ++i) { exp.add_child(children.at(i)); }
+        return build_exp(exp);
     }
 
-    // Default error case for unexpected structures
-    else {
-        cerr << "Error: Unexpected structure in <R> node." << endl;
-    }
+    cerr << "Error: Unexpected structure in <R> node." << endl;
+    return expression;
 }
 
 // Handle the <assign> node
@@ -557,23 +1022,242 @@ void Generator::handle_assign(const Node& node) {
     const string& var_name = children.at(1).get_data();  
 
     traverse(children.at(2));  // Traverse the expression to evaluate
-    code << "STORE " << var_name << "\n";
+    emit("STORE", var_name);
+
+    // Track variables set to a literal, or copied from one with a known value
+    string value;
+    map<string, long long>::const_iterator known;
+    if (get_leaf_value(children.at(2), value) && isdigit(value.at(0))) {
+        known_values[var_name] = atoll(value.c_str());
+    } else if (get_leaf_value(children.at(2), value) && (known = known_values.find(value)) != known_values.end()) {
+        known_values[var_name] = known->second;
+    } else {
+        known_values.erase(var_name);
+    }
 }
 
-// Get the value of a terminal node
-string Generator::get_terminal_value(const Node& node) {
+
+// Number the <cond> and <iter> nodes in the order they appear
+void Generator::number_sites(const Node& node) {
+    if (node.get_data() == "<cond>" || node.get_data() == "<iter>") {
+        size_t site = site_ids.size();
+        site_ids[&node] = site;
+    }
+
     const vector<Node>& children = node.get_children();
+    for (size_t i = 0; i < children.size(); ++i) {
+        number_sites(children.at(i));
+    }
+}
 
-    // If there are no children, this is a terminal node
-    if (children.empty()) {
-        return node.get_data();  // Return the actual data from the terminal node
+/** Keep the counters at the end of the output of an instrumented run.
+ *  The instrumented program writes the number of sites and then two counters per site,
+ *  so the number in front of the counters tells whether the profile belongs to this program.
+ */
+void Generator::use_profile() {
+    size_t counters = 2 * site_ids.size();
+    if (profile.size() < counters + 1 || profile.at(profile.size() - counters - 1) != static_cast<long long>(site_ids.size())) {
+        exit_error("[Error] The profile does not match the program.");
+    }
+    profile.erase(profile.begin(), profile.end() - counters);
+}
+
+// Increment a profile counter; the accumulator is free at the start of a statement
+void Generator::emit_counter(size_t counter) {
+    string name = generated_name('P', counter);
+    allocate_storage(name);
+
+    emit("LOAD", name);
+    emit("ADD", "1");
+    emit("STORE", name);
+}
+
+// Emit the <stat> of a <cond> or <iter>, counting it if instrumenting
+void Generator::emit_body(const Node& node) {
+    if (instrument) { emit_counter(2 * site_ids[&node] + 1); }
+    traverse(node.get_children().at(6));
+}
+
+/** Check if the profile shows a statement body rarely runs.
+ *  An <iff> body is cold when it runs in fewer than one in eight of the times the <iff> is reached,
+ *  an <iterate> when its body never ran. On the target a branch costs the same taken or not,
+ *  so a body only moves out of line when the relation needs a single branch to enter it
+ *  (every relation but ~), otherwise the skip would cost an extra instruction.
+ *  @param node The <cond> or <iter> node
+ *  @return True if the body should be moved out of line, false otherwise
+ */
+bool Generator::is_cold(const Node& node) {
+    map<const Node*, size_t>::const_iterator site = site_ids.find(&node);
+    if (profile.empty() || site == site_ids.end()) { return false; }
+    if (get_relational_operator(node.get_children().at(3)) == "~") { return false; }
+
+    long long reached = profile.at(2 * site->second);
+    long long runs = profile.at(2 * site->second + 1);
+    if (reached <= 0) { return false; }
+    return node.get_data() == "<iter>" ? runs == 0 : runs * 8 < reached;
+}
+
+/** Branch to a statement body emitted after STOP, which branches back when it is done.
+ *  The state the body is generated in is saved with it, since the code in between changes it.
+ *  @param node The <cond> or <iter> node
+ *  @param writes The variables the body writes
+ */
+void Generator::move_out_of_line(const Node& node, const set<string>& writes) {
+    const vector<Node>& children = node.get_children();
+
+    Cold_Block block;
+    block.label = create_label();
+    block.join = create_label();
+    block.node = &node;
+    block.writes = writes;
+    block.invariant_temps = invariant_temps;
+    block.known_values = known_values;
+    cold_blocks.push_back(block);
+
+    handle_relational(children.at(2), children.at(3), children.at(4), block.label, true);
+    emit_label(block.join);
+    emit("NOOP");
+}
+
+// Emit the blocks moved out of line, including the ones moved out of these
+void Generator::emit_cold_blocks() {
+    for (size_t i = 0; i < cold_blocks.size(); ++i) {
+        Cold_Block block = cold_blocks.at(i);
+        invariant_temps = block.invariant_temps;
+        known_values = block.known_values;
+
+        emit_label(block.label);
+        if (block.node->get_data() == "<cond>") {
+            emit_body(*block.node);
+        } else {
+            // The condition already held, but the guard of the loop tests it again
+            handle_loop(*block.node, block.writes);
+        }
+        emit("BR", block.join);
     }
+    cold_blocks.clear();
+}
 
-    // If there are children, keep traversing to find the terminal node
-    return get_terminal_value(children.at(0));
+/** Number the call sites of every func and decide which funcs to inline.
+ *  The funcs are measured after the funcs they call, so that the size of a body includes
+ *  the callees inlined into it. Calling out of line costs the body once, three instructions
+ *  per call (LOAD number, STORE slot, BR) and two per return in the comparison chain, so a
+ *  func is inlined when its copies add at most the inline budget to that.
+ *  @param node The <program> node
+ */
+void Generator::prepare_functions(const Node& node) {
+    map<string, const Node*> bodies;
+    Tree::find_functions(node, bodies);
+    for (map<string, const Node*>::const_iterator it = bodies.begin(); it != bodies.end(); ++it) {
+        Function function;
+        function.body = it->second;
+        function.call_sites = 0;
+        function.inlined = false;
+        function.label = create_label();
+        function.return_slot = generated_name('R', functions.size());
+        functions[it->first] = function;
+    }
+
+    vector<const Node*> calls;
+    find_calls(node, calls);
+    for (size_t i = 0; i < calls.size(); ++i) {
+        ++functions[calls.at(i)->get_children().at(1).get_data()].call_sites;
+    }
+
+    set<string> visited;
+    for (map<string, Function>::const_iterator it = functions.begin(); it != functions.end(); ++it) {
+        order_functions(it->first, visited);
+    }
+    std::reverse(function_order.begin(), function_order.end());
+
+    if (!inline_functions) { return; }
+    for (size_t i = function_order.size(); i-- > 0; ) {
+        const string& name = function_order.at(i);
+        long long count = static_cast<long long>(functions[name].call_sites);
+        long long size = static_cast<long long>(measure_code(*functions[name].body));
+        long long out_of_line = size + 5 * count - 1;
+        functions[name].inlined = count > 0 && count * size <= out_of_line + static_cast<long long>(inline_budget);
+    }
 }
 
+// Find the <call> nodes under a node
+void Generator::find_calls(const Node& node, vector<const Node*>& calls) {
+    if (node.get_data() == "<call>") {
+        calls.push_back(&node);
+        return;
+    }
 
+    const vector<Node>& children = node.get_children();
+    for (size_t i = 0; i < children.size(); ++i) {
+        find_calls(children.at(i), calls);
+    }
+}
+
+/** Append a func to the order after the funcs it calls; reversed, every func then follows its callers.
+ *  @param name The func
+ *  @param visited The funcs already ordered
+ */
+void Generator::order_functions(const string& name, set<string>& visited) {
+    if (!visited.insert(name).second) { return; }
+
+    vector<const Node*> calls;
+    find_calls(*functions[name].body, calls);
+    for (size_t i = 0; i < calls.size(); ++i) {
+        order_functions(calls.at(i)->get_children().at(1).get_data(), visited);
+    }
+    function_order.push_back(name);
+}
+
+/** Handle the <call> node: expand the body in place, or store the call number and branch to it.
+ *  The body may write any of the variables it reaches, so their known values are forgotten.
+ *  @param node The <call> node
+ */
+void Generator::handle_call(const Node& node) {
+    Function& function = functions[node.get_children().at(1).get_data()];
 
+    if (function.inlined) {
+        traverse(*function.body); // May copy the funcs back in measure_code, so the reference is not used after
+        return;
+    }
+
+    string return_label = create_label();
+    emit("LOAD", to_string(function.return_labels.size()));
+    emit("STORE", function.return_slot);
+    emit("BR", function.label);
+    emit_label(return_label);
+    function.return_labels.push_back(return_label);
+
+    set<string> writes;
+    collect_writes(*function.body, writes);
+    forget_values(writes);
+}
 
+/** Emit the bodies of the funcs called out of line, each after all of its callers so that
+ *  every call is numbered by the time the comparison chain that returns from it is emitted.
+ *  A body runs for every caller, so it is generated without the known values or hoisted invariants of any.
+ */
+void Generator::emit_functions() {
+    for (size_t i = 0; i < function_order.size(); ++i) {
+        const string& name = function_order.at(i);
+        if (functions[name].inlined || functions[name].return_labels.empty()) { continue; }
+
+        known_values.clear();
+        invariant_temps.clear();
+        allocate_storage(functions[name].return_slot);
+
+        emit_label(functions[name].label);
+        traverse(*functions[name].body);
+
+        // The slot holds the call number: branch on it reaching 0 while counting it down
+        const Function& function = functions[name];
+        const vector<string>& returns = function.return_labels;
+        if (returns.size() > 1) { emit("LOAD", function.return_slot); }
+        for (size_t call = 0; call + 1 < returns.size(); ++call) {
+            if (call > 0) { emit("SUB", "1"); }
+            emit("BRZERO", returns.at(call));
+        }
+        emit("BR", returns.back());
 
+        emit_cold_blocks();
+    }
+}
@@ -7,13 +7,21 @@
 
 #include "Tree.h"
 #include "Symbol_Table.h"
+#include "Program.h"
+#include "Expression.h"
+#include "Rewriter.h"
 
+#include <cstdlib>
+#include <map>
+#include <set>
 #include <string>
 #include <sstream>
 
 using std::cerr;
 using std::endl;
 using std::cout;
+using std::map;
+using std::set;
 
 
 class Generator {
@@ -24,9 +32,19 @@ public:
 
     // Getters
     string get_code() const;
+    Program get_program() const;
+    const map<string, size_t>& get_rule_counts() const; // Number of times each rewrite rule applied
 
     // Setters
-    void set_code(const string&);
+    void set_unroll_factor(size_t); // Unroll factor for loops too large to unroll fully (below 2 disables it)
+    void set_unroll_budget(size_t); // Maximum number of instructions an unrolled loop may take
+    void set_simplify_expressions(bool); // Apply the rewrite rules to expressions
+    void set_hoist_invariants(bool); // Hoist loop-invariant expressions out of loops
+    void set_unroll_loops(bool); // Unroll loops with a trip count known at compile time
+    void set_instrumentation(bool); // Count how often each <cond> and <iter> is reached and runs its body
+    void set_profile(const vector<long long>&); // Output of an instrumented run, used to lay out the branches
+    void set_inline_functions(bool); // Inline the funcs the cost model finds worth it at their call sites
+    void set_inline_budget(size_t); // Maximum number of instructions inlining a func may add
 
     // Member functions
     void generate();
@@ -34,19 +52,105 @@ public:
 private:
     // Data fields
     const Tree& tree; // The parse tree for code generation
-    ostringstream code; // Stores the generated code
+    Program program; // Stores the generated code
+    string pending_label; // Label to attach to the next emitted instruction
+    size_t current_line; // Source line of the statement being generated, 0 outside any
 
     size_t label_count; // Counter for generating unique labels
     size_t temp_count; // Counter for generating unique temporary variables
 
     vector<string> declared_variables; // Tracks the variables declared in the program
+    map<string, string> invariant_temps; // Maps hoisted loop-invariant expressions to their temporaries
+    map<string, long long> known_values; // Variables holding a value known at compile time
+    Rewriter rewriter; // Simplifies expressions before code is emitted for them
+
+    size_t unroll_factor; // Unroll factor for loops too large to unroll fully
+    size_t unroll_budget; // Maximum number of instructions an unrolled loop may take
+    size_t max_trip_count; // Largest trip count the unroller will count up to
+
+    bool simplify_expressions; // Apply the rewrite rules to expressions
+    bool hoist_loop_invariants; // Hoist loop-invariant expressions out of loops
+    bool unroll_loops; // Unroll loops with a trip count known at compile time
+
+    // Profile-guided layout
+    // A statement body moved out of line, emitted after STOP
+    struct Cold_Block {
+        string label; // Label of the block
+        string join; // Label of the code after the statement
+        const Node* node; // The <cond> or <iter> node
+        set<string> writes; // The variables the loop body writes, for an <iter>
+        map<string, string> invariant_temps; // The hoisted invariants when the block was moved
+        map<string, long long> known_values; // The known values when the block was moved
+    };
+
+    bool instrument; // Count how often each <cond> and <iter> is reached and runs its body
+    vector<long long> profile; // Output of an instrumented run, empty if none
+    map<const Node*, size_t> site_ids; // Number of each <cond> and <iter> in the order they appear
+    vector<Cold_Block> cold_blocks; // Blocks waiting to be emitted after STOP
+
+    // Procedures
+    // A func is either inlined at every call site or called out of line: the caller stores the number
+    // of its call into the return slot and branches to the body, which is emitted after STOP and
+    // branches back to the label after the call by comparing the slot with each call number
+    struct Function {
+        const Node* body; // The <block> of the func
+        size_t call_sites; // Number of <call> statements naming the func
+        bool inlined; // Expanded at every call site
+        string label; // Label of the body when called out of line
+        string return_slot; // Variable holding the number of the call to return to
+        vector<string> return_labels; // Label after each call, by call number
+    };
+
+    bool inline_functions; // Inline the funcs the cost model finds worth it
+    size_t inline_budget; // Maximum number of instructions inlining a func may add
+    map<string, Function> functions; // Every func, by name
+    vector<string> function_order; // Every func after all the funcs that call it
 
     // Member functions
+    void emit(const string&, const string& = ""); // Append an instruction to the program
+    void emit_label(const string&); // Attach a label to the next emitted instruction
     string create_label(); // Create a unique label
     string create_temp(); // Create a unique temporary variable
 
     void allocate_storage(const string&); // Track the storage of a variable
-    string get_terminal_value(const Node& node); // Get the value of a terminal node
+    bool get_leaf_value(const Node&, string&); // Check whether an <exp> is a single identifier or integer
+    string get_relational_operator(const Node&); // Get the operator of a <relational> node
+    void emit_branch(const string&, const string&, bool); // Emit the branch sequence for a relational operator
+
+    // Loop-invariant code motion
+    void collect_writes(const Node&, set<string>&); // Collect the variables written under a node
+    void collect_invariants(const Node&, const set<string>&, bool, vector<Node>&); // Collect invariant subexpressions
+    void collect_body_invariants(const Node&, const set<string>&, bool, bool&, vector<Node>&); // Collect invariant subexpressions of a loop body
+    void hoist_invariants(const vector<Node>&); // Evaluate invariants once into dedicated temporaries
+    bool is_invariant(const Node&, const set<string>&); // Check whether an expression reads none of the variables
+    bool contains_division(const Node&); // Check whether an expression contains a division
+    string get_expression_key(const Node&); // Get the tokens of an expression as a single string
+    bool find_invariant(const Node&, Expression&); // Use the temporary of a hoisted expression as a leaf
+
+    // Profile-guided layout
+    void number_sites(const Node&); // Number the <cond> and <iter> nodes in the order they appear
+    void use_profile(); // Keep the counters of the profile, checking it matches the program
+    void emit_counter(size_t); // Increment a profile counter
+    void emit_body(const Node&); // Emit the <stat> of a <cond> or <iter>, counting it if instrumenting
+    bool is_cold(const Node&); // Check if the profile shows a body rarely runs
+    void move_out_of_line(const Node&, const set<string>&); // Branch to a body emitted after STOP
+    void emit_cold_blocks(); // Emit the blocks moved out of line
+
+    // Procedures
+    void prepare_functions(const Node&); // Number the call sites of every func and decide which ones to inline
+    void find_calls(const Node&, vector<const Node*>&); // Find the <call> nodes under a node
+    void order_functions(const string&, set<string>&); // Append a func after the funcs it calls
+    void emit_functions(); // Emit the bodies of the funcs called out of line
+
+    // Loop unrolling
+    void handle_loop(const Node&, const set<string>&); // Emit a rotated loop with its preheader
+    bool unroll_loop(const Node&, const set<string>&, string&, long long&); // Unroll a loop with a known trip count
+    bool get_counter_step(const Node&, const string&, long long&); // Find the constant step of a loop counter
+    void find_counter_updates(const Node&, const string&, bool, vector<Node>&, size_t&); // Find the writes to a loop counter
+    size_t measure_code(const Node&); // Count the instructions generated for a node
+    void forget_values(const set<string>&); // Forget the known values of the given variables
+    string swap_relational_operator(const string&); // Swap the operands of a relational operator
+    bool evaluate_relation(const string&, long long); // Evaluate a relational operator given (left - right)
 
     void traverse(const Node& node); // Traverse the parse tree
     void handle_program(const Node& node); // Handle the <program> node
@@ -61,11 +165,17 @@ private:
     void handle_print(const Node& node); // Handle the <print> node
     void handle_cond(const Node& node); // Handle the <cond> node
     void handle_iter(const Node& node); // Handle the <iter> node
-    void handle_relational(const Node& node); // Handle the <relational> node
-    void handle_exp(const Node& node); // Handle the <exp> node
-    void handle_m(const Node& node); // Handle the <M> node
-    void handle_n(const Node& node); // Handle the <N> node
-    void handle_r(const Node& node); // Handle the <R> node
+    void handle_call(const Node& node); // Handle the <call> node
+    void handle_relational(const Node&, const Node&, const Node&, const string&, bool); // Evaluate a condition and branch on it
+    void handle_expression(const Node& node); // Handle an <exp>, <M>, <N> or <R> node
+
+    // Expression trees
+    Expression get_expression(const Node&); // Build the expression tree of a node and simplify it
+    void emit_expression(const Expression&); // Leave the value of an expression in the accumulator
+    Expression build_exp(const Node&); // Build the tree of an <exp>
+    Expression build_m(const Node&); // Build the tree of an <M>
+    Expression build_n(const Node&); // Build the tree of an <N>
+    Expression build_r(const Node&); // Build the tree of an <R>
 };
 
 
@@ -0,0 +1,407 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "IR.h"
+
+#include <algorithm>
+#include <set>
+
+using std::set;
+
+// Constructors
+IR_Instruction::IR_Instruction(IR_Opcode opcode, IR_Type type) : opcode(opcode), type(type), value(0), constant(0) {}
+
+IR_Block::IR_Block(size_t id) : id(id) {}
+
+IR_Module::IR_Module() : next_value(1) {}
+
+// IR_Instruction member functions
+
+// Check if the instruction ends a block
+bool IR_Instruction::is_terminator() const {
+    return opcode == IR_BR || opcode == IR_CBR || opcode == IR_STOP;
+}
+
+/** Converts the instruction to text.
+ *  @return: the instruction, e.g. "%3 = add %1, %2"
+ */
+string IR_Instruction::to_string() const {
+    static const char* names[] = { "const", "load", "store", "add", "sub", "mul", "div", "neg", "cmp", "read", "write", "phi", "br", "cbr", "stop" };
+    ostringstream oss;
+
+    if (value != 0) { oss << "%" << value << " = "; }
+    oss << names[opcode];
+
+    if (opcode == IR_CONST) {
+        oss << " " << constant;
+    } else if (opcode == IR_LOAD) {
+        oss << " " << name;
+    } else if (opcode == IR_STORE) {
+        oss << " " << name << ", %" << operands.at(0);
+    } else if (opcode == IR_CMP) {
+        oss << " " << name << " %" << operands.at(0) << ", %" << operands.at(1);
+    } else if (opcode == IR_PHI) {
+        oss << " " << name;
+        for (size_t i = 0; i < operands.size(); ++i) {
+            oss << (i == 0 ? " " : ", ") << "[%" << operands.at(i) << ", b" << targets.at(i) << "]";
+        }
+    } else if (opcode == IR_BR) {
+        oss << " b" << targets.at(0);
+    } else if (opcode == IR_CBR) {
+        oss << " %" << operands.at(0) << ", b" << targets.at(0) << ", b" << targets.at(1);
+    } else {
+        for (size_t i = 0; i < operands.size(); ++i) {
+            oss << (i == 0 ? " " : ", ") << "%" << operands.at(i);
+        }
+    }
+
+    return oss.str();
+}
+
+// IR_Block member functions
+
+// Get the targets of the terminator
+vector<size_t> IR_Block::get_successors() const {
+    if (instructions.empty() || !instructions.back().is_terminator()) { return vector<size_t>(); }
+    return instructions.back().targets;
+}
+
+// IR_Module getters
+
+vector<IR_Block>& IR_Module::get_blocks() { return blocks; }
+
+const vector<IR_Block>& IR_Module::get_blocks() const { return blocks; }
+
+IR_Block& IR_Module::get_block(size_t id) { return blocks.at(id); }
+
+const IR_Block& IR_Module::get_block(size_t id) const { return blocks.at(id); }
+
+const vector<string>& IR_Module::get_variables() const { return variables; }
+
+// IR_Module member functions
+
+// Create an empty block
+size_t IR_Module::add_block() {
+    blocks.push_back(IR_Block(blocks.size()));
+    return blocks.size() - 1;
+}
+
+// Record a control-flow edge
+void IR_Module::add_edge(size_t from, size_t to) {
+    blocks.at(to).predecessors.push_back(from);
+}
+
+/** Remove a control-flow edge and the matching phi operands.
+ *  The terminator of the source block is left to the caller.
+ *  @param from The source block
+ *  @param to The target block
+ */
+void IR_Module::remove_edge(size_t from, size_t to) {
+    IR_Block& block = blocks.at(to);
+    for (size_t i = 0; i < block.predecessors.size(); ++i) {
+        if (block.predecessors.at(i) != from) { continue; }
+
+        block.predecessors.erase(block.predecessors.begin() + i);
+        for (size_t j = 0; j < block.instructions.size() && block.instructions.at(j).opcode == IR_PHI; ++j) {
+            IR_Instruction& phi = block.instructions.at(j);
+            phi.operands.erase(phi.operands.begin() + i);
+            phi.targets.erase(phi.targets.begin() + i);
+        }
+        return;
+    }
+}
+
+// Create a new SSA value number
+size_t IR_Module::create_value() {
+    return next_value++;
+}
+
+// Record a program variable
+void IR_Module::add_variable(const string& variable) {
+    if (std::find(variables.begin(), variables.end(), variable) == variables.end()) {
+        variables.push_back(variable);
+    }
+}
+
+/** Find the instruction defining a value.
+ *  @param value The SSA value
+ *  @param block Receives the block of the definition
+ *  @param index Receives the index of the definition in its block
+ *  @return True if the value is defined, false otherwise
+ */
+bool IR_Module::find_definition(size_t value, size_t& block, size_t& index) const {
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const vector<IR_Instruction>& instructions = blocks.at(i).instructions;
+        for (size_t j = 0; j < instructions.size(); ++j) {
+            if (instructions.at(j).value == value) {
+                block = i;
+                index = j;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Replace every use of a value
+void IR_Module::replace_uses(size_t old_value, size_t new_value) {
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        vector<IR_Instruction>& instructions = blocks.at(i).instructions;
+        for (size_t j = 0; j < instructions.size(); ++j) {
+            vector<size_t>& operands = instructions.at(j).operands;
+            std::replace(operands.begin(), operands.end(), old_value, new_value);
+        }
+    }
+}
+
+/** Blocks reachable from the entry in reverse postorder.
+ *  Successors are visited last to first, so the first successor of a branch is laid out
+ *  right after it: a loop body follows its header and a conditional body follows its test.
+ *  @return: the block ids
+ */
+vector<size_t> IR_Module::get_reverse_postorder() const {
+    vector<size_t> postorder;
+    if (blocks.empty()) { return postorder; }
+
+    vector<bool> visited(blocks.size(), false);
+    vector<std::pair<size_t, size_t> > stack; // Block and number of successors already visited
+    stack.push_back(std::make_pair(0, 0));
+    visited.at(0) = true;
+
+    while (!stack.empty()) {
+        size_t block = stack.back().first;
+        vector<size_t> successors = blocks.at(block).get_successors();
+
+        if (stack.back().second < successors.size()) {
+            size_t next = successors.at(successors.size() - 1 - stack.back().second);
+            ++stack.back().second;
+            if (!visited.at(next)) {
+                visited.at(next) = true;
+                stack.push_back(std::make_pair(next, 0));
+            }
+        } else {
+            postorder.push_back(block);
+            stack.pop_back();
+        }
+    }
+
+    return vector<size_t>(postorder.rbegin(), postorder.rend());
+}
+
+/** Immediate dominator of each reachable block (Cooper, Harvey and Kennedy).
+ *  @return: the immediate dominator indexed by block id; the entry is its own dominator
+ *           and unreachable blocks hold the number of blocks
+ */
+vector<size_t> IR_Module::get_dominators() const {
+    const size_t undefined = blocks.size();
+    vector<size_t> order = get_reverse_postorder();
+    vector<size_t> position(blocks.size(), undefined);
+    for (size_t i = 0; i < order.size(); ++i) { position.at(order.at(i)) = i; }
+
+    vector<size_t> idom(blocks.size(), undefined);
+    if (order.empty()) { return idom; }
+    idom.at(order.at(0)) = order.at(0);
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < order.size(); ++i) {
+            size_t block = order.at(i);
+            size_t new_idom = undefined;
+
+            const vector<size_t>& predecessors = blocks.at(block).predecessors;
+            for (size_t j = 0; j < predecessors.size(); ++j) {
+                size_t other = predecessors.at(j);
+                if (idom.at(other) == undefined) { continue; } // Not processed yet or unreachable
+
+                if (new_idom == undefined) {
+                    new_idom = other;
+                    continue;
+                }
+
+                // Walk both blocks up the tree until they meet
+                size_t a = other;
+                size_t b = new_idom;
+                while (a != b) {
+                    while (position.at(a) > position.at(b)) { a = idom.at(a); }
+                    while (position.at(b) > position.at(a)) { b = idom.at(b); }
+                }
+                new_idom = a;
+            }
+
+            if (idom.at(block) != new_idom) {
+                idom.at(block) = new_idom;
+                changed = true;
+            }
+        }
+    }
+
+    return idom;
+}
+
+// Check if block a dominates block b
+bool IR_Module::dominates(const vector<size_t>& idom, size_t a, size_t b) const {
+    if (idom.at(b) == blocks.size()) { return false; }
+
+    while (true) {
+        if (a == b) { return true; }
+        if (idom.at(b) == b) { return false; } // Reached the entry
+        b = idom.at(b);
+    }
+}
+
+/** Check the module is well-formed SSA.
+ *  Every reachable block must end in exactly one terminator with its phis first, edges and phi operands
+ *  must agree with the predecessor lists, every value must be defined once with the right type, every
+ *  use must be dominated by its definition, and a bool may only feed the cbr ending its own block.
+ *  @param errors Receives a description of every problem found
+ *  @return True if the module is valid, false otherwise
+ */
+bool IR_Module::verify(vector<string>& errors) const {
+    return verify(errors, get_dominators());
+}
+
+/** Check the module is well-formed SSA given the result of get_dominators for it.
+ *  @param errors Receives a description of every problem found
+ *  @param idom The immediate dominator of each block
+ *  @return True if the module is valid, false otherwise
+ */
+bool IR_Module::verify(vector<string>& errors, const vector<size_t>& idom) const {
+    map<size_t, std::pair<size_t, size_t> > definitions;
+    map<size_t, IR_Type> types;
+
+    // Collect the definitions
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const vector<IR_Instruction>& instructions = blocks.at(b).instructions;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            const IR_Instruction& instruction = instructions.at(i);
+            if (instruction.value == 0) { continue; }
+
+            ostringstream oss;
+            if (definitions.count(instruction.value)) {
+                oss << "%" << instruction.value << " is defined more than once";
+                errors.push_back(oss.str());
+            }
+            definitions[instruction.value] = std::make_pair(b, i);
+            types[instruction.value] = instruction.type;
+        }
+    }
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const IR_Block& block = blocks.at(b);
+        if (idom.at(b) == blocks.size()) { continue; } // Unreachable blocks are never lowered
+
+        ostringstream where;
+        where << "b" << b << ": ";
+
+        if (block.instructions.empty() || !block.instructions.back().is_terminator()) {
+            errors.push_back(where.str() + "block does not end with a terminator");
+            continue;
+        }
+
+        // Successors must list this block as a predecessor
+        vector<size_t> successors = block.get_successors();
+        for (size_t i = 0; i < successors.size(); ++i) {
+            const vector<size_t>& predecessors = blocks.at(successors.at(i)).predecessors;
+            if (std::count(predecessors.begin(), predecessors.end(), b) != 1) {
+                ostringstream oss;
+                oss << where.str() << "edge to b" << successors.at(i) << " is missing from its predecessors";
+                errors.push_back(oss.str());
+            }
+        }
+        for (size_t i = 0; i < block.predecessors.size(); ++i) {
+            vector<size_t> from = blocks.at(block.predecessors.at(i)).get_successors();
+            if (idom.at(block.predecessors.at(i)) != blocks.size() && std::find(from.begin(), from.end(), b) == from.end()) {
+                ostringstream oss;
+                oss << where.str() << "predecessor b" << block.predecessors.at(i) << " does not branch here";
+                errors.push_back(oss.str());
+            }
+        }
+
+        bool in_phis = true;
+        for (size_t i = 0; i < block.instructions.size(); ++i) {
+            const IR_Instruction& instruction = block.instructions.at(i);
+            string text = where.str() + instruction.to_string() + ": ";
+
+            if (instruction.is_terminator() && i + 1 != block.instructions.size()) {
+                errors.push_back(text + "terminator in the middle of a block");
+            }
+            if (instruction.opcode == IR_PHI) {
+                if (!in_phis) { errors.push_back(text + "phi after a non-phi instruction"); }
+                if (instruction.targets != block.predecessors) { errors.push_back(text + "phi operands do not match the predecessors"); }
+            } else {
+                in_phis = false;
+            }
+
+            // Result types
+            IR_Type expected = IR_INT;
+            if (instruction.opcode == IR_STORE || instruction.opcode == IR_WRITE || instruction.is_terminator()) { expected = IR_VOID; }
+            else if (instruction.opcode == IR_CMP) { expected = IR_BOOL; }
+            if (instruction.type != expected || (expected == IR_VOID) != (instruction.value == 0)) {
+                errors.push_back(text + "wrong result type");
+            }
+
+            // Operands
+            for (size_t j = 0; j < instruction.operands.size(); ++j) {
+                size_t operand = instruction.operands.at(j);
+                if (!definitions.count(operand)) {
+                    errors.push_back(text + "use of an undefined value");
+                    continue;
+                }
+
+                IR_Type operand_type = types[operand];
+                bool wants_bool = (instruction.opcode == IR_CBR);
+                if ((operand_type == IR_BOOL) != wants_bool || operand_type == IR_VOID) {
+                    errors.push_back(text + "operand of the wrong type");
+                }
+
+                // The definition must dominate the use, or the end of the incoming block for a phi
+                size_t def_block = definitions[operand].first;
+                size_t def_index = definitions[operand].second;
+                if (instruction.opcode == IR_PHI) {
+                    size_t incoming = instruction.targets.at(j);
+                    if (idom.at(incoming) != blocks.size() && !dominates(idom, def_block, incoming)) {
+                        errors.push_back(text + "phi operand does not dominate its incoming edge");
+                    }
+                } else if (def_block == b ? def_index >= i : !dominates(idom, def_block, b)) {
+                    errors.push_back(text + "use is not dominated by its definition");
+                }
+
+                if (operand_type == IR_BOOL && def_block != b) {
+                    errors.push_back(text + "compare result used outside its block");
+                }
+            }
+        }
+    }
+
+    return errors.empty();
+}
+
+/** Converts the module to text.
+ *  @return: one block per paragraph, with its predecessors
+ */
+string IR_Module::dump() const {
+    ostringstream oss;
+    vector<size_t> order = get_reverse_postorder();
+
+    oss << "; variables:";
+    for (size_t i = 0; i < variables.size(); ++i) { oss << " " << variables.at(i); }
+    oss << "\n";
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        const IR_Block& block = blocks.at(order.at(i));
+        oss << "\nb" << block.id << ":";
+        if (!block.predecessors.empty()) {
+            oss << "  ; preds";
+            for (size_t j = 0; j < block.predecessors.size(); ++j) { oss << " b" << block.predecessors.at(j); }
+        }
+        oss << "\n";
+
+        for (size_t j = 0; j < block.instructions.size(); ++j) {
+            oss << "  " << block.instructions.at(j).to_string() << "\n";
+        }
+    }
+
+    return oss.str();
+}
@@ -0,0 +1,103 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef IR_H
+#define IR_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <sstream>
+
+using std::map;
+using std::string;
+using std::vector;
+using std::ostringstream;
+
+// Instructions of the three-address SSA intermediate representation
+enum IR_Opcode {
+    IR_CONST, // %v = const c
+    IR_LOAD, // %v = load x       (value of variable x in memory)
+    IR_STORE, // store x, %a       (write %a to variable x in memory)
+    IR_ADD, // %v = add %a, %b
+    IR_SUB, // %v = sub %a, %b
+    IR_MUL, // %v = mul %a, %b
+    IR_DIV, // %v = div %a, %b
+    IR_NEG, // %v = neg %a
+    IR_CMP, // %v = cmp .rel. %a, %b   (bool, only used by the cbr ending its block)
+    IR_READ, // %v = read
+    IR_WRITE, // write %a
+    IR_PHI, // %v = phi x [%a, bN], ...
+    IR_BR, // br bN
+    IR_CBR, // cbr %c, bT, bF
+    IR_STOP // stop
+};
+
+// Types of SSA values
+enum IR_Type { IR_VOID, IR_INT, IR_BOOL };
+
+struct IR_Instruction {
+    IR_Opcode opcode;
+    IR_Type type; // Type of the defined value, IR_VOID if none
+    size_t value; // SSA value defined by the instruction, 0 if none
+    long long constant; // The constant of IR_CONST
+    string name; // The variable of IR_LOAD, IR_STORE and IR_PHI, the relation of IR_CMP
+    vector<size_t> operands; // The values used by the instruction
+    vector<size_t> targets; // Successors of IR_BR and IR_CBR, incoming blocks of IR_PHI
+
+    // Constructors
+    IR_Instruction(IR_Opcode = IR_STOP, IR_Type = IR_VOID);
+
+    // Member functions
+    bool is_terminator() const; // Check if the instruction ends a block
+    string to_string() const; // Convert the instruction to text
+};
+
+struct IR_Block {
+    size_t id; // Index of the block in the module
+    vector<size_t> predecessors; // Blocks that branch here, in phi operand order
+    vector<IR_Instruction> instructions; // Phis first, then the body, then one terminator
+
+    // Constructors
+    IR_Block(size_t = 0);
+
+    // Member functions
+    vector<size_t> get_successors() const; // Get the targets of the terminator
+};
+
+class IR_Module {
+public:
+    // Constructors
+    IR_Module();
+
+    // Getters
+    vector<IR_Block>& get_blocks();
+    const vector<IR_Block>& get_blocks() const;
+    IR_Block& get_block(size_t);
+    const IR_Block& get_block(size_t) const;
+    const vector<string>& get_variables() const;
+
+    // Member functions
+    size_t add_block(); // Create an empty block
+    void add_edge(size_t, size_t); // Record a control-flow edge
+    void remove_edge(size_t, size_t); // Remove a control-flow edge and the matching phi operands
+    size_t create_value(); // Create a new SSA value number
+    void add_variable(const string&); // Record a program variable
+    bool find_definition(size_t, size_t&, size_t&) const; // Find the instruction defining a value
+    void replace_uses(size_t, size_t); // Replace every use of a value
+    vector<size_t> get_reverse_postorder() const; // Blocks reachable from the entry in reverse postorder
+    vector<size_t> get_dominators() const; // Immediate dominator of each reachable block
+    bool dominates(const vector<size_t>&, size_t, size_t) const; // Check if one block dominates another
+    bool verify(vector<string>&) const; // Check the module is well-formed SSA
+    bool verify(vector<string>&, const vector<size_t>&) const; // Same, with the dominators already computed
+    string dump() const; // Convert the module to text
+
+private:
+    // Data fields
+    vector<IR_Block> blocks; // Blocks indexed by id, block 0 is the entry
+    vector<string> variables; // Variables allocated in memory
+    size_t next_value; // Next unused SSA value number
+};
+
+#endif // IR_H
@@ -0,0 +1,476 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "IR_Builder.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+
+using std::cerr;
+using std::endl;
+
+// Constructors
+IR_Builder::IR_Builder(const Tree& parse_tree) : tree(parse_tree), current_block(0) {}
+
+// Getters
+const IR_Module& IR_Builder::get_module() const { return module; }
+
+// Member functions
+
+// Translate the parse tree into the module
+void IR_Builder::build() {
+    current_block = module.add_block();
+    seal_block(current_block); // The entry block has no predecessors
+
+    Tree::find_functions(tree.get_root(), functions);
+    build_node(tree.get_root());
+    append(IR_Instruction(IR_STOP));
+
+    remove_trivial_phis();
+}
+
+// Append an instruction to the current block and return its value
+size_t IR_Builder::append(IR_Instruction instruction) {
+    if (instruction.type != IR_VOID) { instruction.value = module.create_value(); }
+    module.get_block(current_block).instructions.push_back(instruction);
+    return instruction.value;
+}
+
+// Append a constant
+size_t IR_Builder::append_constant(long long constant) {
+    IR_Instruction instruction(IR_CONST, IR_INT);
+    instruction.constant = constant;
+    return append(instruction);
+}
+
+// End the current block with an unconditional branch
+void IR_Builder::branch(size_t target) {
+    IR_Instruction instruction(IR_BR);
+    instruction.targets.push_back(target);
+    append(instruction);
+    module.add_edge(current_block, target);
+}
+
+// Mark that a block will get no more predecessors and complete its pending phis
+void IR_Builder::seal_block(size_t block) {
+    map<string, size_t> phis = incomplete_phis[block];
+    for (map<string, size_t>::const_iterator it = phis.begin(); it != phis.end(); ++it) {
+        add_phi_operands(it->first, it->second);
+    }
+    incomplete_phis.erase(block);
+    sealed_blocks.insert(block);
+}
+
+// Record the value of a variable at the end of a block
+void IR_Builder::write_variable(const string& variable, size_t block, size_t value) {
+    current_def[variable][block] = value;
+}
+
+// Find the value of a variable at the end of a block
+size_t IR_Builder::read_variable(const string& variable, size_t block) {
+    map<size_t, size_t>& definitions = current_def[variable];
+    map<size_t, size_t>::const_iterator it = definitions.find(block);
+    if (it != definitions.end()) { return it->second; }
+
+    return read_variable_recursive(variable, block);
+}
+
+/** Find the value of a variable on entry to a block that does not define it.
+ *  @param variable The variable
+ *  @param block The block
+ *  @return: the value, which may be a new phi
+ */
+size_t IR_Builder::read_variable_recursive(const string& variable, size_t block) {
+    const vector<size_t>& predecessors = module.get_block(block).predecessors;
+    size_t value;
+
+    if (!sealed_blocks.count(block)) {
+        // More predecessors may follow: leave an empty phi to fill in when the block is sealed
+        value = create_phi(variable, block);
+        incomplete_phis[block][variable] = value;
+    } else if (predecessors.empty()) {
+        // Not assigned on the way here: use the value in memory
+        value = load_initial_value(variable);
+    } else if (predecessors.size() == 1) {
+        value = read_variable(variable, predecessors.at(0));
+    } else {
+        // Record the phi before reading the predecessors to break cycles through loops
+        value = create_phi(variable, block);
+        write_variable(variable, block, value);
+        value = add_phi_operands(variable, value);
+    }
+
+    write_variable(variable, block, value);
+    return value;
+}
+
+// Load the value a variable has before the program runs
+size_t IR_Builder::load_initial_value(const string& variable) {
+    map<string, size_t>::const_iterator it = initial_values.find(variable);
+    if (it != initial_values.end()) { return it->second; }
+
+    IR_Instruction load(IR_LOAD, IR_INT);
+    load.value = module.create_value();
+    load.name = variable;
+
+    vector<IR_Instruction>& instructions = module.get_block(0).instructions;
+    instructions.insert(instructions.begin(), load);
+
+    module.add_variable(variable);
+    initial_values[variable] = load.value;
+    return load.value;
+}
+
+// Insert an empty phi at the top of a block
+size_t IR_Builder::create_phi(const string& variable, size_t block) {
+    IR_Instruction phi(IR_PHI, IR_INT);
+    phi.value = module.create_value();
+    phi.name = variable;
+
+    vector<IR_Instruction>& instructions = module.get_block(block).instructions;
+    size_t position = 0;
+    while (position < instructions.size() && instructions.at(position).opcode == IR_PHI) { ++position; }
+    instructions.insert(instructions.begin() + position, phi);
+
+    phi_blocks[phi.value] = block;
+    return phi.value;
+}
+
+/** Fill a phi with the value of its variable at the end of each predecessor.
+ *  @param variable The variable
+ *  @param phi The phi value
+ *  @return: the phi, or the value replacing it if it turned out to be trivial
+ */
+size_t IR_Builder::add_phi_operands(const string& variable, size_t phi) {
+    vector<size_t> predecessors = module.get_block(phi_blocks[phi]).predecessors;
+
+    for (size_t i = 0; i < predecessors.size(); ++i) {
+        size_t value = read_variable(variable, predecessors.at(i));
+
+        // Reading may insert other phis into the block, so look this one up again
+        IR_Instruction* instruction = find_phi(phi);
+        instruction->operands.push_back(value);
+        instruction->targets.push_back(predecessors.at(i));
+    }
+
+    return try_remove_trivial_phi(phi);
+}
+
+/** Replace a phi that merges a single value (apart from itself) with that value.
+ *  @param phi The phi value
+ *  @return: the phi if it is needed, otherwise the value that replaced it
+ */
+size_t IR_Builder::try_remove_trivial_phi(size_t phi) {
+    IR_Instruction* instruction = find_phi(phi);
+    if (instruction == NULL) { return phi; }
+
+    size_t same = 0;
+    for (size_t i = 0; i < instruction->operands.size(); ++i) {
+        size_t operand = instruction->operands.at(i);
+        if (operand == same || operand == phi) { continue; }
+        if (same != 0) { return phi; } // Merges at least two values
+        same = operand;
+    }
+
+    string variable = instruction->name;
+    size_t block = phi_blocks[phi];
+
+    // Remove the phi itself
+    vector<IR_Instruction>& instructions = module.get_block(block).instructions;
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        if (instructions.at(i).value == phi) {
+            instructions.erase(instructions.begin() + i);
+            break;
+        }
+    }
+    phi_blocks.erase(phi);
+
+    // Only reachable through itself: the variable is never assigned before it
+    if (same == 0) { same = load_initial_value(variable); }
+
+    module.replace_uses(phi, same);
+    for (map<string, map<size_t, size_t> >::iterator it = current_def.begin(); it != current_def.end(); ++it) {
+        for (map<size_t, size_t>::iterator def = it->second.begin(); def != it->second.end(); ++def) {
+            if (def->second == phi) { def->second = same; }
+        }
+    }
+
+    return same;
+}
+
+// Remove the phis made trivial by earlier removals until none are left
+void IR_Builder::remove_trivial_phis() {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        map<size_t, size_t> phis = phi_blocks;
+        for (map<size_t, size_t>::const_iterator it = phis.begin(); it != phis.end(); ++it) {
+            if (try_remove_trivial_phi(it->first) != it->first) { changed = true; }
+        }
+    }
+}
+
+// Find a phi that has not been removed
+IR_Instruction* IR_Builder::find_phi(size_t phi) {
+    map<size_t, size_t>::const_iterator it = phi_blocks.find(phi);
+    if (it == phi_blocks.end()) { return NULL; }
+
+    vector<IR_Instruction>& instructions = module.get_block(it->second).instructions;
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        if (instructions.at(i).value == phi) { return &instructions.at(i); }
+    }
+    return NULL;
+}
+
+// Translate a statement-level node
+void IR_Builder::build_node(const Node& node) {
+    const string& data = node.get_data();
+    const vector<Node>& children = node.get_children();
+
+    if (data == "<vars>") {
+        if (children.size() > 1 && children.at(0).get_data() == "var") { build_var_list(children.at(1)); }
+    } else if (data == "<read>") {
+        write_variable(children.at(1).get_data(), current_block, append(IR_Instruction(IR_READ, IR_INT)));
+    } else if (data == "<print>") {
+        IR_Instruction write(IR_WRITE);
+        write.operands.push_back(build_exp(children.at(1)));
+        append(write);
+    } else if (data == "<assign>") {
+        write_variable(children.at(1).get_data(), current_block, build_exp(children.at(2)));
+    } else if (data == "<cond>") {
+        build_cond(node);
+    } else if (data == "<iter>") {
+        build_iter(node);
+    } else if (data == "<call>") {
+        // Every call is inlined; the SSA passes then see the body in its context
+        build_node(*functions[children.at(1).get_data()]);
+    } else if (data == "<funcs>") {
+        // Funcs only run when called
+    } else {
+        // <program>, <block>, <stats>, <mStat> and <stat> only group statements
+        for (size_t i = 0; i < children.size(); ++i) {
+            build_node(children.at(i));
+        }
+    }
+}
+
+/** Translate iff [ <exp> <relational> <exp> ] <stat>.
+ *  The test ends its block with a branch to the statement or past it, and the
+ *  join block merges the values the statement assigned with phis.
+ *  @param node The <cond> node
+ */
+void IR_Builder::build_cond(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    size_t condition = build_compare(node);
+    size_t then_block = module.add_block();
+    size_t join_block = module.add_block();
+
+    IR_Instruction cbr(IR_CBR);
+    cbr.operands.push_back(condition);
+    cbr.targets.push_back(then_block);
+    cbr.targets.push_back(join_block);
+    append(cbr);
+    module.add_edge(current_block, then_block);
+    module.add_edge(current_block, join_block);
+
+    seal_block(then_block);
+    current_block = then_block;
+    build_node(children.at(6));
+    branch(join_block);
+
+    seal_block(join_block);
+    current_block = join_block;
+}
+
+/** Translate iterate [ <exp> <relational> <exp> ] <stat>.
+ *  The header tests the condition and is sealed only after the body branches back
+ *  to it, so the phis of the variables the body assigns get both incoming values.
+ *  @param node The <iter> node
+ */
+void IR_Builder::build_iter(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    size_t header_block = module.add_block();
+    branch(header_block);
+    current_block = header_block;
+
+    size_t condition = build_compare(node);
+    size_t body_block = module.add_block();
+    size_t exit_block = module.add_block();
+
+    IR_Instruction cbr(IR_CBR);
+    cbr.operands.push_back(condition);
+    cbr.targets.push_back(body_block);
+    cbr.targets.push_back(exit_block);
+    append(cbr);
+    module.add_edge(header_block, body_block);
+    module.add_edge(header_block, exit_block);
+
+    seal_block(body_block);
+    current_block = body_block;
+    build_node(children.at(6));
+    branch(header_block);
+
+    seal_block(header_block);
+    seal_block(exit_block);
+    current_block = exit_block;
+}
+
+// Record the variables of a <varList>
+void IR_Builder::build_var_list(const Node& node) {
+    const vector<Node>& children = node.get_children();
+    if (children.size() != 4) {
+        cerr << "Error: Malformed <varList> node.\n";
+        return;
+    }
+
+    module.add_variable(children.at(0).get_data());
+    if (children.at(3).get_data() == "<varList>") { build_var_list(children.at(3)); }
+}
+
+// Translate an <exp>, <M>, <N> or <R> and return its value
+size_t IR_Builder::build_value(const Node& node) {
+    const string& data = node.get_data();
+
+    if (data == "<exp>") { return build_exp(node); }
+    if (data == "<M>") { return build_m(node); }
+    if (data == "<N>") { return build_n(node); }
+    return build_r(node);
+}
+
+/** Translate <M> + <exp> | <M> - <exp> | <M>.
+ *  The parser flattens the operators into one list, which groups to the right like the generator does.
+ *  @param node The <exp> node
+ *  @return: the value of the expression
+ */
+size_t IR_Builder::build_exp(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() >= 3 && (children.at(1).get_data() == "+" || children.at(1).get_data() == "-")) {
+        // The right-hand side first, so the left-hand side is the last value computed
+        size_t right;
+        if (children.size() == 3) {
+            right = build_m(children.at(2));
+        } else {
+            Node sub_exp("<exp>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_exp.add_child(children.at(i)); }
+            right = build_exp(sub_exp);
+        }
+        size_t left = build_m(children.at(0));
+
+        IR_Instruction instruction(children.at(1).get_data() == "+" ? IR_ADD : IR_SUB, IR_INT);
+        instruction.operands.push_back(left);
+        instruction.operands.push_back(right);
+        return append(instruction);
+    }
+
+    if (children.size() == 1) { return build_m(children.at(0)); }
+
+    cerr << "Error: Invalid <exp> node structure.\n";
+    return append_constant(0);
+}
+
+// Translate <N> % <M> | <N>
+size_t IR_Builder::build_m(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() == 1) { return build_n(children.at(0)); }
+
+    if (children.size() >= 3 && children.at(1).get_data() == "%") {
+        size_t right;
+        if (children.size() == 3) {
+            right = build_m(children.at(2));
+        } else {
+            Node sub_m("<M>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_m.add_child(children.at(i)); }
+            right = build_m(sub_m);
+        }
+        size_t left = build_n(children.at(0));
+
+        IR_Instruction instruction(IR_MUL, IR_INT);
+        instruction.operands.push_back(left);
+        instruction.operands.push_back(right);
+        return append(instruction);
+    }
+
+    return build_n(node);
+}
+
+// Translate <R> / <N> | - <N> | <R>
+size_t IR_Builder::build_n(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() == 1) { return build_r(children.at(0)); }
+
+    if (children.size() == 2 && children.at(0).get_data() == "-") {
+        IR_Instruction instruction(IR_NEG, IR_INT);
+        instruction.operands.push_back(build_n(children.at(1)));
+        return append(instruction);
+    }
+
+    if (children.size() >= 3 && children.at(1).get_data() == "/") {
+        size_t right;
+        if (children.size() == 3) {
+            right = build_value(children.at(2));
+        } else {
+            Node sub_n("<N>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_n.add_child(children.at(i)); }
+            right = build_n(sub_n);
+        }
+        size_t left = build_r(children.at(0));
+
+        IR_Instruction instruction(IR_DIV, IR_INT);
+        instruction.operands.push_back(left);
+        instruction.operands.push_back(right);
+        return append(instruction);
+    }
+
+    cerr << "Error: Unexpected structure in <N> node." << endl;
+    return append_constant(0);
+}
+
+// Translate ( <exp> ) | identifier | integer
+size_t IR_Builder::build_r(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() == 1) {
+        const string& data = children.at(0).get_data();
+        if (!data.empty() && isdigit(data.at(0))) { return append_constant(atoll(data.c_str())); }
+        return read_variable(data, current_block);
+    }
+
+    if (children.size() == 3 && children.at(0).get_data() == "(" && children.at(2).get_data() == ")") {
+        return build_exp(children.at(1));
+    }
+
+    if (children.size() > 1) {
+        Node exp("<exp>");
+        for (size_t i = 0; i < children.size(); ++i) { exp.add_child(children.at(i)); }
+        return build_exp(exp);
+    }
+
+    cerr << "Error: Unexpected structure in <R> node." << endl;
+    return append_constant(0);
+}
+
+/** Translate the [ <exp> <relational> <exp> ] of an <iff> or <iterate>.
+ *  @param node The <cond> or <iter> node
+ *  @return: the bool value of the comparison
+ */
+size_t IR_Builder::build_compare(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    size_t right = build_exp(children.at(4));
+    size_t left = build_exp(children.at(2));
+
+    const Node& relational = children.at(3);
+    IR_Instruction instruction(IR_CMP, IR_BOOL);
+    instruction.name = relational.get_children().empty() ? relational.get_data() : relational.get_children().at(0).get_data();
+    instruction.operands.push_back(left);
+    instruction.operands.push_back(right);
+    return append(instruction);
+}
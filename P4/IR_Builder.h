@@ -0,0 +1,75 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef IR_BUILDER_H
+#define IR_BUILDER_H
+
+#include "Tree.h"
+#include "IR.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+// Builds the SSA form of a parse tree directly, without computing dominance frontiers first
+// (Braun et al., "Simple and Efficient Construction of Static Single Assignment Form")
+class IR_Builder {
+public:
+    // Constructors
+    IR_Builder(const Tree&);
+
+    // Getters
+    const IR_Module& get_module() const;
+
+    // Member functions
+    void build(); // Translate the parse tree into the module
+
+private:
+    // Data fields
+    const Tree& tree; // The parse tree to translate
+    IR_Module module; // The module being built
+    size_t current_block; // Block receiving new instructions
+    map<string, const Node*> functions; // The <block> of each func, by name
+
+    map<string, map<size_t, size_t> > current_def; // Value of each variable at the end of each block
+    set<size_t> sealed_blocks; // Blocks whose predecessors are all known
+    map<size_t, map<string, size_t> > incomplete_phis; // Phis created in unsealed blocks, by variable
+    map<size_t, size_t> phi_blocks; // Block holding each phi that has not been removed
+    map<string, size_t> initial_values; // Load of the value each variable has before the program runs
+
+    // Member functions
+    size_t append(IR_Instruction); // Append an instruction to the current block and return its value
+    size_t append_constant(long long); // Append a constant
+    void branch(size_t); // End the current block with an unconditional branch
+    void seal_block(size_t); // Mark that a block will get no more predecessors
+
+    void write_variable(const string&, size_t, size_t); // Record the value of a variable in a block
+    size_t read_variable(const string&, size_t); // Find the value of a variable in a block
+    size_t read_variable_recursive(const string&, size_t); // Find the value of a variable in the predecessors
+    size_t load_initial_value(const string&); // Load the value a variable has before the program runs
+    size_t create_phi(const string&, size_t); // Insert an empty phi at the top of a block
+    size_t add_phi_operands(const string&, size_t); // Fill a phi from the predecessors of its block
+    size_t try_remove_trivial_phi(size_t); // Replace a phi whose operands are all the same value
+    void remove_trivial_phis(); // Remove the phis made trivial by earlier removals
+    IR_Instruction* find_phi(size_t); // Find a phi that has not been removed
+
+    void build_node(const Node&); // Translate a statement-level node
+    void build_cond(const Node&); // Translate an <iff>
+    void build_iter(const Node&); // Translate an <iterate>
+    void build_var_list(const Node&); // Record the variables of a <varList>
+    size_t build_value(const Node&); // Translate an <exp>, <M>, <N> or <R> and return its value
+    size_t build_exp(const Node&); // Translate an <exp> and return its value
+    size_t build_m(const Node&); // Translate an <M> and return its value
+    size_t build_n(const Node&); // Translate an <N> and return its value
+    size_t build_r(const Node&); // Translate an <R> and return its value
+    size_t build_compare(const Node&); // Translate [ <exp> <relational> <exp> ] and return the bool value
+};
+
+#endif // IR_BUILDER_H
@@ -0,0 +1,424 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "IR_Lowering.h"
+
+#include <cctype>
+#include <iostream>
+
+using std::cerr;
+using std::endl;
+
+// Constructors
+IR_Lowering::IR_Lowering(const IR_Module& ir_module) : module(ir_module), label_count(0), temp_count(0), accumulator(0) {}
+
+// Getters
+Program IR_Lowering::get_program() const { return program; }
+
+// Member functions
+
+/** Append an instruction to the program, attaching the pending label if there is one.
+ *  The accumulator is assumed to change; callers record what it holds afterwards.
+ *  @param opcode The instruction name
+ *  @param operand The operand, if any
+ */
+void IR_Lowering::emit(const string& opcode, const string& operand) {
+    program.add_instruction(Instruction(opcode, operand, pending_label));
+    pending_label.clear();
+    accumulator = 0;
+}
+
+// Attach a label to the next emitted instruction
+void IR_Lowering::emit_label(const string& label) {
+    if (!pending_label.empty()) {
+        emit("NOOP"); // Two labels in a row need an instruction in between
+    }
+    pending_label = label;
+    accumulator = 0; // Control may arrive from elsewhere
+}
+
+// Create a unique label
+string IR_Lowering::create_label() {
+    ostringstream label;
+    label << "L" << label_count++;
+    return label.str();
+}
+
+// Create a unique temporary variable
+string IR_Lowering::create_temp() {
+    string temp = generated_name('T', temp_count++);
+    temps.push_back(temp);
+    return temp;
+}
+
+/** Translate the module into the program.
+ *  Blocks are laid out in reverse postorder, so a branch usually falls into its first
+ *  successor and only the blocks entered by a jump get a label.
+ */
+void IR_Lowering::lower() {
+    layout = module.get_reverse_postorder();
+    for (size_t i = 0; i < layout.size(); ++i) { positions[layout.at(i)] = i; }
+
+    for (size_t i = 0; i < layout.size(); ++i) {
+        const vector<size_t>& predecessors = module.get_block(layout.at(i)).predecessors;
+        for (size_t j = 0; j < predecessors.size(); ++j) {
+            if (positions.count(predecessors.at(j)) && !falls_through(predecessors.at(j), layout.at(i))) {
+                block_labels[layout.at(i)] = create_label();
+                break;
+            }
+        }
+    }
+
+    assign_locations();
+
+    for (size_t i = 0; i < layout.size(); ++i) {
+        lower_block(layout.at(i));
+    }
+
+    // Out-of-line copies for the taken side of conditional branches
+    for (size_t i = 0; i < stubs.size(); ++i) {
+        emit_label(stubs.at(i).label);
+        emit_copies(stubs.at(i).from, stubs.at(i).to);
+        emit("BR", block_labels[stubs.at(i).to]);
+    }
+    if (!pending_label.empty()) { emit("NOOP"); }
+
+    // Add storage for the program variables and the temporaries
+    const vector<string>& variables = module.get_variables();
+    for (size_t i = 0; i < variables.size(); ++i) { program.add_storage(variables.at(i)); }
+    for (size_t i = 0; i < temps.size(); ++i) { program.add_storage(temps.at(i)); }
+}
+
+/** Decide where each value lives.
+ *  Non-negative constants are immediates, loads of variables the module never stores to
+ *  read the variable itself, a value used only by the next instruction stays in the
+ *  accumulator, and everything else gets a temporary.
+ */
+void IR_Lowering::assign_locations() {
+    set<string> stored_variables;
+    map<size_t, size_t> use_counts;
+
+    for (size_t i = 0; i < layout.size(); ++i) {
+        const vector<IR_Instruction>& instructions = module.get_block(layout.at(i)).instructions;
+        for (size_t j = 0; j < instructions.size(); ++j) {
+            const IR_Instruction& instruction = instructions.at(j);
+            if (instruction.opcode == IR_STORE) { stored_variables.insert(instruction.name); }
+            for (size_t k = 0; k < instruction.operands.size(); ++k) { ++use_counts[instruction.operands.at(k)]; }
+        }
+    }
+
+    for (size_t i = 0; i < layout.size(); ++i) {
+        const IR_Block& block = module.get_block(layout.at(i));
+        for (size_t j = 0; j < block.instructions.size(); ++j) {
+            const IR_Instruction& instruction = block.instructions.at(j);
+            if (instruction.value == 0 || instruction.opcode == IR_CMP) { continue; }
+
+            if (instruction.opcode == IR_CONST && instruction.constant >= 0) {
+                ostringstream oss;
+                oss << instruction.constant;
+                locations[instruction.value] = oss.str();
+            } else if (instruction.opcode == IR_LOAD && !stored_variables.count(instruction.name)) {
+                locations[instruction.value] = instruction.name;
+            } else if (instruction.opcode != IR_READ && instruction.opcode != IR_PHI && is_consumed_next(block, j, use_counts)) {
+                accumulator_values.insert(instruction.value);
+            } else {
+                locations[instruction.value] = create_temp();
+            }
+        }
+    }
+}
+
+/** Check if a value is only used as the left operand of the instruction right after it,
+ *  so it can be left in the accumulator instead of being stored.
+ *  @param block The block defining the value
+ *  @param index The index of the definition
+ *  @param use_counts The number of uses of each value
+ *  @return True if the value never needs a location, false otherwise
+ */
+bool IR_Lowering::is_consumed_next(const IR_Block& block, size_t index, const map<size_t, size_t>& use_counts) {
+    size_t value = block.instructions.at(index).value;
+    map<size_t, size_t>::const_iterator uses = use_counts.find(value);
+    if (uses == use_counts.end() || uses->second != 1 || index + 1 >= block.instructions.size()) { return false; }
+
+    const IR_Instruction& next = block.instructions.at(index + 1);
+    if (next.operands.empty() || next.operands.at(0) != value) { return false; }
+
+    switch (next.opcode) {
+    case IR_STORE:
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_DIV:
+        return true;
+    case IR_CMP:
+        // The compare is lowered at the branch, so nothing may come in between
+        return index + 2 < block.instructions.size() && block.instructions.at(index + 2).opcode == IR_CBR;
+    default:
+        return false;
+    }
+}
+
+// Check if the layout lets one block fall into another
+bool IR_Lowering::falls_through(size_t from, size_t to) const {
+    map<size_t, size_t>::const_iterator from_position = positions.find(from);
+    map<size_t, size_t>::const_iterator to_position = positions.find(to);
+    if (from_position == positions.end() || to_position == positions.end()) { return false; }
+    if (to_position->second != from_position->second + 1) { return false; }
+
+    vector<size_t> successors = module.get_block(from).get_successors();
+    for (size_t i = 0; i < successors.size(); ++i) {
+        if (successors.at(i) == to) { return true; }
+    }
+    return false;
+}
+
+// Bring a value into the accumulator
+void IR_Lowering::load(size_t value) {
+    if (accumulator == value) { return; }
+    if (accumulator_values.count(value)) { cerr << "Error: %" << value << " is no longer in the accumulator." << endl; }
+
+    emit("LOAD", locations[value]);
+    accumulator = value;
+}
+
+// Save the value just computed into its location
+void IR_Lowering::store_result(size_t value) {
+    if (!accumulator_values.count(value)) { emit("STORE", locations[value]); }
+    accumulator = value;
+}
+
+// Translate a block
+void IR_Lowering::lower_block(size_t id) {
+    const IR_Block& block = module.get_block(id);
+
+    map<size_t, string>::const_iterator label = block_labels.find(id);
+    if (label != block_labels.end()) { emit_label(label->second); }
+
+    for (size_t i = 0; i < block.instructions.size(); ++i) {
+        if (block.instructions.at(i).is_terminator()) {
+            lower_terminator(block);
+        } else {
+            lower_instruction(block, i);
+        }
+    }
+}
+
+// Translate a non-terminator
+void IR_Lowering::lower_instruction(const IR_Block& block, size_t index) {
+    const IR_Instruction& instruction = block.instructions.at(index);
+    const vector<size_t>& operands = instruction.operands;
+
+    switch (instruction.opcode) {
+    case IR_CONST:
+        if (instruction.constant < 0) {
+            // Immediates are non-negative: subtract the magnitude from zero
+            ostringstream oss;
+            oss << -instruction.constant;
+            emit("LOAD", "0");
+            emit("SUB", oss.str());
+            store_result(instruction.value);
+        }
+        break;
+    case IR_LOAD:
+        if (locations[instruction.value] != instruction.name) {
+            emit("LOAD", instruction.name);
+            store_result(instruction.value);
+        }
+        break;
+    case IR_STORE:
+        load(operands.at(0));
+        emit("STORE", instruction.name);
+        accumulator = operands.at(0);
+        break;
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_DIV: {
+        static const char* opcodes[] = { "ADD", "SUB", "MULT", "DIV" };
+        load(operands.at(0));
+        emit(opcodes[instruction.opcode - IR_ADD], locations[operands.at(1)]);
+        store_result(instruction.value);
+        break;
+    }
+    case IR_NEG:
+        emit("LOAD", "0");
+        emit("SUB", locations[operands.at(0)]);
+        store_result(instruction.value);
+        break;
+    case IR_READ:
+        emit("READ", locations[instruction.value]);
+        break;
+    case IR_WRITE: {
+        const string& location = locations[operands.at(0)];
+        if (isdigit(location.at(0))) {
+            // WRITE takes a variable, so the constant goes through a temporary
+            if (write_temp.empty()) { write_temp = create_temp(); }
+            load(operands.at(0));
+            emit("STORE", write_temp);
+            emit("WRITE", write_temp);
+        } else {
+            emit("WRITE", location);
+        }
+        break;
+    }
+    case IR_CMP:
+    case IR_PHI:
+        break; // Compares are lowered with their branch, phis with the copies on their edges
+    default:
+        cerr << "Error: Unexpected instruction: " << instruction.to_string() << endl;
+        break;
+    }
+}
+
+/** Translate the terminator of a block.
+ *  A conditional branch jumps to the successor that is not laid out next, through a stub
+ *  when that edge carries phi copies, and falls into the other one.
+ *  @param block The block
+ */
+void IR_Lowering::lower_terminator(const IR_Block& block) {
+    const IR_Instruction& terminator = block.instructions.back();
+
+    if (terminator.opcode == IR_STOP) {
+        emit("STOP");
+    } else if (terminator.opcode == IR_BR) {
+        size_t target = terminator.targets.at(0);
+        emit_copies(block.id, target);
+        if (!falls_through(block.id, target)) { emit("BR", block_labels[target]); }
+    } else if (terminator.opcode == IR_CBR) {
+        // Find the compare feeding the branch
+        const IR_Instruction* compare = NULL;
+        for (size_t i = block.instructions.size(); i-- > 0;) {
+            if (block.instructions.at(i).value == terminator.operands.at(0)) {
+                compare = &block.instructions.at(i);
+                break;
+            }
+        }
+        if (compare == NULL) {
+            cerr << "Error: cbr in b" << block.id << " does not use a compare of its block." << endl;
+            return;
+        }
+
+        // The accumulator holds (left - right)
+        load(compare->operands.at(0));
+        if (locations[compare->operands.at(1)] != "0") { emit("SUB", locations[compare->operands.at(1)]); }
+
+        size_t true_block = terminator.targets.at(0);
+        size_t false_block = terminator.targets.at(1);
+        bool branch_on_true = !falls_through(block.id, true_block);
+        size_t taken = branch_on_true ? true_block : false_block;
+
+        string target = block_labels[taken];
+        if (has_copies(block.id, taken)) {
+            Stub stub;
+            stub.label = create_label();
+            stub.from = block.id;
+            stub.to = taken;
+            stubs.push_back(stub);
+            target = stub.label;
+        }
+        emit_branch(compare->name, target, branch_on_true);
+
+        size_t other = branch_on_true ? false_block : true_block;
+        emit_copies(block.id, other);
+        if (!falls_through(block.id, other)) { emit("BR", block_labels[other]); }
+    } else {
+        cerr << "Error: Unexpected terminator: " << terminator.to_string() << endl;
+    }
+}
+
+// Check if an edge carries phi copies
+bool IR_Lowering::has_copies(size_t from, size_t to) const {
+    const vector<IR_Instruction>& instructions = module.get_block(to).instructions;
+    for (size_t i = 0; i < instructions.size() && instructions.at(i).opcode == IR_PHI; ++i) {
+        const IR_Instruction& phi = instructions.at(i);
+        for (size_t j = 0; j < phi.targets.size(); ++j) {
+            if (phi.targets.at(j) != from) { continue; }
+
+            map<size_t, string>::const_iterator source = locations.find(phi.operands.at(j));
+            map<size_t, string>::const_iterator destination = locations.find(phi.value);
+            if (source == locations.end() || destination == locations.end() || source->second != destination->second) { return true; }
+        }
+    }
+    return false;
+}
+
+/** Copy the operands a block's phis take from one predecessor into the phis.
+ *  The copies happen at once, so when one phi reads another phi of the same block
+ *  the sources are first saved in temporaries.
+ *  @param from The predecessor
+ *  @param to The block with the phis
+ */
+void IR_Lowering::emit_copies(size_t from, size_t to) {
+    vector<size_t> destinations;
+    vector<size_t> sources;
+
+    const vector<IR_Instruction>& instructions = module.get_block(to).instructions;
+    for (size_t i = 0; i < instructions.size() && instructions.at(i).opcode == IR_PHI; ++i) {
+        const IR_Instruction& phi = instructions.at(i);
+        for (size_t j = 0; j < phi.targets.size(); ++j) {
+            if (phi.targets.at(j) == from && locations[phi.operands.at(j)] != locations[phi.value]) {
+                destinations.push_back(phi.value);
+                sources.push_back(phi.operands.at(j));
+            }
+        }
+    }
+
+    // Save the sources that another copy overwrites
+    vector<string> saved(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        for (size_t j = 0; j < destinations.size(); ++j) {
+            if (j != i && locations[sources.at(i)] == locations[destinations.at(j)]) {
+                saved.at(i) = create_temp();
+                load(sources.at(i));
+                emit("STORE", saved.at(i));
+                break;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < destinations.size(); ++i) {
+        if (saved.at(i).empty()) {
+            load(sources.at(i));
+        } else {
+            emit("LOAD", saved.at(i));
+        }
+        emit("STORE", locations[destinations.at(i)]);
+        accumulator = destinations.at(i);
+    }
+}
+
+/** Emit the branch sequence for a relational operator, assuming the accumulator holds (left - right).
+ *  @param rel_op The relational operator
+ *  @param target The label to branch to
+ *  @param branch_on_true True to branch when the relation holds, false to branch when it fails
+ */
+void IR_Lowering::emit_branch(const string& rel_op, const string& target, bool branch_on_true) {
+    if (rel_op == ".ge.") {
+        emit(branch_on_true ? "BRZPOS" : "BRNEG", target);
+    } else if (rel_op == ".le.") {
+        emit(branch_on_true ? "BRZNEG" : "BRPOS", target);
+    } else if (rel_op == ".gt.") {
+        emit(branch_on_true ? "BRPOS" : "BRZNEG", target);
+    } else if (rel_op == ".lt.") {
+        emit(branch_on_true ? "BRNEG" : "BRZPOS", target);
+    } else if (rel_op == "**") {
+        // Equal
+        if (branch_on_true) {
+            emit("BRZERO", target);
+        } else {
+            emit("BRNEG", target);
+            emit("BRPOS", target);
+        }
+    } else if (rel_op == "~") {
+        // Not equal
+        if (branch_on_true) {
+            emit("BRNEG", target);
+            emit("BRPOS", target);
+        } else {
+            emit("BRZERO", target);
+        }
+    } else {
+        cerr << "Error: Unknown relational operator: " << rel_op << endl;
+    }
+}
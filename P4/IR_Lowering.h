@@ -0,0 +1,79 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef IR_LOWERING_H
+#define IR_LOWERING_H
+
+#include "IR.h"
+#include "Program.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+// Translates an SSA module into accumulator assembly, replacing the phis with copies on the incoming edges
+class IR_Lowering {
+public:
+    // Constructors
+    IR_Lowering(const IR_Module&);
+
+    // Getters
+    Program get_program() const;
+
+    // Member functions
+    void lower(); // Translate the module into the program
+
+private:
+    // An edge whose phi copies sit out of line: the stub runs the copies and branches to the target
+    struct Stub {
+        string label; // Label the conditional branch jumps to
+        size_t from; // Source block of the edge
+        size_t to; // Target block of the edge
+    };
+
+    // Data fields
+    const IR_Module& module; // The module to translate
+    Program program; // The lowered program
+    string pending_label; // Label to attach to the next emitted instruction
+
+    size_t label_count; // Counter for generating unique labels
+    size_t temp_count; // Counter for generating unique temporary variables
+    size_t accumulator; // Value held by the accumulator, 0 if unknown
+
+    vector<size_t> layout; // Blocks in the order they are emitted
+    map<size_t, size_t> positions; // Position of each block in the layout
+    map<size_t, string> block_labels; // Labels of the blocks that are branched to
+    map<size_t, string> locations; // Memory location or immediate holding each value
+    set<size_t> accumulator_values; // Values consumed straight from the accumulator and never stored
+    vector<Stub> stubs; // Edges whose copies are emitted after the program
+    vector<string> temps; // Temporaries in the order they were created
+    string write_temp; // Temporary used to write constants
+
+    // Member functions
+    void emit(const string&, const string& = ""); // Append an instruction to the program
+    void emit_label(const string&); // Attach a label to the next emitted instruction
+    string create_label(); // Create a unique label
+    string create_temp(); // Create a unique temporary variable
+
+    void assign_locations(); // Decide where each value lives
+    bool is_consumed_next(const IR_Block&, size_t, const map<size_t, size_t>&); // Check if a value can stay in the accumulator
+    bool falls_through(size_t, size_t) const; // Check if the layout lets one block fall into another
+    void load(size_t); // Bring a value into the accumulator
+    void store_result(size_t); // Save the value just computed into its location
+
+    void lower_block(size_t); // Translate a block
+    void lower_instruction(const IR_Block&, size_t); // Translate a non-terminator
+    void lower_terminator(const IR_Block&); // Translate the terminator of a block
+    bool has_copies(size_t, size_t) const; // Check if an edge carries phi copies
+    void emit_copies(size_t, size_t); // Copy the phi operands of an edge into the phis
+    void emit_branch(const string&, const string&, bool); // Emit the branch sequence for a relational operator
+};
+
+#endif // IR_LOWERING_H
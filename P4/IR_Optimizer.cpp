@@ -0,0 +1,360 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "IR_Optimizer.h"
+
+#include <algorithm>
+
+// Check if an instruction is a phi
+static bool is_phi(const IR_Instruction& instruction) {
+    return instruction.opcode == IR_PHI;
+}
+
+// Constructors
+IR_Optimizer::IR_Optimizer(IR_Module& ir_module) : module(ir_module) {}
+
+IR_Optimizer::Lattice_Value::Lattice_Value(Lattice_Kind kind, long long constant) : kind(kind), constant(constant) {}
+
+// Lattice_Value member functions
+
+bool IR_Optimizer::Lattice_Value::operator!=(const Lattice_Value& other) const {
+    return kind != other.kind || (kind == LATTICE_CONSTANT && constant != other.constant);
+}
+
+// IR_Optimizer member functions
+
+/** Sparse conditional constant propagation (Wegman and Zadeck).
+ *  Values start out unknown and only blocks reached through an executable edge are evaluated,
+ *  so a variable assigned a constant on every path control can take stays a constant even
+ *  through phis and loops. Values proven constant are rewritten as constants, branches on
+ *  constant conditions become unconditional, and the blocks no longer reached are emptied.
+ */
+void IR_Optimizer::constant_propagation() {
+    vector<IR_Block>& blocks = module.get_blocks();
+    if (blocks.empty()) { return; }
+
+    lattice.clear();
+    executable_edges.clear();
+    executable_blocks.clear();
+    users.clear();
+
+    // Index the uses of each value
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const vector<IR_Instruction>& instructions = blocks.at(b).instructions;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            const vector<size_t>& operands = instructions.at(i).operands;
+            for (size_t j = 0; j < operands.size(); ++j) {
+                users[operands.at(j)].push_back(std::make_pair(b, i));
+            }
+        }
+    }
+
+    // Control enters the entry block through an edge from outside the module
+    flow_worklist.push_back(std::make_pair(blocks.size(), 0));
+
+    while (!flow_worklist.empty() || !value_worklist.empty()) {
+        if (!flow_worklist.empty()) {
+            pair<size_t, size_t> edge = flow_worklist.back();
+            flow_worklist.pop_back();
+            if (executable_edges.count(edge)) { continue; }
+            executable_edges.insert(edge);
+
+            // A new incoming edge changes the phis; the rest of the block only needs one visit
+            const vector<IR_Instruction>& instructions = blocks.at(edge.second).instructions;
+            bool first_visit = executable_blocks.insert(edge.second).second;
+            for (size_t i = 0; i < instructions.size(); ++i) {
+                if (first_visit || instructions.at(i).opcode == IR_PHI) { visit_instruction(edge.second, i); }
+            }
+        } else {
+            size_t value = value_worklist.back();
+            value_worklist.pop_back();
+
+            const vector<pair<size_t, size_t> >& uses = users[value];
+            for (size_t i = 0; i < uses.size(); ++i) {
+                if (executable_blocks.count(uses.at(i).first)) { visit_instruction(uses.at(i).first, uses.at(i).second); }
+            }
+        }
+    }
+
+    apply_constants();
+    remove_unreachable_blocks();
+    remove_trivial_phis();
+    remove_dead_code();
+}
+
+// Get the lattice value of an SSA value
+IR_Optimizer::Lattice_Value IR_Optimizer::get_lattice_value(size_t value) const {
+    map<size_t, Lattice_Value>::const_iterator it = lattice.find(value);
+    return it == lattice.end() ? Lattice_Value() : it->second;
+}
+
+/** Evaluate an instruction on the lattice.
+ *  @param block The block holding the instruction
+ *  @param instruction The instruction
+ *  @return: the lattice value of its result; a compare yields 1 when the relation holds and 0 otherwise
+ */
+IR_Optimizer::Lattice_Value IR_Optimizer::evaluate(const IR_Block& block, const IR_Instruction& instruction) const {
+    const vector<size_t>& operands = instruction.operands;
+
+    switch (instruction.opcode) {
+    case IR_CONST:
+        return Lattice_Value(LATTICE_CONSTANT, instruction.constant);
+
+    case IR_PHI: {
+        // Meet of the operands arriving over executable edges
+        Lattice_Value result;
+        for (size_t i = 0; i < operands.size(); ++i) {
+            if (!executable_edges.count(std::make_pair(instruction.targets.at(i), block.id))) { continue; }
+
+            Lattice_Value operand = get_lattice_value(operands.at(i));
+            if (operand.kind == LATTICE_TOP) { continue; }
+            if (operand.kind == LATTICE_BOTTOM || (result.kind == LATTICE_CONSTANT && result.constant != operand.constant)) {
+                return Lattice_Value(LATTICE_BOTTOM);
+            }
+            result = operand;
+        }
+        return result;
+    }
+
+    case IR_NEG: {
+        Lattice_Value operand = get_lattice_value(operands.at(0));
+        long long result;
+        if (operand.kind != LATTICE_CONSTANT) { return operand; }
+        if (!fold(IR_SUB, 0, operand.constant, result)) { return Lattice_Value(LATTICE_BOTTOM); }
+        return Lattice_Value(LATTICE_CONSTANT, result);
+    }
+
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_DIV:
+    case IR_CMP: {
+        Lattice_Value left = get_lattice_value(operands.at(0));
+        Lattice_Value right = get_lattice_value(operands.at(1));
+        if (left.kind == LATTICE_TOP || right.kind == LATTICE_TOP) { return Lattice_Value(); }
+
+        if (left.kind == LATTICE_CONSTANT && right.kind == LATTICE_CONSTANT) {
+            long long result;
+            if (instruction.opcode == IR_CMP) {
+                // The accumulator holds (left - right) when the branch is taken
+                if (!fold(IR_SUB, left.constant, right.constant, result)) { return Lattice_Value(LATTICE_BOTTOM); }
+                return Lattice_Value(LATTICE_CONSTANT, evaluate_relation(instruction.name, result) ? 1 : 0);
+            }
+            if (!fold(instruction.opcode, left.constant, right.constant, result)) { return Lattice_Value(LATTICE_BOTTOM); }
+            return Lattice_Value(LATTICE_CONSTANT, result);
+        }
+
+        // Anything times zero is zero
+        if (instruction.opcode == IR_MUL && ((left.kind == LATTICE_CONSTANT && left.constant == 0) || (right.kind == LATTICE_CONSTANT && right.constant == 0))) {
+            return Lattice_Value(LATTICE_CONSTANT, 0);
+        }
+        return Lattice_Value(LATTICE_BOTTOM);
+    }
+
+    default:
+        // Loads, reads and anything else are only known at run time
+        return Lattice_Value(LATTICE_BOTTOM);
+    }
+}
+
+// Re-evaluate an instruction and propagate any change
+void IR_Optimizer::visit_instruction(size_t block_id, size_t index) {
+    const IR_Block& block = module.get_block(block_id);
+    const IR_Instruction& instruction = block.instructions.at(index);
+
+    if (instruction.opcode == IR_BR) {
+        mark_edge(block_id, instruction.targets.at(0));
+    } else if (instruction.opcode == IR_CBR) {
+        Lattice_Value condition = get_lattice_value(instruction.operands.at(0));
+        if (condition.kind == LATTICE_BOTTOM) {
+            mark_edge(block_id, instruction.targets.at(0));
+            mark_edge(block_id, instruction.targets.at(1));
+        } else if (condition.kind == LATTICE_CONSTANT) {
+            mark_edge(block_id, instruction.targets.at(condition.constant != 0 ? 0 : 1));
+        }
+    } else if (instruction.value != 0) {
+        Lattice_Value result = evaluate(block, instruction);
+        if (result != get_lattice_value(instruction.value)) {
+            lattice[instruction.value] = result;
+            value_worklist.push_back(instruction.value);
+        }
+    }
+}
+
+// Queue an edge that control may take
+void IR_Optimizer::mark_edge(size_t from, size_t to) {
+    if (!executable_edges.count(std::make_pair(from, to))) { flow_worklist.push_back(std::make_pair(from, to)); }
+}
+
+/** Rewrite the module with the analysis results.
+ *  Integer values proven constant become constants where they are defined, and a conditional
+ *  branch with only one executable edge becomes an unconditional branch along it.
+ */
+void IR_Optimizer::apply_constants() {
+    vector<IR_Block>& blocks = module.get_blocks();
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        if (!executable_blocks.count(b)) { continue; }
+        vector<IR_Instruction>& instructions = blocks.at(b).instructions;
+
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            IR_Instruction& instruction = instructions.at(i);
+            Lattice_Value value = get_lattice_value(instruction.value);
+
+            if (instruction.type == IR_INT && instruction.opcode != IR_CONST && value.kind == LATTICE_CONSTANT) {
+                IR_Instruction constant(IR_CONST, IR_INT);
+                constant.value = instruction.value;
+                constant.constant = value.constant;
+                instruction = constant;
+            } else if (instruction.opcode == IR_CBR) {
+                bool true_edge = executable_edges.count(std::make_pair(b, instruction.targets.at(0))) > 0;
+                bool false_edge = executable_edges.count(std::make_pair(b, instruction.targets.at(1))) > 0;
+                if (true_edge && false_edge) { continue; }
+
+                size_t taken = instruction.targets.at(true_edge ? 0 : 1);
+                size_t dropped = instruction.targets.at(true_edge ? 1 : 0);
+                if (taken != dropped) { module.remove_edge(b, dropped); }
+
+                IR_Instruction branch(IR_BR);
+                branch.targets.push_back(taken);
+                instruction = branch;
+            }
+        }
+
+        // Phis that became constants no longer belong at the top of the block
+        std::stable_partition(instructions.begin(), instructions.end(), is_phi);
+    }
+}
+
+// Empty the blocks control never reaches
+void IR_Optimizer::remove_unreachable_blocks() {
+    vector<IR_Block>& blocks = module.get_blocks();
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        if (executable_blocks.count(b)) { continue; }
+
+        vector<size_t> successors = blocks.at(b).get_successors();
+        for (size_t i = 0; i < successors.size(); ++i) {
+            module.remove_edge(b, successors.at(i));
+        }
+        blocks.at(b).instructions.clear();
+        blocks.at(b).predecessors.clear();
+    }
+}
+
+// Replace phis that merge a single value, such as those left with one predecessor
+void IR_Optimizer::remove_trivial_phis() {
+    vector<IR_Block>& blocks = module.get_blocks();
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            vector<IR_Instruction>& instructions = blocks.at(b).instructions;
+            for (size_t i = 0; i < instructions.size() && instructions.at(i).opcode == IR_PHI; ++i) {
+                const IR_Instruction& phi = instructions.at(i);
+
+                size_t same = 0;
+                bool trivial = true;
+                for (size_t j = 0; j < phi.operands.size(); ++j) {
+                    if (phi.operands.at(j) == same || phi.operands.at(j) == phi.value) { continue; }
+                    if (same != 0) { trivial = false; }
+                    same = phi.operands.at(j);
+                }
+                if (!trivial || same == 0) { continue; }
+
+                size_t value = phi.value;
+                instructions.erase(instructions.begin() + i);
+                module.replace_uses(value, same);
+                changed = true;
+                break;
+            }
+        }
+    }
+}
+
+/** Remove instructions whose values are never used.
+ *  Reads, writes, stores, branches and divisions that may divide by zero are kept for their
+ *  effects; everything they use, directly or through other instructions, is kept with them.
+ */
+void IR_Optimizer::remove_dead_code() {
+    vector<IR_Block>& blocks = module.get_blocks();
+    map<size_t, const IR_Instruction*> definitions;
+    map<size_t, long long> constants;
+    vector<size_t> worklist;
+    set<size_t> live;
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const vector<IR_Instruction>& instructions = blocks.at(b).instructions;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            const IR_Instruction& instruction = instructions.at(i);
+            if (instruction.value != 0) { definitions[instruction.value] = &instruction; }
+            if (instruction.opcode == IR_CONST) { constants[instruction.value] = instruction.constant; }
+        }
+    }
+
+    // Instructions kept for their effects
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const vector<IR_Instruction>& instructions = blocks.at(b).instructions;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            const IR_Instruction& instruction = instructions.at(i);
+            bool safe_division = instruction.opcode == IR_DIV && constants.count(instruction.operands.at(1)) && constants[instruction.operands.at(1)] != 0;
+            bool has_effect = instruction.value == 0 || instruction.opcode == IR_READ || (instruction.opcode == IR_DIV && !safe_division);
+
+            if (!has_effect) { continue; }
+            if (instruction.value != 0) { live.insert(instruction.value); }
+            worklist.insert(worklist.end(), instruction.operands.begin(), instruction.operands.end());
+        }
+    }
+
+    // Everything an effect depends on
+    while (!worklist.empty()) {
+        size_t value = worklist.back();
+        worklist.pop_back();
+        if (!live.insert(value).second) { continue; }
+
+        map<size_t, const IR_Instruction*>::const_iterator it = definitions.find(value);
+        if (it != definitions.end()) {
+            worklist.insert(worklist.end(), it->second->operands.begin(), it->second->operands.end());
+        }
+    }
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        vector<IR_Instruction>& instructions = blocks.at(b).instructions;
+        vector<IR_Instruction> kept;
+        for (size_t i = 0; i < instructions.size(); ++i) {
+            if (instructions.at(i).value == 0 || live.count(instructions.at(i).value)) { kept.push_back(instructions.at(i)); }
+        }
+        instructions.swap(kept);
+    }
+}
+
+/** Fold an operation on constants the way the target computes it.
+ *  Results that leave the range of a machine word, and division by zero, are left to run time.
+ *  @param opcode IR_ADD, IR_SUB, IR_MUL or IR_DIV
+ *  @param left The left operand
+ *  @param right The right operand
+ *  @param result Receives the folded value
+ *  @return True if the operation was folded, false otherwise
+ */
+bool IR_Optimizer::fold(IR_Opcode opcode, long long left, long long right, long long& result) {
+    if (opcode == IR_ADD) { result = left + right; }
+    else if (opcode == IR_SUB) { result = left - right; }
+    else if (opcode == IR_MUL) { result = left * right; }
+    else if (opcode == IR_DIV && right != 0) { result = left / right; }
+    else { return false; }
+
+    const long long word_limit = 2147483647LL;
+    return result <= word_limit && result >= -word_limit - 1;
+}
+
+// Evaluate a relational operator given (left - right)
+bool IR_Optimizer::evaluate_relation(const string& rel_op, long long difference) {
+    if (rel_op == ".ge.") { return difference >= 0; }
+    if (rel_op == ".le.") { return difference <= 0; }
+    if (rel_op == ".gt.") { return difference > 0; }
+    if (rel_op == ".lt.") { return difference < 0; }
+    if (rel_op == "**") { return difference == 0; }
+    return difference != 0; // ~
+}
@@ -0,0 +1,71 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef IR_OPTIMIZER_H
+#define IR_OPTIMIZER_H
+
+#include "IR.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using std::map;
+using std::pair;
+using std::set;
+using std::string;
+using std::vector;
+
+// Optimization passes over the SSA form
+class IR_Optimizer {
+public:
+    // Constructors
+    IR_Optimizer(IR_Module&);
+
+    // Member functions
+    void constant_propagation(); // Sparse conditional constant propagation
+    void remove_dead_code(); // Remove instructions whose values are never used
+
+private:
+    // What the analysis knows about a value: nothing yet, one constant, or more than one value
+    enum Lattice_Kind { LATTICE_TOP, LATTICE_CONSTANT, LATTICE_BOTTOM };
+
+    struct Lattice_Value {
+        Lattice_Kind kind;
+        long long constant; // The value when kind is LATTICE_CONSTANT
+
+        // Constructors
+        Lattice_Value(Lattice_Kind = LATTICE_TOP, long long = 0);
+
+        // Member functions
+        bool operator!=(const Lattice_Value&) const;
+    };
+
+    // Data fields
+    IR_Module& module; // The module being optimized
+
+    // Constant propagation state
+    map<size_t, Lattice_Value> lattice; // Lattice value of each SSA value, top if absent
+    set<pair<size_t, size_t> > executable_edges; // Edges control may take
+    set<size_t> executable_blocks; // Blocks control may reach
+    map<size_t, vector<pair<size_t, size_t> > > users; // Block and index of each use of a value
+    vector<pair<size_t, size_t> > flow_worklist; // Edges that just became executable
+    vector<size_t> value_worklist; // Values whose lattice value just changed
+
+    // Member functions
+    Lattice_Value get_lattice_value(size_t) const; // Get the lattice value of an SSA value
+    Lattice_Value evaluate(const IR_Block&, const IR_Instruction&) const; // Evaluate an instruction on the lattice
+    void visit_instruction(size_t, size_t); // Re-evaluate an instruction and propagate any change
+    void mark_edge(size_t, size_t); // Queue an edge that control may take
+    void apply_constants(); // Rewrite the module with the analysis results
+    void remove_unreachable_blocks(); // Empty the blocks control never reaches
+    void remove_trivial_phis(); // Replace phis that merge a single value
+
+    static bool fold(IR_Opcode, long long, long long, long long&); // Fold an operation on constants
+    static bool evaluate_relation(const string&, long long); // Evaluate a relational operator given (left - right)
+};
+
+#endif // IR_OPTIMIZER_H
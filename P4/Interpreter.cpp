@@ -0,0 +1,377 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Interpreter.h"
+
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+    // Arithmetic on 32-bit words that wraps around instead of overflowing
+    inline int32_t wrap(uint32_t value) { return static_cast<int32_t>(value); }
+}
+
+// Constructors
+Interpreter::Interpreter(const Tree& tree) : tree(tree), root(0), input(NULL), output(NULL) {}
+
+// Getters
+const string& Interpreter::get_error() const { return error; }
+
+size_t Interpreter::get_node_count() const { return nodes.size(); }
+
+const vector<string>& Interpreter::get_variables() const { return variables; }
+
+// Member functions
+
+/** Build the resolved nodes from the tree. Names are looked up here, once: every variable gets a
+ *  slot and every call the node of its func's body, which is resolved once however often it is called.
+ */
+void Interpreter::resolve() {
+    nodes.clear();
+    sequence.clear();
+    slots.clear();
+    variables.clear();
+    functions.clear();
+    resolved_functions.clear();
+
+    Tree::find_functions(tree.get_root(), functions);
+    root = resolve_statement(tree.get_root());
+}
+
+/** Run the program from its first statement with every variable at 0.
+ *  @param in Where READ takes whitespace-separated integers from
+ *  @param out Where print puts one integer per line
+ *  @return True if the program ran to its end, false on a runtime error (see get_error)
+ */
+bool Interpreter::run(FILE* in, FILE* out) {
+    if (nodes.empty()) { resolve(); }
+
+    input = in;
+    output = out;
+    error.clear();
+    memory.assign(variables.size(), 0);
+
+    bool finished = execute(root);
+    fflush(output);
+    return finished;
+}
+
+// Append a resolved node and return its index
+int32_t Interpreter::add_node(int32_t kind, int32_t value, int32_t left, int32_t right, int32_t body) {
+    Code code;
+    code.kind = kind;
+    code.value = value;
+    code.left = left;
+    code.right = right;
+    code.body = body;
+    nodes.push_back(code);
+    return static_cast<int32_t>(nodes.size() - 1);
+}
+
+// Slot of a variable, allocated on first use like the storage of the generated code
+int32_t Interpreter::slot_of(const string& name) {
+    map<string, int32_t>::const_iterator found = slots.find(name);
+    if (found != slots.end()) { return found->second; }
+
+    int32_t slot = static_cast<int32_t>(variables.size());
+    slots[name] = slot;
+    variables.push_back(name);
+    return slot;
+}
+
+/** Resolve a statement-level node.
+ *  @param node The node
+ *  @return: the index of its resolved node
+ */
+int32_t Interpreter::resolve_statement(const Node& node) {
+    const string& data = node.get_data();
+    const vector<Node>& children = node.get_children();
+
+    if (data == "<call>") {
+        const Node* body = functions[children.at(1).get_data()];
+        map<const Node*, int32_t>::const_iterator found = resolved_functions.find(body);
+        if (found != resolved_functions.end()) { return found->second; }
+
+        int32_t index = resolve_statement(*body);
+        resolved_functions[body] = index;
+        return index;
+    } else if (data == "<read>") {
+        return add_node(READ, slot_of(children.at(1).get_data()));
+    } else if (data == "<print>") {
+        return add_node(PRINT, 0, resolve_exp(children.at(1)));
+    } else if (data == "<assign>") {
+        int32_t value = resolve_exp(children.at(2));
+        return add_node(ASSIGN, slot_of(children.at(1).get_data()), value);
+    } else if (data == "<cond>") {
+        return resolve_compare(node, IF);
+    } else if (data == "<iter>") {
+        return resolve_compare(node, LOOP);
+    }
+
+    // <program>, <block>, <stats>, <mStat> and <stat> only group statements
+    vector<int32_t> statements;
+    collect_statements(node, statements);
+    if (statements.size() == 1) { return statements.at(0); }
+
+    int32_t first = static_cast<int32_t>(sequence.size());
+    sequence.insert(sequence.end(), statements.begin(), statements.end());
+    return add_node(SEQUENCE, 0, first, static_cast<int32_t>(statements.size()));
+}
+
+// Resolve the statements a grouping node holds, flattening nested groups into one list
+void Interpreter::collect_statements(const Node& node, vector<int32_t>& statements) {
+    const vector<Node>& children = node.get_children();
+
+    for (size_t i = 0; i < children.size(); ++i) {
+        const string& data = children.at(i).get_data();
+        if (data == "<vars>" || data == "<funcs>") {
+            // Storage starts at 0 whatever the declaration says, and funcs only run when called
+            continue;
+        } else if (data == "<program>" || data == "<block>" || data == "<stats>" || data == "<mStat>" || data == "<stat>") {
+            collect_statements(children.at(i), statements);
+        } else if (!data.empty() && data.at(0) == '<') {
+            statements.push_back(resolve_statement(children.at(i)));
+        }
+    }
+}
+
+/** Resolve iff or iterate [ <exp> <relational> <exp> ] <stat>.
+ *  @param node The <cond> or <iter> node
+ *  @param kind IF or LOOP
+ *  @return: the index of its resolved node
+ */
+int32_t Interpreter::resolve_compare(const Node& node, int32_t kind) {
+    const vector<Node>& children = node.get_children();
+
+    const Node& relational = children.at(3);
+    const string& rel_op = relational.get_children().empty() ? relational.get_data() : relational.get_children().at(0).get_data();
+    int32_t relation = NE; // ~
+    if (rel_op == ".ge.") { relation = GE; }
+    else if (rel_op == ".le.") { relation = LE; }
+    else if (rel_op == ".gt.") { relation = GT; }
+    else if (rel_op == ".lt.") { relation = LT; }
+    else if (rel_op == "**") { relation = EQ; }
+
+    int32_t left = resolve_exp(children.at(2));
+    int32_t right = resolve_exp(children.at(4));
+    int32_t body = resolve_statement(children.at(6));
+    return add_node(kind, relation, left, right, body);
+}
+
+// Resolve an <exp>, <M>, <N> or <R>
+int32_t Interpreter::resolve_value(const Node& node) {
+    const string& data = node.get_data();
+
+    if (data == "<exp>") { return resolve_exp(node); }
+    if (data == "<M>") { return resolve_m(node); }
+    if (data == "<N>") { return resolve_n(node); }
+    return resolve_r(node);
+}
+
+/** Resolve <M> + <exp> | <M> - <exp> | <M>. The parser flattens the operators into one list,
+ *  which groups to the right like the Generator and the Partial_Evaluator do.
+ *  @param node The <exp> node
+ *  @return: the index of its resolved node
+ */
+int32_t Interpreter::resolve_exp(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() >= 3 && (children.at(1).get_data() == "+" || children.at(1).get_data() == "-")) {
+        int32_t right;
+        if (children.size() == 3) {
+            right = resolve_m(children.at(2));
+        } else {
+            Node sub_exp("<exp>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_exp.add_child(children.at(i)); }
+            right = resolve_exp(sub_exp);
+        }
+        int32_t left = resolve_m(children.at(0));
+        return add_node(children.at(1).get_data() == "+" ? ADD : SUBTRACT, 0, left, right);
+    }
+
+    return resolve_m(children.at(0));
+}
+
+// Resolve <N> % <M> | <N>
+int32_t Interpreter::resolve_m(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() == 1) { return resolve_n(children.at(0)); }
+
+    if (children.size() >= 3 && children.at(1).get_data() == "%") {
+        int32_t right;
+        if (children.size() == 3) {
+            right = resolve_m(children.at(2));
+        } else {
+            Node sub_m("<M>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_m.add_child(children.at(i)); }
+            right = resolve_m(sub_m);
+        }
+        int32_t left = resolve_n(children.at(0));
+        return add_node(MULTIPLY, 0, left, right);
+    }
+
+    return resolve_n(node);
+}
+
+// Resolve <R> / <N> | - <N> | <R>
+int32_t Interpreter::resolve_n(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() == 1) { return resolve_r(children.at(0)); }
+
+    if (children.size() == 2 && children.at(0).get_data() == "-") {
+        return add_node(NEGATE, 0, resolve_n(children.at(1)));
+    }
+
+    int32_t right;
+    if (children.size() == 3) {
+        right = resolve_value(children.at(2));
+    } else {
+        Node sub_n("<N>");
+        for (size_t i = 2; i < children.size(); ++i) { sub_n.add_child(children.at(i)); }
+        right = resolve_n(sub_n);
+    }
+    int32_t left = resolve_r(children.at(0));
+    return add_node(DIVIDE, 0, left, right);
+}
+
+// Resolve ( <exp> ) | identifier | integer
+int32_t Interpreter::resolve_r(const Node& node) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() == 1) {
+        const string& data = children.at(0).get_data();
+        if (!data.empty() && isdigit(data.at(0))) {
+            // Wrapped to a word, as the assembler does with an immediate
+            return add_node(CONSTANT, wrap(static_cast<uint32_t>(strtoull(data.c_str(), NULL, 10))));
+        }
+        return add_node(VARIABLE, slot_of(data));
+    }
+
+    if (children.size() == 3 && children.at(0).get_data() == "(") { return resolve_exp(children.at(1)); }
+
+    Node exp("<exp>");
+    for (size_t i = 0; i < children.size(); ++i) { exp.add_child(children.at(i)); }
+    return resolve_exp(exp);
+}
+
+// Run a statement
+bool Interpreter::execute(int32_t index) {
+    const Code& code = nodes[index];
+
+    switch (code.kind) {
+    case READ:
+        return read_word(memory[code.value]);
+    case PRINT: {
+        int32_t value;
+        if (!evaluate(code.left, value)) { return false; }
+        fprintf(output, "%ld\n", static_cast<long>(value));
+        return true;
+    }
+    case ASSIGN:
+        return evaluate(code.left, memory[code.value]);
+    case IF: {
+        bool taken;
+        if (!holds(code, taken)) { return false; }
+        return !taken || execute(code.body);
+    }
+    case LOOP:
+        while (true) {
+            bool taken;
+            if (!holds(code, taken)) { return false; }
+            if (!taken) { return true; }
+            if (!execute(code.body)) { return false; }
+        }
+    default: // SEQUENCE
+        for (int32_t i = 0; i < code.right; ++i) {
+            if (!execute(sequence[code.left + i])) { return false; }
+        }
+        return true;
+    }
+}
+
+/** Evaluate an expression the way the target computes it.
+ *  @param index The expression
+ *  @param value Receives its value
+ *  @return True if it was evaluated, false on a division by zero
+ */
+bool Interpreter::evaluate(int32_t index, int32_t& value) {
+    const Code& code = nodes[index];
+    int32_t left, right;
+
+    switch (code.kind) {
+    case CONSTANT:
+        value = code.value;
+        return true;
+    case VARIABLE:
+        value = memory[code.value];
+        return true;
+    case NEGATE:
+        if (!evaluate(code.left, left)) { return false; }
+        value = wrap(0u - static_cast<uint32_t>(left));
+        return true;
+    default:
+        break;
+    }
+
+    if (!evaluate(code.left, left) || !evaluate(code.right, right)) { return false; }
+
+    switch (code.kind) {
+    case ADD: value = wrap(static_cast<uint32_t>(left) + static_cast<uint32_t>(right)); return true;
+    case SUBTRACT: value = wrap(static_cast<uint32_t>(left) - static_cast<uint32_t>(right)); return true;
+    case MULTIPLY: value = wrap(static_cast<uint32_t>(left) * static_cast<uint32_t>(right)); return true;
+    default: // DIVIDE, truncating toward zero; the one quotient that does not fit wraps around
+        if (right == 0) { return fail("division by zero"); }
+        value = right == -1 ? wrap(0u - static_cast<uint32_t>(left)) : left / right;
+        return true;
+    }
+}
+
+// Evaluate the comparison of an IF or a LOOP by the sign of (left - right)
+bool Interpreter::holds(const Code& code, bool& taken) {
+    int32_t left, right;
+    if (!evaluate(code.left, left) || !evaluate(code.right, right)) { return false; }
+
+    int32_t difference = wrap(static_cast<uint32_t>(left) - static_cast<uint32_t>(right));
+    switch (code.value) {
+    case GE: taken = difference >= 0; break;
+    case LE: taken = difference <= 0; break;
+    case GT: taken = difference > 0; break;
+    case LT: taken = difference < 0; break;
+    case EQ: taken = difference == 0; break;
+    default: taken = difference != 0; break;
+    }
+    return true;
+}
+
+/** Parse the next whitespace-separated integer of the input, like the Virtual_Machine's READ.
+ *  @param value Receives the integer, wrapped to a word
+ *  @return True if an integer was read, false at the end of the input or on anything else
+ */
+bool Interpreter::read_word(int32_t& value) {
+    int c = getc(input);
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') { c = getc(input); }
+    if (c == EOF) { return fail("READ past the end of the input"); }
+
+    bool negative = c == '-';
+    if (c == '-' || c == '+') { c = getc(input); }
+    if (c < '0' || c > '9') { return fail("READ found something other than an integer"); }
+
+    uint32_t magnitude = 0;
+    while (c >= '0' && c <= '9') {
+        magnitude = magnitude * 10 + static_cast<uint32_t>(c - '0');
+        c = getc(input);
+    }
+    if (c != EOF) { ungetc(c, input); } // Leave the delimiter for the next READ
+
+    value = wrap(negative ? 0u - magnitude : magnitude);
+    return true;
+}
+
+// Record why the run failed
+bool Interpreter::fail(const string& reason) {
+    error = reason;
+    return false;
+}
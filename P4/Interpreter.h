@@ -0,0 +1,89 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "Tree.h"
+
+#include <cstdio>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::string;
+using std::vector;
+
+// Runs a checked parse tree directly, without generating code. The tree is first resolved into a
+// compact array of nodes in which variables are slots and calls point at the body of their func;
+// running it computes what the generated code would, with 32-bit words that wrap around.
+class Interpreter {
+public:
+    // Constructors
+    Interpreter(const Tree&);
+
+    // Getters
+    const string& get_error() const;
+    size_t get_node_count() const; // Number of resolved nodes
+    const vector<string>& get_variables() const; // Name of each slot
+
+    // Member functions
+    void resolve(); // Build the resolved nodes from the tree
+    bool run(FILE*, FILE*); // Run the program, false with get_error set on a runtime error
+
+private:
+    // Kinds of resolved nodes
+    enum Kind {
+        CONSTANT, VARIABLE, ADD, SUBTRACT, MULTIPLY, DIVIDE, NEGATE, // Expressions
+        READ, PRINT, ASSIGN, IF, LOOP, SEQUENCE // Statements
+    };
+
+    // Relational operators, decided by the sign of (left - right) like the generated code
+    enum Relation { GE, LE, GT, LT, EQ, NE };
+
+    // One resolved node; which fields are used depends on the kind
+    struct Code {
+        int32_t kind; // A Kind
+        int32_t value; // Constant, slot of a variable or a Relation
+        int32_t left; // First operand: an expression, or the first child of a SEQUENCE in sequence
+        int32_t right; // Second operand, or the number of children of a SEQUENCE
+        int32_t body; // Statement run by an IF or a LOOP
+    };
+
+    // Data fields
+    const Tree& tree; // The parse tree to run
+    vector<Code> nodes; // The resolved program
+    int32_t root; // Node of the whole program
+    vector<int32_t> sequence; // Children of every SEQUENCE, each a node index
+    map<string, int32_t> slots; // Slot of each variable
+    vector<string> variables; // Name of each slot
+    map<string, const Node*> functions; // The <block> of each func, by name
+    map<const Node*, int32_t> resolved_functions; // Node of each func body resolved so far
+    vector<int32_t> memory; // Value of each slot while running
+    FILE* input; // Where READ takes its numbers from
+    FILE* output; // Where print puts its numbers
+    string error; // Why the last run failed
+
+    // Member functions
+    int32_t add_node(int32_t, int32_t = 0, int32_t = 0, int32_t = 0, int32_t = 0); // Append a resolved node
+    int32_t slot_of(const string&); // Slot of a variable, allocated on first use
+    int32_t resolve_statement(const Node&); // Resolve a statement-level node
+    void collect_statements(const Node&, vector<int32_t>&); // Resolve the statements a node groups
+    int32_t resolve_compare(const Node&, int32_t); // Resolve the [ <exp> <relational> <exp> ] <stat> of an iff or iterate
+    int32_t resolve_value(const Node&); // Resolve an <exp>, <M>, <N> or <R>
+    int32_t resolve_exp(const Node&); // Resolve an <exp>
+    int32_t resolve_m(const Node&); // Resolve an <M>
+    int32_t resolve_n(const Node&); // Resolve an <N>
+    int32_t resolve_r(const Node&); // Resolve an <R>
+
+    bool execute(int32_t); // Run a statement
+    bool evaluate(int32_t, int32_t&); // Evaluate an expression
+    bool holds(const Code&, bool&); // Evaluate the comparison of an IF or a LOOP
+    bool read_word(int32_t&); // Parse the next integer of the input
+    bool fail(const string&); // Record why the run failed
+};
+
+#endif // INTERPRETER_H
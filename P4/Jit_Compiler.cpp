@@ -0,0 +1,250 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Jit_Compiler.h"
+#include "Virtual_Machine.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define JIT_SUPPORTED
+#endif
+
+namespace {
+    // Registers in the reg or r/m field of a ModRM byte
+    const unsigned char ECX = 1, EBX = 3, ESI = 6;
+
+    // Second byte of the 0F 8x jcc rel32 of each conditional branch, taken on the flags of test ebx, ebx
+    unsigned char condition_of(int32_t opcode) {
+        switch (opcode) {
+        case VM_BRNEG: return 0x8C; // jl
+        case VM_BRZNEG: return 0x8E; // jle
+        case VM_BRPOS: return 0x8F; // jg
+        case VM_BRZPOS: return 0x8D; // jge
+        default: return 0x84; // je
+        }
+    }
+}
+
+// Constructors
+Jit_Compiler::Jit_Compiler() : buffer(NULL), buffer_size(0) {}
+
+Jit_Compiler::~Jit_Compiler() { release(); }
+
+// Getters
+Jit_Compiler::Entry Jit_Compiler::get_entry() const { return reinterpret_cast<Entry>(buffer); }
+
+size_t Jit_Compiler::get_code_size() const { return code.size(); }
+
+const string& Jit_Compiler::get_error() const { return error; }
+
+// Member functions
+
+// Check if this build can run machine code it emits
+bool Jit_Compiler::is_supported() {
+#ifdef JIT_SUPPORTED
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Record why compilation failed
+bool Jit_Compiler::fail(const string& reason) {
+    error = reason;
+    return false;
+}
+
+/** Compile bytecode into machine code. Every instruction becomes a short fixed sequence at a known
+ *  offset, so branches are emitted with a placeholder and patched once every offset is known.
+ *  The code is written into a writable mapping that is then made executable and read-only.
+ *  @param bytecode The instructions, the last being VM_END
+ *  @param read Called by READ with the context and the address of the variable
+ *  @param write Called by WRITE with the context and the value
+ *  @return True if the code was compiled, false otherwise (see get_error)
+ */
+bool Jit_Compiler::compile(const vector<Vm_Instruction>& bytecode, Read_Function read, Write_Function write) {
+    release();
+    code.clear();
+    fixups.clear();
+    error.clear();
+
+    if (!is_supported()) { return fail("the JIT needs x86-64 Linux"); }
+
+    size_t count = bytecode.size();
+    vector<size_t> offsets(count + 4, 0); // Offset of each instruction, then of each exit stub
+
+    // Prologue: save the callee-saved registers used, which also aligns the stack for calls
+    emit(0x53); // push rbx
+    emit(0x55); // push rbp
+    emit(0x41, 0x54); // push r12
+    emit(0x48, 0x89); emit(0xFD); // mov rbp, rdi
+    emit(0x49, 0x89); emit(0xF4); // mov r12, rsi
+    emit(0x31, 0xDB); // xor ebx, ebx
+
+    for (size_t i = 0; i < count; ++i) {
+        offsets.at(i) = code.size();
+        int32_t operand = bytecode.at(i).operand;
+
+        switch (bytecode.at(i).opcode) {
+        case VM_LOAD: emit_variable(0x8B, EBX, operand); break; // mov ebx, [var]
+        case VM_LOAD_I: emit(0xBB); emit_word(operand); break; // mov ebx, imm32
+        case VM_STORE: emit_variable(0x89, EBX, operand); break; // mov [var], ebx
+        case VM_ADD: emit_variable(0x03, EBX, operand); break; // add ebx, [var]
+        case VM_ADD_I: emit(0x81, 0xC3); emit_word(operand); break; // add ebx, imm32
+        case VM_SUB: emit_variable(0x2B, EBX, operand); break; // sub ebx, [var]
+        case VM_SUB_I: emit(0x81, 0xEB); emit_word(operand); break; // sub ebx, imm32
+        case VM_MULT: emit(0x0F); emit_variable(0xAF, EBX, operand); break; // imul ebx, [var]
+        case VM_MULT_I: emit(0x69, 0xDB); emit_word(operand); break; // imul ebx, ebx, imm32
+        case VM_DIV:
+            emit_variable(0x8B, ECX, operand); // mov ecx, [var]
+            emit_divide(count + JIT_DIVISION_BY_ZERO);
+            break;
+        case VM_DIV_I:
+            emit(0xB9); emit_word(operand); // mov ecx, imm32
+            emit_divide(count + JIT_DIVISION_BY_ZERO);
+            break;
+        case VM_READ:
+            emit(0x4C, 0x89); emit(0xE7); // mov rdi, r12
+            emit(0x48); emit_variable(0x8D, ESI, operand); // lea rsi, [var]
+            emit_address(reinterpret_cast<const void*>(read));
+            emit(0xFF, 0xD0); // call rax
+            emit(0x85, 0xC0); // test eax, eax
+            emit_jump(0x84, count + JIT_IO_ERROR); // jz
+            break;
+        case VM_WRITE:
+        case VM_WRITE_I:
+            emit(0x4C, 0x89); emit(0xE7); // mov rdi, r12
+            if (bytecode.at(i).opcode == VM_WRITE) { emit_variable(0x8B, ESI, operand); } // mov esi, [var]
+            else { emit(0xBE); emit_word(operand); } // mov esi, imm32
+            emit_address(reinterpret_cast<const void*>(write));
+            emit(0xFF, 0xD0); // call rax
+            break;
+        case VM_BR: emit_jump(0, static_cast<size_t>(operand)); break;
+        case VM_BRNEG: case VM_BRZNEG: case VM_BRPOS: case VM_BRZPOS: case VM_BRZERO:
+            emit(0x85, 0xDB); // test ebx, ebx
+            emit_jump(condition_of(bytecode.at(i).opcode), static_cast<size_t>(operand));
+            break;
+        case VM_NOOP: break;
+        case VM_STOP: emit_jump(0, count + JIT_STOP); break;
+        case VM_END: emit_jump(0, count + JIT_FELL_OFF); break;
+        default: return fail("cannot compile a superinstruction");
+        }
+    }
+
+    // Exit stubs: the Exit in eax, then the epilogue
+    size_t epilogue_jumps[JIT_FELL_OFF + 1];
+    for (int stub = JIT_STOP; stub <= JIT_FELL_OFF; ++stub) {
+        offsets.at(count + stub) = code.size();
+        emit(0xB8); emit_word(stub); // mov eax, stub
+        epilogue_jumps[stub] = code.size();
+        emit(0xEB, 0x00); // jmp short to the epilogue, patched below
+    }
+    size_t epilogue = code.size();
+    emit(0x41, 0x5C); // pop r12
+    emit(0x5D); // pop rbp
+    emit(0x5B); // pop rbx
+    emit(0xC3); // ret
+    for (int stub = JIT_STOP; stub <= JIT_FELL_OFF; ++stub) {
+        code.at(epilogue_jumps[stub] + 1) = static_cast<unsigned char>(epilogue - (epilogue_jumps[stub] + 2));
+    }
+
+    for (size_t i = 0; i < fixups.size(); ++i) {
+        const Fixup& fixup = fixups.at(i);
+        if (fixup.target >= offsets.size()) { return fail("branch outside the program"); }
+        int32_t relative = static_cast<int32_t>(static_cast<long long>(offsets.at(fixup.target)) - static_cast<long long>(fixup.position + 4));
+        std::memcpy(&code.at(fixup.position), &relative, sizeof(relative));
+    }
+
+#ifdef JIT_SUPPORTED
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t size = (code.size() + page - 1) / page * page;
+    void* mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) { return fail("cannot map memory for the machine code"); }
+
+    std::memcpy(mapped, &code.at(0), code.size());
+    if (mprotect(mapped, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(mapped, size);
+        return fail("cannot make the machine code executable");
+    }
+    buffer = mapped;
+    buffer_size = size;
+#endif
+    return true;
+}
+
+// Append a byte
+void Jit_Compiler::emit(unsigned char byte) { code.push_back(byte); }
+
+// Append two bytes
+void Jit_Compiler::emit(unsigned char first, unsigned char second) {
+    code.push_back(first);
+    code.push_back(second);
+}
+
+// Append a little-endian 32-bit word
+void Jit_Compiler::emit_word(int32_t word) {
+    uint32_t bits = static_cast<uint32_t>(word);
+    for (int i = 0; i < 4; ++i) { code.push_back(static_cast<unsigned char>(bits >> (8 * i))); }
+}
+
+// Load a 64-bit address into rax
+void Jit_Compiler::emit_address(const void* address) {
+    uint64_t bits = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(address));
+    emit(0x48, 0xB8); // mov rax, imm64
+    for (int i = 0; i < 8; ++i) { code.push_back(static_cast<unsigned char>(bits >> (8 * i))); }
+}
+
+/** Append an opcode whose memory operand is a variable: ModRM mod 10 and r/m rbp, then disp32.
+ *  @param opcode The last opcode byte
+ *  @param reg The register in the reg field
+ *  @param variable The address of the variable, scaled to bytes here
+ */
+void Jit_Compiler::emit_variable(unsigned char opcode, unsigned char reg, int32_t variable) {
+    emit(opcode, static_cast<unsigned char>(0x80 | (reg << 3) | 0x05));
+    emit_word(variable * 4);
+}
+
+/** Append a jump whose rel32 is patched later.
+ *  @param condition 0 for jmp, otherwise the second byte of 0F 8x jcc
+ *  @param target Instruction index or exit stub to jump to
+ */
+void Jit_Compiler::emit_jump(unsigned char condition, size_t target) {
+    if (condition == 0) { emit(0xE9); }
+    else { emit(0x0F, condition); }
+
+    Fixup fixup;
+    fixup.position = code.size();
+    fixup.target = target;
+    fixups.push_back(fixup);
+    emit_word(0);
+}
+
+/** Divide ebx by ecx, truncating toward zero like the Virtual_Machine: a zero divisor exits, and
+ *  -1 negates instead, since idiv faults on the one quotient that does not fit.
+ *  @param division_stub The exit stub for a division by zero
+ */
+void Jit_Compiler::emit_divide(size_t division_stub) {
+    emit(0x85, 0xC9); // test ecx, ecx
+    emit_jump(0x84, division_stub); // jz
+    emit(0x83, 0xF9); emit(0xFF); // cmp ecx, -1
+    emit(0x75, 0x04); // jne to the idiv
+    emit(0xF7, 0xDB); // neg ebx
+    emit(0xEB, 0x07); // jmp past the idiv
+    emit(0x89, 0xD8); // mov eax, ebx
+    emit(0x99); // cdq
+    emit(0xF7, 0xF9); // idiv ecx
+    emit(0x89, 0xC3); // mov ebx, eax
+}
+
+// Unmap the executable buffer
+void Jit_Compiler::release() {
+#ifdef JIT_SUPPORTED
+    if (buffer != NULL) { munmap(buffer, buffer_size); }
+#endif
+    buffer = NULL;
+    buffer_size = 0;
+}
@@ -0,0 +1,75 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef JIT_COMPILER_H
+#define JIT_COMPILER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+struct Vm_Instruction;
+
+// Translates the bytecode of the Virtual_Machine into x86-64 machine code in an executable buffer.
+// The accumulator lives in ebx and the variables in a block of words rbp points to; READ and WRITE
+// call back into the caller. Only x86-64 Linux is supported, see is_supported.
+class Jit_Compiler {
+public:
+    // How the machine code returned
+    enum Exit {
+        JIT_STOP, // Reached STOP
+        JIT_IO_ERROR, // The read callback failed
+        JIT_DIVISION_BY_ZERO,
+        JIT_FELL_OFF // Control fell off the end of the program
+    };
+
+    typedef int (*Read_Function)(void*, int32_t*); // Reads a word, 0 on failure
+    typedef void (*Write_Function)(void*, int32_t); // Writes a word
+    typedef int (*Entry)(int32_t*, void*); // Runs the code on the variables with the context of the callbacks, returns an Exit
+
+    // Constructors
+    Jit_Compiler();
+    ~Jit_Compiler();
+
+    // Getters
+    Entry get_entry() const; // The compiled code, NULL if none
+    size_t get_code_size() const; // Number of bytes of machine code
+    const string& get_error() const;
+
+    // Member functions
+    static bool is_supported(); // Check if this build can run machine code it emits
+    bool compile(const vector<Vm_Instruction>&, Read_Function, Write_Function); // Compile bytecode ending with VM_END
+
+private:
+    // A rel32 to fill in once every target has an address
+    struct Fixup {
+        size_t position; // Offset of the rel32 in the code
+        size_t target; // Instruction index, or the number of instructions plus an Exit for an exit stub
+    };
+
+    // Data fields
+    vector<unsigned char> code; // The machine code being emitted
+    vector<Fixup> fixups; // Jumps to patch
+    void* buffer; // The executable copy of the code, NULL if none
+    size_t buffer_size; // Number of bytes mapped
+    string error; // Why the last compilation failed
+
+    // Member functions
+    Jit_Compiler(const Jit_Compiler&); // Not copyable, it owns a mapping
+    Jit_Compiler& operator=(const Jit_Compiler&);
+    void emit(unsigned char); // Append a byte
+    void emit(unsigned char, unsigned char); // Append two bytes
+    void emit_word(int32_t); // Append a little-endian 32-bit word
+    void emit_address(const void*); // Load a 64-bit address into rax
+    void emit_variable(unsigned char, unsigned char, int32_t); // Append an opcode with a [rbp + 4 * variable] operand
+    void emit_jump(unsigned char, size_t); // Append a rel32 jump, 0 for JMP or the second byte of a Jcc
+    void emit_divide(size_t); // Divide ebx by ecx, exiting to a stub on a zero divisor
+    void release(); // Unmap the executable buffer
+    bool fail(const string&); // Record why compilation failed
+};
+
+#endif // JIT_COMPILER_H
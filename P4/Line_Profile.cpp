@@ -0,0 +1,148 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Line_Profile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+using std::ifstream;
+using std::map;
+using std::ostringstream;
+using std::setw;
+
+// Constructors
+Line_Profile::Line_Profile(const Virtual_Machine& machine, const Source_Map& source_map) : machine(machine), source_map(source_map) {}
+
+// Member functions
+
+/** Read the source file so the report shows the text of each line.
+ *  @param file The source file
+ *  @return True if it was read, false otherwise
+ */
+bool Line_Profile::load_source(const string& file) {
+    source.clear();
+    ifstream fin(file.c_str());
+    if (!fin.is_open()) { return false; }
+
+    string text;
+    while (getline(fin, text)) {
+        size_t start = text.find_first_not_of(" \t");
+        source.push_back(start == string::npos ? "" : text.substr(start));
+    }
+    return true;
+}
+
+// Order lines by cost, then by number
+bool Line_Profile::is_costlier(const Line_Cost& left, const Line_Cost& right) {
+    if (left.instructions != right.instructions) { return left.instructions > right.instructions; }
+    return left.line < right.line;
+}
+
+// Counts of every line that ran, costliest first
+vector<Line_Profile::Line_Cost> Line_Profile::get_line_costs() const {
+    const vector<Vm_Instruction>& code = machine.get_code();
+    const vector<unsigned long long>& executions = machine.get_executions();
+    const vector<unsigned long long>& taken = machine.get_branches_taken();
+
+    map<size_t, Line_Cost> by_line;
+    for (size_t i = 0; i < executions.size(); ++i) {
+        if (executions.at(i) == 0) { continue; }
+
+        size_t line = source_map.get_line(i);
+        if (by_line.count(line) == 0) {
+            Line_Cost cost = { line, 0, 0, 0 };
+            by_line[line] = cost;
+        }
+        Line_Cost& cost = by_line[line];
+        cost.instructions += executions.at(i);
+        if (code.at(i).opcode >= VM_BRNEG && code.at(i).opcode <= VM_BRZERO) {
+            cost.branches += executions.at(i);
+            cost.taken += taken.at(i);
+        }
+    }
+
+    vector<Line_Cost> costs;
+    for (map<size_t, Line_Cost>::const_iterator it = by_line.begin(); it != by_line.end(); ++it) { costs.push_back(it->second); }
+    std::stable_sort(costs.begin(), costs.end(), is_costlier);
+    return costs;
+}
+
+/** Report the source lines by the number of instructions they ran. A line's share is of every
+ *  instruction run; its branches are the conditional ones, with how many were taken.
+ *  @return: a table with one row per line that ran
+ */
+string Line_Profile::report() const {
+    vector<Line_Cost> costs = get_line_costs();
+    unsigned long long total = 0;
+    unsigned long long branches = 0;
+    unsigned long long taken = 0;
+    for (size_t i = 0; i < costs.size(); ++i) {
+        total += costs.at(i).instructions;
+        branches += costs.at(i).branches;
+        taken += costs.at(i).taken;
+    }
+
+    ostringstream oss;
+    oss << std::left << setw(8) << "line" << std::right << setw(14) << "instructions" << setw(9) << "share"
+        << setw(12) << "branches" << setw(12) << "taken" << "  source\n";
+    for (size_t i = 0; i < costs.size(); ++i) {
+        const Line_Cost& cost = costs.at(i);
+        ostringstream line;
+        if (cost.line == 0) { line << "?"; }
+        else { line << cost.line; }
+        ostringstream share;
+        share << std::fixed << std::setprecision(1) << (total == 0 ? 0.0 : 100.0 * cost.instructions / total) << "%";
+
+        oss << std::left << setw(8) << line.str() << std::right << setw(14) << cost.instructions << setw(9) << share.str()
+            << setw(12) << cost.branches << setw(12) << cost.taken;
+        if (cost.line > 0 && cost.line <= source.size()) { oss << "  " << source.at(cost.line - 1); }
+        oss << "\n";
+    }
+    oss << "total: " << total << " instructions, " << branches << " conditional branches (" << taken << " taken)\n";
+    return oss.str();
+}
+
+/** Convert the counts to folded stacks, one per instruction that ran: the root frame, the source
+ *  line, then the instruction, followed by the number of times it ran.
+ *  @param root The name of the root frame, e.g. the program
+ *  @return: the folded stacks, one per line
+ */
+string Line_Profile::folded(const string& root) const {
+    const vector<unsigned long long>& executions = machine.get_executions();
+    ostringstream oss;
+    for (size_t i = 0; i < executions.size(); ++i) {
+        if (executions.at(i) == 0) { continue; }
+
+        size_t line = source_map.get_line(i);
+        oss << root << ";line ";
+        if (line == 0) { oss << "?"; }
+        else { oss << line; }
+        oss << ";" << describe(i) << " " << executions.at(i) << "\n";
+    }
+    return oss.str();
+}
+
+// An instruction as "index OPCODE operand"
+string Line_Profile::describe(size_t index) const {
+    const Vm_Instruction& instruction = machine.get_code().at(index);
+    const vector<string>& variables = machine.get_variables();
+    ostringstream oss;
+    oss << index << " " << Virtual_Machine::get_opcode_name(instruction.opcode);
+
+    switch (instruction.opcode) {
+    case VM_LOAD: case VM_STORE: case VM_ADD: case VM_SUB: case VM_MULT: case VM_DIV: case VM_READ: case VM_WRITE:
+        if (instruction.operand >= 0 && static_cast<size_t>(instruction.operand) < variables.size()) { oss << " " << variables.at(instruction.operand); }
+        break;
+    case VM_NOOP: case VM_STOP: case VM_END:
+        break;
+    default: // An integer or a branch target
+        oss << " " << instruction.operand;
+        break;
+    }
+    return oss.str();
+}
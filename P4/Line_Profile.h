@@ -0,0 +1,50 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef LINE_PROFILE_H
+#define LINE_PROFILE_H
+
+#include "Source_Map.h"
+#include "Virtual_Machine.h"
+
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// Folds the counters of a profiled Virtual_Machine run back onto source lines through a Source_Map:
+// a report of the lines by the number of instructions they ran, and the same counts as folded stacks
+// ("program;line n;instruction count") that flamegraph.pl and speedscope read.
+class Line_Profile {
+public:
+    // Constructors
+    Line_Profile(const Virtual_Machine&, const Source_Map&);
+
+    // Member functions
+    bool load_source(const string&); // Read the source so the report shows the text of each line
+    string report() const; // One row per source line, costliest first
+    string folded(const string&) const; // One folded stack per instruction that ran, under a root frame
+
+private:
+    // The counts of one source line
+    struct Line_Cost {
+        size_t line; // Source line, 0 for instructions the map does not know
+        unsigned long long instructions; // Instructions it ran
+        unsigned long long branches; // Conditional branches it ran
+        unsigned long long taken; // Conditional branches it took
+    };
+
+    // Data fields
+    const Virtual_Machine& machine; // The profiled run
+    const Source_Map& source_map; // Line of each instruction
+    vector<string> source; // Text of each source line, empty if not loaded
+
+    // Member functions
+    vector<Line_Cost> get_line_costs() const; // Counts of every line that ran, costliest first
+    static bool is_costlier(const Line_Cost&, const Line_Cost&); // Order lines by cost, then by number
+    string describe(size_t) const; // An instruction as "index OPCODE operand"
+};
+
+#endif // LINE_PROFILE_H
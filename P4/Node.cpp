@@ -12,7 +12,7 @@ string Node::get_data() const {
 	return data;
 }
 
-vector<Node> Node::get_children() const {
+const vector<Node>& Node::get_children() const {
 	return children;
 }
 
@@ -22,7 +22,7 @@ public:
 
 	// Getters
 	string get_data() const;
-	vector<Node> get_children() const;
+	const vector<Node>& get_children() const;
 	size_t get_line_number() const;
 
 
@@ -0,0 +1,296 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Object_File.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define OBJECT_FILE_MMAP
+#endif
+
+using std::ifstream;
+using std::map;
+using std::ofstream;
+using std::ostringstream;
+
+const uint32_t Object_File::version = 1;
+
+namespace {
+    const char magic[4] = { 'P', '4', 'O', 'B' };
+
+    // The instruction section is the bytecode itself, so its layout must not depend on the compiler
+    typedef char instruction_is_two_words[sizeof(Vm_Instruction) == 8 ? 1 : -1];
+
+    // Round a byte count up to a whole number of words
+    size_t align(size_t offset) { return (offset + 3) & ~static_cast<size_t>(3); }
+
+    bool is_branch(int32_t opcode) { return opcode >= VM_BR && opcode <= VM_BRZERO; }
+
+    // Opcodes whose operand is the address of a variable
+    bool takes_variable(int32_t opcode) {
+        switch (opcode) {
+        case VM_LOAD: case VM_STORE: case VM_ADD: case VM_SUB: case VM_MULT: case VM_DIV: case VM_READ: case VM_WRITE:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+// Constructors
+Object_File::Object_File() : mapping(NULL), mapping_size(0), bytes(NULL), size(0) {}
+
+Object_File::~Object_File() { release(); }
+
+// Getters
+const Object_Header& Object_File::get_header() const { return *reinterpret_cast<const Object_Header*>(bytes); }
+
+const Vm_Instruction* Object_File::get_instructions() const {
+    return reinterpret_cast<const Vm_Instruction*>(bytes + get_header().instruction_offset);
+}
+
+size_t Object_File::get_instruction_count() const { return bytes == NULL ? 0 : get_header().instruction_count; }
+
+const int32_t* Object_File::get_initial_values() const {
+    return reinterpret_cast<const int32_t*>(bytes + get_header().data_offset);
+}
+
+size_t Object_File::get_variable_count() const { return bytes == NULL ? 0 : get_header().variable_count; }
+
+vector<string> Object_File::get_variable_names() const {
+    vector<string> names;
+    if (bytes == NULL) { return names; }
+
+    const char* name = bytes + get_header().names_offset;
+    for (size_t i = 0; i < get_variable_count(); ++i) {
+        names.push_back(name);
+        name += names.back().size() + 1;
+    }
+    return names;
+}
+
+const string& Object_File::get_error() const { return error; }
+
+// Member functions
+
+// Record why assembly or a load failed
+bool Object_File::fail(const string& reason) {
+    error = reason;
+    return false;
+}
+
+/** Build the object from .asm text with the assembler of the Virtual_Machine.
+ *  @param text The assembly
+ *  @return True if the text was assembled, false otherwise (see get_error)
+ */
+bool Object_File::assemble(const string& text) {
+    release();
+
+    Virtual_Machine machine;
+    machine.set_superinstructions(false); // Superinstructions are chosen again when the object is run
+    if (!machine.assemble(text)) { return fail(machine.get_error()); }
+
+    const vector<Vm_Instruction>& code = machine.get_code();
+    const vector<int32_t>& values = machine.get_initial_memory();
+    const vector<string>& names = machine.get_variables();
+    size_t instruction_count = code.size() - 1; // Without VM_END
+
+    string name_bytes;
+    for (size_t i = 0; i < names.size(); ++i) { name_bytes += names.at(i) + '\0'; }
+
+    Object_Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.instruction_count = static_cast<uint32_t>(instruction_count);
+    header.variable_count = static_cast<uint32_t>(values.size());
+    header.instruction_offset = static_cast<uint32_t>(sizeof(Object_Header));
+    header.data_offset = static_cast<uint32_t>(header.instruction_offset + instruction_count * sizeof(Vm_Instruction));
+    header.names_offset = static_cast<uint32_t>(header.data_offset + values.size() * sizeof(int32_t));
+    header.names_size = static_cast<uint32_t>(name_bytes.size());
+
+    image.assign(align(header.names_offset + name_bytes.size()), '\0');
+    std::memcpy(&image.at(0), &header, sizeof(header));
+    if (instruction_count > 0) { std::memcpy(&image.at(header.instruction_offset), &code.at(0), instruction_count * sizeof(Vm_Instruction)); }
+    if (!values.empty()) { std::memcpy(&image.at(header.data_offset), &values.at(0), values.size() * sizeof(int32_t)); }
+    if (!name_bytes.empty()) { std::memcpy(&image.at(header.names_offset), name_bytes.data(), name_bytes.size()); }
+
+    bytes = &image.at(0);
+    size = image.size();
+    return true;
+}
+
+// Write the object to a file
+bool Object_File::write(const string& file) const {
+    if (bytes == NULL) { return false; }
+
+    ofstream fout(file.c_str(), std::ios::binary);
+    fout.write(bytes, static_cast<std::streamsize>(size));
+    return static_cast<bool>(fout);
+}
+
+/** Map an object file into memory and check it. Nothing is parsed: the instructions and initial
+ *  values are used in place, and checking them is one pass over the operands.
+ *  @param file The object file
+ *  @return True if the file is a valid object, false otherwise (see get_error)
+ */
+bool Object_File::load(const string& file) {
+    release();
+
+#ifdef OBJECT_FILE_MMAP
+    int descriptor = open(file.c_str(), O_RDONLY);
+    if (descriptor < 0) { return fail("cannot open " + file); }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+        close(descriptor);
+        return fail(file + " is not an object file");
+    }
+
+    void* mapped = mmap(NULL, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor); // The mapping keeps the file
+    if (mapped == MAP_FAILED) { return fail("cannot map " + file); }
+
+    mapping = mapped;
+    mapping_size = static_cast<size_t>(status.st_size);
+    bytes = static_cast<const char*>(mapped);
+    size = mapping_size;
+#else
+    ifstream fin(file.c_str(), std::ios::binary);
+    if (!fin.is_open()) { return fail("cannot open " + file); }
+    image.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    if (image.empty()) { return fail(file + " is not an object file"); }
+    bytes = &image.at(0);
+    size = image.size();
+#endif
+
+    if (!check()) {
+        string reason = error;
+        release();
+        return fail(file + ": " + reason);
+    }
+    return true;
+}
+
+/** Check the header and every operand of the object, so running it never reads outside the
+ *  instructions or the variables.
+ *  @return True if the object is valid, false otherwise (see get_error)
+ */
+bool Object_File::check() {
+    if (size < sizeof(Object_Header) || std::memcmp(bytes, magic, sizeof(magic)) != 0) { return fail("not an object file"); }
+
+    const Object_Header& header = get_header();
+    if (header.version != version) {
+        ostringstream reason;
+        reason << "object file version " << header.version << ", expected " << version;
+        return fail(reason.str());
+    }
+
+    // Sections, computed in 64 bits so that no count can wrap around
+    uint64_t instruction_end = static_cast<uint64_t>(header.instruction_offset) + static_cast<uint64_t>(header.instruction_count) * sizeof(Vm_Instruction);
+    uint64_t data_end = static_cast<uint64_t>(header.data_offset) + static_cast<uint64_t>(header.variable_count) * sizeof(int32_t);
+    uint64_t names_end = static_cast<uint64_t>(header.names_offset) + header.names_size;
+    if (header.instruction_offset < sizeof(Object_Header) || header.instruction_offset % 4 != 0 || header.data_offset % 4 != 0
+        || instruction_end > size || data_end > size || names_end > size) {
+        return fail("truncated object file");
+    }
+
+    const Vm_Instruction* instructions = get_instructions();
+    for (size_t i = 0; i < header.instruction_count; ++i) {
+        int32_t opcode = instructions[i].opcode;
+        int32_t operand = instructions[i].operand;
+        bool valid = opcode >= 0 && opcode < VM_END;
+        if (valid && is_branch(opcode)) { valid = operand >= 0 && static_cast<uint32_t>(operand) <= header.instruction_count; }
+        if (valid && takes_variable(opcode)) { valid = operand >= 0 && static_cast<uint32_t>(operand) < header.variable_count; }
+        if (!valid) {
+            ostringstream reason;
+            reason << "invalid instruction " << i;
+            return fail(reason.str());
+        }
+    }
+
+    // Exactly one NUL-terminated name per variable
+    const char* names = bytes + header.names_offset;
+    size_t terminators = 0;
+    for (size_t i = 0; i < header.names_size; ++i) {
+        if (names[i] == '\0') { ++terminators; }
+    }
+    if (terminators != header.variable_count || (header.names_size > 0 && names[header.names_size - 1] != '\0')) {
+        return fail("invalid variable names");
+    }
+
+    return true;
+}
+
+/** Convert the object back to .asm text in the format the Generator writes. Branch targets get
+ *  labels L0, L1, ... in program order, since the object keeps only their indices.
+ *  @return: the assembly
+ */
+string Object_File::disassemble() const {
+    ostringstream text;
+    const Vm_Instruction* instructions = get_instructions();
+    size_t count = get_instruction_count();
+    vector<string> names = get_variable_names();
+
+    map<int32_t, string> labels; // Label of each branch target
+    for (size_t i = 0; i < count; ++i) {
+        if (is_branch(instructions[i].opcode)) { labels[instructions[i].operand] = ""; }
+    }
+    size_t next_label = 0;
+    for (map<int32_t, string>::iterator it = labels.begin(); it != labels.end(); ++it) {
+        ostringstream label;
+        label << "L" << next_label++;
+        it->second = label.str();
+    }
+
+    for (size_t i = 0; i <= count; ++i) {
+        map<int32_t, string>::const_iterator label = labels.find(static_cast<int32_t>(i));
+        if (i == count) {
+            if (label != labels.end()) { text << label->second << ":\n"; } // A branch to the end of the program
+            break;
+        }
+        if (label != labels.end()) { text << label->second << ": "; }
+
+        int32_t opcode = instructions[i].opcode;
+        int32_t operand = instructions[i].operand;
+        text << Virtual_Machine::get_opcode_name(opcode);
+        if (is_branch(opcode)) { text << " " << labels[operand]; }
+        else if (takes_variable(opcode)) { text << " " << names.at(operand); }
+        else if (opcode != VM_NOOP && opcode != VM_STOP) { text << " " << operand; }
+        text << "\n";
+    }
+
+    const int32_t* values = get_initial_values();
+    for (size_t i = 0; i < names.size(); ++i) {
+        text << names.at(i) << " " << values[i] << "\n";
+    }
+    return text.str();
+}
+
+// Check if a file starts with the magic of an object file
+bool Object_File::is_object_file(const string& file) {
+    ifstream fin(file.c_str(), std::ios::binary);
+    char start[sizeof(magic)];
+    return fin.read(start, sizeof(start)) && std::memcmp(start, magic, sizeof(magic)) == 0;
+}
+
+// Unmap the file and forget the object
+void Object_File::release() {
+#ifdef OBJECT_FILE_MMAP
+    if (mapping != NULL) { munmap(mapping, mapping_size); }
+#endif
+    mapping = NULL;
+    mapping_size = 0;
+    image.clear();
+    bytes = NULL;
+    size = 0;
+}
@@ -0,0 +1,73 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef OBJECT_FILE_H
+#define OBJECT_FILE_H
+
+#include "Virtual_Machine.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// Fixed-size header at the start of an object file. Every field is a 32-bit word in the byte
+// order of the machine that wrote the file; a machine of the other order reads a wrong version.
+struct Object_Header {
+    char magic[4]; // "P4OB"
+    uint32_t version; // Object_File::version, changed whenever the layout or the opcodes change
+    uint32_t instruction_count; // Number of instructions
+    uint32_t variable_count; // Number of variables
+    uint32_t instruction_offset; // Byte offset of the instructions, each a Vm_Instruction
+    uint32_t data_offset; // Byte offset of the initial values, one int32_t per variable
+    uint32_t names_offset; // Byte offset of the variable names, each ending with a NUL
+    uint32_t names_size; // Number of bytes of names
+};
+
+// A compiled program in binary form: the bytecode of the Virtual_Machine with labels resolved to
+// instruction indices and variables to addresses, so loading it is mapping the file into memory.
+class Object_File {
+public:
+    static const uint32_t version; // Version of the layout this build reads and writes
+
+    // Constructors
+    Object_File();
+    ~Object_File();
+
+    // Getters
+    const Vm_Instruction* get_instructions() const; // The instructions, without the VM_END after them
+    size_t get_instruction_count() const;
+    const int32_t* get_initial_values() const; // Initial value of each variable, by address
+    size_t get_variable_count() const;
+    vector<string> get_variable_names() const; // Name of each variable, by address
+    const string& get_error() const;
+
+    // Member functions
+    bool assemble(const string&); // Build the object from .asm text, false with get_error set if it is invalid
+    bool write(const string&) const; // Write the object to a file
+    bool load(const string&); // Map an object file into memory and check it, false with get_error set if it is invalid
+    string disassemble() const; // Convert the object back to .asm text
+    static bool is_object_file(const string&); // Check if a file starts with the magic of an object file
+
+private:
+    // Data fields
+    vector<char> image; // The bytes of an assembled object, or of a loaded one where mmap is unavailable
+    void* mapping; // The mapped file, NULL if none
+    size_t mapping_size; // Number of bytes mapped
+    const char* bytes; // Start of the object, in image or in mapping
+    size_t size; // Number of bytes of the object
+    string error; // Why the last assembly or load failed
+
+    // Member functions
+    Object_File(const Object_File&); // Not copyable, it may own a mapping
+    Object_File& operator=(const Object_File&);
+    const Object_Header& get_header() const;
+    bool fail(const string&); // Record why assembly or a load failed
+    bool check(); // Check the header and every operand of the object
+    void release(); // Unmap the file and forget the object
+};
+
+#endif // OBJECT_FILE_H
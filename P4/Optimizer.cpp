@@ -0,0 +1,596 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Optimizer.h"
+
+#include <cstdlib>
+
+using std::ostringstream;
+
+// Constructor
+Optimizer::Optimizer(Program& program) : program(program), next_value(0), accumulator_value(0) {}
+
+Optimizer::Constant_State::Constant_State() : reached(false), accumulator_known(false), accumulator(0) {}
+
+// Member functions
+
+/** Local value numbering.
+ *  The program is scanned once while tracking which value every variable and the accumulator hold.
+ *  Loads and stores of a value that is already in place are removed, operands are redirected to the
+ *  variable that first received their value, constants are folded, and an arithmetic instruction whose
+ *  result is already available becomes a load. When a result is computed a second time but was never
+ *  stored, the first computation is spilled to a new temporary so the second one can load it instead.
+ *  A store or read of a variable gives it a new value number, so expressions over its old value are no
+ *  longer found. The tables are cleared at every label, so a block only inherits the values of the
+ *  block it falls through from.
+ */
+void Optimizer::value_numbering() {
+    const vector<Instruction> instructions = program.get_instructions();
+    vector<Instruction> result;
+    map<size_t, size_t> value_positions; // Where each unstored result was computed
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        Instruction instruction = instructions.at(i);
+        const string label = instruction.label;
+        const string opcode = instruction.opcode;
+
+        // Start over at a label, or after an instruction that does not fall through
+        if (i == 0 || !label.empty() || instructions.at(i - 1).opcode == "BR" || instructions.at(i - 1).opcode == "STOP") {
+            location_values.clear();
+            expression_values.clear();
+            value_homes.clear();
+            value_positions.clear();
+            accumulator_value = next_value++;
+        }
+
+        // Redirect a variable operand to a constant or to the variable that first received its value
+        string holder;
+        if (instruction.reads_memory()) {
+            size_t value = get_location_value(instruction.operand);
+            long long constant = 0;
+            if (opcode != "WRITE" && get_constant(value, constant) && constant >= 0) {
+                instruction.operand = to_operand(constant);
+            } else if (find_holder(value, holder)) {
+                instruction.operand = holder;
+            }
+        }
+
+        bool removed = false;
+        if (opcode == "LOAD") {
+            size_t value = get_operand_value(instruction);
+            removed = (value == accumulator_value); // Already in the accumulator
+            accumulator_value = value;
+        } else if (opcode == "STORE") {
+            removed = (get_location_value(instruction.operand) == accumulator_value); // Already stored
+            set_location_value(instruction.operand, accumulator_value);
+        } else if (opcode == "READ") {
+            set_location_value(instruction.operand, next_value++);
+        } else if (instruction.is_arithmetic()) {
+            size_t operand_value = get_operand_value(instruction);
+            long long left = 0;
+            long long right = 0;
+            bool left_constant = get_constant(accumulator_value, left);
+            bool right_constant = get_constant(operand_value, right);
+
+            // Look up the expression, ordering the operands of ADD and MULT
+            size_t first = accumulator_value;
+            size_t second = operand_value;
+            if ((opcode == "ADD" || opcode == "MULT") && second < first) {
+                first = operand_value;
+                second = accumulator_value;
+            }
+            ostringstream key;
+            key << opcode << " " << first << " " << second;
+
+            long long folded = 0;
+            if (right_constant && ((right == 0 && (opcode == "ADD" || opcode == "SUB")) || (right == 1 && (opcode == "MULT" || opcode == "DIV")))) {
+                removed = true; // Identities leave the accumulator unchanged
+            } else if (left_constant && right_constant && fold(opcode, left, right, folded)) {
+                accumulator_value = get_constant_value(folded);
+            } else if (expression_values.count(key.str())) {
+                accumulator_value = expression_values[key.str()];
+            } else {
+                accumulator_value = next_value++;
+                expression_values[key.str()] = accumulator_value;
+            }
+
+            // Reuse a value that is already available instead of computing it again
+            long long constant = 0;
+            if (removed) {
+                // Nothing to compute
+            } else if (get_constant(accumulator_value, constant) && constant >= 0) {
+                instruction = Instruction("LOAD", to_operand(constant));
+            } else if (find_holder(accumulator_value, holder)) {
+                instruction = Instruction("LOAD", holder);
+            } else if (value_positions.count(accumulator_value)) {
+                // Spill the first computation so this one becomes a load
+                size_t position = value_positions[accumulator_value];
+                string temp = create_temp();
+                Instruction spill("STORE", temp);
+                spill.line = result.at(position).line;
+                result.insert(result.begin() + position + 1, spill);
+                for (map<size_t, size_t>::iterator it = value_positions.begin(); it != value_positions.end(); ++it) {
+                    if (it->second > position) { ++it->second; }
+                }
+                value_positions.erase(accumulator_value);
+                set_location_value(temp, accumulator_value);
+                instruction = Instruction("LOAD", temp);
+            } else {
+                value_positions[accumulator_value] = result.size();
+            }
+        }
+
+        if (removed) {
+            // Keep a branch target in place
+            if (!label.empty()) {
+                Instruction target("NOOP", "", label);
+                target.line = instructions.at(i).line;
+                result.push_back(target);
+            }
+            continue;
+        }
+
+        instruction.label = label;
+        instruction.line = instructions.at(i).line;
+        result.push_back(instruction);
+    }
+
+    program.get_instructions() = result;
+    remove_dead_accumulator_writes();
+}
+
+/** Conditional constant propagation.
+ *  Every variable starts at 0, so the entry block knows all of them. What each block knows on entry is
+ *  what holds on every executable edge into it, and a conditional branch on a known accumulator makes
+ *  only one of its edges executable, so a block no executable edge reaches is never visited and does
+ *  not weaken what the others know. Blocks are revisited until nothing changes. The program is then
+ *  rewritten: variable operands holding a known non-negative constant become immediates, arithmetic
+ *  with a known non-negative result becomes a load, a decided branch becomes BR unless it only reaches
+ *  the next block that is kept, and the blocks control never reaches are removed.
+ *  @param graph The control-flow graph of the program
+ */
+void Optimizer::constant_propagation(const Control_Flow_Graph& graph) {
+    const vector<Instruction> instructions = program.get_instructions();
+    const vector<Control_Flow_Graph::Basic_Block>& blocks = graph.get_blocks();
+    if (blocks.empty()) { return; }
+
+    vector<Constant_State> entry(blocks.size());
+    entry.at(0).reached = true;
+    const vector<string>& storage = program.get_storage();
+    for (size_t i = 0; i < storage.size(); ++i) { entry.at(0).variables[storage.at(i)] = 0; }
+
+    vector<size_t> worklist(1, 0);
+    while (!worklist.empty()) {
+        size_t b = worklist.back();
+        worklist.pop_back();
+
+        Constant_State state = entry.at(b);
+        for (size_t i = blocks.at(b).first; i < blocks.at(b).end; ++i) { propagate_constants(instructions.at(i), state); }
+
+        // Follow only the edge a decided branch takes
+        const Instruction& last = instructions.at(blocks.at(b).end - 1);
+        vector<size_t> successors = blocks.at(b).successors;
+        if (last.is_conditional_branch() && state.accumulator_known) {
+            successors.clear();
+            if (is_branch_taken(last.opcode, state.accumulator)) {
+                successors.push_back(graph.find_block(last.operand));
+            } else if (b + 1 < blocks.size()) {
+                successors.push_back(b + 1);
+            }
+        }
+
+        for (size_t i = 0; i < successors.size(); ++i) {
+            size_t successor = successors.at(i);
+            if (successor != Control_Flow_Graph::none && merge_constants(entry.at(successor), state)) { worklist.push_back(successor); }
+        }
+    }
+
+    vector<Instruction> result;
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        if (!entry.at(b).reached) { continue; } // Only branches that were removed or never taken lead here
+
+        Constant_State state = entry.at(b);
+        for (size_t i = blocks.at(b).first; i < blocks.at(b).end; ++i) {
+            Instruction instruction = instructions.at(i);
+
+            // Use the constant a variable operand holds
+            if (instruction.reads_memory() && instruction.opcode != "WRITE") {
+                map<string, long long>::const_iterator it = state.variables.find(instruction.operand);
+                if (it != state.variables.end() && it->second >= 0) { instruction.operand = to_operand(it->second); }
+            }
+
+            // A decided branch falls through, or jumps past blocks that are removed
+            bool removed = false;
+            if (instruction.is_conditional_branch() && state.accumulator_known) {
+                if (is_branch_taken(instruction.opcode, state.accumulator)) {
+                    size_t target = graph.find_block(instruction.operand);
+                    instruction.opcode = "BR";
+                    removed = target != Control_Flow_Graph::none && target > b;
+                    for (size_t next = b + 1; removed && next < target; ++next) { removed = !entry.at(next).reached; }
+                } else {
+                    removed = true;
+                }
+            }
+
+            propagate_constants(instructions.at(i), state);
+            if (instruction.is_arithmetic() && state.accumulator_known && state.accumulator >= 0) {
+                instruction.opcode = "LOAD";
+                instruction.operand = to_operand(state.accumulator);
+            }
+
+            if (removed) {
+                // Keep a branch target in place
+                if (!instruction.label.empty()) {
+                    Instruction target("NOOP", "", instruction.label);
+                    target.line = instruction.line;
+                    result.push_back(target);
+                }
+                continue;
+            }
+            result.push_back(instruction);
+        }
+    }
+
+    program.get_instructions() = result;
+}
+
+/** Remove instructions whose only effect is an accumulator value that is overwritten before it is read.
+ *  The accumulator is assumed to be live at the end of every basic block.
+ */
+void Optimizer::remove_dead_accumulator_writes() {
+    vector<Instruction>& instructions = program.get_instructions();
+    vector<Instruction> result;
+    bool accumulator_live = true;
+
+    for (size_t i = instructions.size(); i-- > 0;) {
+        Instruction instruction = instructions.at(i);
+        const string& opcode = instruction.opcode;
+
+        // The accumulator may be read after a block ends
+        if (i + 1 < instructions.size() && (instruction.ends_block() || !instructions.at(i + 1).label.empty())) {
+            accumulator_live = true;
+        }
+
+        // A division by a variable may stop the program, so it stays even if its result is not used
+        bool may_trap = opcode == "DIV" && (!instruction.has_immediate_operand() || atoll(instruction.operand.c_str()) == 0);
+
+        if (opcode == "LOAD" || instruction.is_arithmetic()) {
+            if (!accumulator_live && !may_trap) {
+                // Keep a branch target in place
+                if (instruction.label.empty()) { continue; }
+                instruction.opcode = "NOOP";
+                instruction.operand.clear();
+            } else {
+                accumulator_live = instruction.is_arithmetic(); // LOAD does not read the accumulator
+            }
+        } else if (opcode == "STORE" || instruction.is_branch()) {
+            accumulator_live = true;
+        } else if (opcode == "STOP") {
+            accumulator_live = false;
+        }
+
+        result.push_back(instruction);
+    }
+
+    instructions.assign(result.rbegin(), result.rend());
+}
+
+/** Dead store elimination.
+ *  A store, or the load feeding it, is useless when the variable is overwritten or the program stops before
+ *  anything reads it again. Such stores are removed using the liveness of every variable across branches,
+ *  and the variables and temporaries no instruction mentions any more are dropped from the storage.
+ */
+void Optimizer::dead_store_elimination() {
+    dead_store_elimination(get_live_variables());
+}
+
+/** Dead store elimination given the result of get_live_variables for the current program.
+ *  @param live The variables live after each instruction
+ */
+void Optimizer::dead_store_elimination(const vector<set<string> >& live) {
+    vector<Instruction>& instructions = program.get_instructions();
+    vector<Instruction> result;
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        const Instruction& instruction = instructions.at(i);
+
+        // A READ still consumes its input, so only stores are removed
+        if (instruction.opcode == "STORE" && !live.at(i).count(instruction.operand)) {
+            // Keep a branch target in place
+            if (!instruction.label.empty()) {
+                Instruction target("NOOP", "", instruction.label);
+                target.line = instruction.line;
+                result.push_back(target);
+            }
+            continue;
+        }
+        result.push_back(instruction);
+    }
+
+    instructions = result;
+    remove_dead_accumulator_writes();
+    prune_storage();
+}
+
+/** Backward liveness analysis over the variables of the program.
+ *  @return: for each instruction, the variables that may be read before being written after it
+ */
+vector<set<string> > Optimizer::get_live_variables() const {
+    return get_live_variables(Control_Flow_Graph(program));
+}
+
+/** Backward liveness analysis over the basic blocks of the program, then through each block.
+ *  @param graph The control-flow graph of the program
+ *  @return: for each instruction, the variables that may be read before being written after it
+ */
+vector<set<string> > Optimizer::get_live_variables(const Control_Flow_Graph& graph) const {
+    const vector<Instruction>& instructions = program.get_instructions();
+    const vector<Control_Flow_Graph::Basic_Block>& blocks = graph.get_blocks();
+
+    // The variables each block reads before writing them, and the ones it writes
+    vector<set<string> > uses(blocks.size());
+    vector<set<string> > definitions(blocks.size());
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        for (size_t i = blocks.at(b).end; i-- > blocks.at(b).first;) {
+            const Instruction& instruction = instructions.at(i);
+            if (instruction.writes_memory()) {
+                uses.at(b).erase(instruction.operand);
+                definitions.at(b).insert(instruction.operand);
+            }
+            if (instruction.reads_memory()) { uses.at(b).insert(instruction.operand); }
+        }
+    }
+
+    // Iterate until nothing changes, walking backwards so straight-line code settles in one sweep
+    vector<set<string> > live_in(blocks.size());
+    vector<set<string> > live_out(blocks.size());
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (size_t b = blocks.size(); b-- > 0;) {
+            set<string> out;
+            const vector<size_t>& successors = blocks.at(b).successors;
+            for (size_t i = 0; i < successors.size(); ++i) {
+                out.insert(live_in.at(successors.at(i)).begin(), live_in.at(successors.at(i)).end());
+            }
+
+            set<string> in = uses.at(b);
+            for (set<string>::const_iterator it = out.begin(); it != out.end(); ++it) {
+                if (!definitions.at(b).count(*it)) { in.insert(*it); }
+            }
+
+            live_out.at(b) = out;
+            if (in != live_in.at(b)) {
+                live_in.at(b) = in;
+                changed = true;
+            }
+        }
+    }
+
+    // Walk each block backwards from what is live at its end
+    vector<set<string> > result(instructions.size());
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        set<string> live = live_out.at(b);
+        for (size_t i = blocks.at(b).end; i-- > blocks.at(b).first;) {
+            const Instruction& instruction = instructions.at(i);
+            result.at(i) = live;
+            if (instruction.writes_memory()) { live.erase(instruction.operand); }
+            if (instruction.reads_memory()) { live.insert(instruction.operand); }
+        }
+    }
+
+    return result;
+}
+
+// Remove the storage of variables no instruction mentions
+void Optimizer::prune_storage() {
+    const vector<Instruction>& instructions = program.get_instructions();
+    set<string> used;
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        if (instructions.at(i).reads_memory() || instructions.at(i).writes_memory()) { used.insert(instructions.at(i).operand); }
+    }
+
+    vector<string>& storage = program.get_storage();
+    vector<string> result;
+    for (size_t i = 0; i < storage.size(); ++i) {
+        if (used.count(storage.at(i))) { result.push_back(storage.at(i)); }
+    }
+    storage = result;
+}
+
+// Give a variable a new value number
+void Optimizer::set_location_value(const string& location, size_t value) {
+    location_values[location] = value;
+
+    // The first variable to receive a value is where later uses look for it
+    map<size_t, string>::const_iterator home = value_homes.find(value);
+    if (home == value_homes.end() || location_values[home->second] != value) {
+        value_homes[value] = location;
+    }
+}
+
+// Create a new temporary variable in the storage of the program
+string Optimizer::create_temp() {
+    vector<string>& storage = program.get_storage();
+
+    // Continue the numbering of the temporaries the Generator created
+    size_t number = 0;
+    for (size_t i = 0; i < storage.size(); ++i) {
+        const string& name = storage.at(i);
+        if (name.size() > 2 && name.at(0) == GENERATED_PREFIX && name.at(1) == 'T' && name.find_first_not_of("0123456789", 2) == string::npos) {
+            size_t value = static_cast<size_t>(atoll(name.c_str() + 2));
+            if (value >= number) { number = value + 1; }
+        }
+    }
+
+    string temp = generated_name('T', number);
+    program.add_storage(temp);
+    return temp;
+}
+
+// Convert a constant to an immediate operand
+string Optimizer::to_operand(long long constant) {
+    ostringstream oss;
+    oss << constant;
+    return oss.str();
+}
+
+// Get the value number held by a variable
+size_t Optimizer::get_location_value(const string& location) {
+    map<string, size_t>::const_iterator it = location_values.find(location);
+    if (it != location_values.end()) { return it->second; }
+
+    // The value a variable holds on entry to the block
+    size_t value = next_value++;
+    location_values[location] = value;
+    value_homes[value] = location;
+    return value;
+}
+
+// Get the value number of a constant
+size_t Optimizer::get_constant_value(long long constant) {
+    map<long long, size_t>::const_iterator it = constant_values.find(constant);
+    if (it != constant_values.end()) { return it->second; }
+
+    size_t value = next_value++;
+    constant_values[constant] = value;
+    value_constants[value] = constant;
+    return value;
+}
+
+// Get the value number of the operand of an instruction
+size_t Optimizer::get_operand_value(const Instruction& instruction) {
+    if (instruction.has_immediate_operand()) {
+        return get_constant_value(atoll(instruction.operand.c_str()));
+    }
+    return get_location_value(instruction.operand);
+}
+
+/** Find a variable currently holding a value number, preferring the first one that received it.
+ *  @param value The value number
+ *  @param holder Receives the variable
+ *  @return True if a variable holds the value, false otherwise
+ */
+bool Optimizer::find_holder(size_t value, string& holder) {
+    map<size_t, string>::const_iterator home = value_homes.find(value);
+    if (home != value_homes.end() && location_values[home->second] == value) {
+        holder = home->second;
+        return true;
+    }
+
+    for (map<string, size_t>::const_iterator it = location_values.begin(); it != location_values.end(); ++it) {
+        if (it->second == value) {
+            holder = it->first;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Get the constant behind a value number
+bool Optimizer::get_constant(size_t value, long long& constant) {
+    map<size_t, long long>::const_iterator it = value_constants.find(value);
+    if (it == value_constants.end()) { return false; }
+
+    constant = it->second;
+    return true;
+}
+
+/** Fold an arithmetic instruction on constants.
+ *  Results that leave the range of a machine word, and division by zero, are left to run time.
+ *  @param opcode ADD, SUB, MULT or DIV
+ *  @param left The accumulator
+ *  @param right The operand
+ *  @param result Receives the folded value
+ *  @return True if the instruction was folded, false otherwise
+ */
+bool Optimizer::fold(const string& opcode, long long left, long long right, long long& result) {
+    if (opcode == "ADD") { result = left + right; }
+    else if (opcode == "SUB") { result = left - right; }
+    else if (opcode == "MULT") { result = left * right; }
+    else if (opcode == "DIV" && right != 0) { result = left / right; }
+    else { return false; }
+
+    const long long word_limit = 2147483647LL;
+    return result <= word_limit && result >= -word_limit - 1;
+}
+
+/** Apply an instruction to what constant propagation knows.
+ *  @param instruction The instruction
+ *  @param state What is known before it, updated to what is known after it
+ */
+void Optimizer::propagate_constants(const Instruction& instruction, Constant_State& state) {
+    const string& opcode = instruction.opcode;
+
+    // The value of the operand, if it is an immediate or a variable holding a known constant
+    bool operand_known = false;
+    long long operand = 0;
+    if (instruction.has_immediate_operand()) {
+        operand_known = true;
+        operand = atoll(instruction.operand.c_str());
+    } else if (state.variables.count(instruction.operand)) {
+        operand_known = true;
+        operand = state.variables[instruction.operand];
+    }
+
+    if (opcode == "LOAD") {
+        state.accumulator_known = operand_known;
+        state.accumulator = operand;
+    } else if (opcode == "STORE") {
+        if (state.accumulator_known) {
+            state.variables[instruction.operand] = state.accumulator;
+        } else {
+            state.variables.erase(instruction.operand);
+        }
+    } else if (opcode == "READ") {
+        state.variables.erase(instruction.operand);
+    } else if (instruction.is_arithmetic()) {
+        long long folded = 0;
+        state.accumulator_known = state.accumulator_known && operand_known && fold(opcode, state.accumulator, operand, folded);
+        state.accumulator = folded;
+    }
+}
+
+/** Keep what holds both on the paths already merged into a block and on a new one.
+ *  @param merged What the block knows so far, updated
+ *  @param incoming What holds at the end of the new path
+ *  @return True if what the block knows changed, false otherwise
+ */
+bool Optimizer::merge_constants(Constant_State& merged, const Constant_State& incoming) {
+    if (!merged.reached) {
+        merged = incoming;
+        return true;
+    }
+
+    bool changed = false;
+    if (merged.accumulator_known && (!incoming.accumulator_known || incoming.accumulator != merged.accumulator)) {
+        merged.accumulator_known = false;
+        changed = true;
+    }
+
+    for (map<string, long long>::iterator it = merged.variables.begin(); it != merged.variables.end();) {
+        map<string, long long>::const_iterator other = incoming.variables.find(it->first);
+        if (other == incoming.variables.end() || other->second != it->second) {
+            merged.variables.erase(it++);
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+    return changed;
+}
+
+/** Check if a conditional branch jumps when the accumulator holds a value.
+ *  @param opcode BRNEG, BRZNEG, BRPOS, BRZPOS or BRZERO
+ *  @param accumulator The value
+ *  @return True if the branch jumps, false if it falls through
+ */
+bool Optimizer::is_branch_taken(const string& opcode, long long accumulator) {
+    if (opcode == "BRNEG") { return accumulator < 0; }
+    if (opcode == "BRZNEG") { return accumulator <= 0; }
+    if (opcode == "BRPOS") { return accumulator > 0; }
+    if (opcode == "BRZPOS") { return accumulator >= 0; }
+    return accumulator == 0;
+}
@@ -0,0 +1,75 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "Program.h"
+#include "Control_Flow_Graph.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+// Optimization passes over the lowered program
+class Optimizer {
+public:
+    // Constructors
+    Optimizer(Program&);
+
+    // Member functions
+    void value_numbering(); // Local value numbering over each basic block
+    void constant_propagation(const Control_Flow_Graph&); // Conditional constant propagation across the basic blocks
+    void dead_store_elimination(); // Remove stores that are never read and the storage nobody uses
+    void dead_store_elimination(const vector<set<string> >&); // Same, with the liveness already computed
+    vector<set<string> > get_live_variables() const; // Variables that may be read after each instruction
+    vector<set<string> > get_live_variables(const Control_Flow_Graph&) const; // Same, with the graph already built
+
+private:
+    // What constant propagation knows at a point of the program
+    struct Constant_State {
+        bool reached; // Control can get here along the branches found executable so far
+        bool accumulator_known; // The accumulator holds a known constant
+        long long accumulator; // That constant
+        map<string, long long> variables; // Variables holding a known constant, the others vary
+
+        Constant_State();
+    };
+
+    // Data fields
+    Program& program; // The program being optimized
+
+    // Value numbering state for the current basic block
+    size_t next_value; // Next unused value number
+    size_t accumulator_value; // Value number held by the accumulator
+    map<string, size_t> location_values; // Value number held by each variable
+    map<string, size_t> expression_values; // Value number of each computed expression
+    map<size_t, string> value_homes; // First variable that received each value number
+    map<long long, size_t> constant_values; // Value number of each constant
+    map<size_t, long long> value_constants; // Constant behind a value number, if known
+
+    // Member functions
+    void remove_dead_accumulator_writes(); // Remove results overwritten before they are read
+    void prune_storage(); // Remove the storage of variables no instruction mentions
+    size_t get_location_value(const string&); // Get the value number held by a variable
+    void set_location_value(const string&, size_t); // Give a variable a new value number
+    size_t get_constant_value(long long); // Get the value number of a constant
+    size_t get_operand_value(const Instruction&); // Get the value number of an operand
+    bool find_holder(size_t, string&); // Find a variable currently holding a value number
+    bool get_constant(size_t, long long&); // Get the constant behind a value number
+    bool fold(const string&, long long, long long, long long&); // Fold an arithmetic instruction on constants
+    void propagate_constants(const Instruction&, Constant_State&); // Apply an instruction to what is known
+    static bool merge_constants(Constant_State&, const Constant_State&); // Keep what holds on both paths
+    static bool is_branch_taken(const string&, long long); // Check if a conditional branch jumps for an accumulator
+    string create_temp(); // Create a new temporary variable in the storage of the program
+    string to_operand(long long); // Convert a constant to an immediate operand
+};
+
+#endif // OPTIMIZER_H
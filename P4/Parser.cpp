@@ -56,7 +56,7 @@ Tree Parser::parse() {
     }
 }
 
-//<program>  ->     program <vars> <block>
+//<program>  ->     program <vars> <funcs> <block>
 Node Parser::program() {
     Node program_node = create_node("<program>");
 
@@ -67,8 +67,9 @@ Node Parser::program() {
         exit_error("Syntax error: Expected 'program' keyword.");
     }
 
-    // Parse <vars> and <block>
+    // Parse <vars>, <funcs> and <block>
     program_node.add_child(vars());
+    program_node.add_child(funcs());
     program_node.add_child(block());
 
     return program_node;
@@ -129,6 +130,30 @@ Node Parser::var_list() {
     return var_list_node;
 }
 
+//<funcs> -> empty | func identifier <block> <funcs>
+Node Parser::funcs() {
+	Node funcs_node = create_node("<funcs>");
+
+	// Check if the current token is 'func'
+	if (current_token.id == KW_TK && current_token.instance == "func") {
+		match(KW_TK); //consume 'func'
+		funcs_node.add_child(create_node("func"));
+
+		// Expect the name of the function
+		if (current_token.id == IDENT_TK) {
+			funcs_node.add_child(create_node(current_token.instance));
+			match(IDENT_TK); //consume identifier
+		} else {
+			exit_error("Syntax Error: Expected an identifier after 'func' in <funcs>.");
+		}
+
+		funcs_node.add_child(block()); // Parse the body
+		funcs_node.add_child(funcs()); // Parse the remaining <funcs>
+	}
+
+	return funcs_node;
+}
+
 //<block> -> start <vars> <stats> stop
 Node Parser::block() {
 	Node block_node = create_node("<block>");
@@ -169,7 +194,7 @@ Node Parser::stats() {
 Node Parser::m_stat() {
 	Node m_stat_node= create_node("<mStat>");
 
-	if (current_token.id == KW_TK && (current_token.instance == "read" || current_token.instance == "print" || current_token.instance == "iff" || current_token.instance == "iterate" || current_token.instance == "set" || current_token.instance == "start")) {
+	if (current_token.id == KW_TK && (current_token.instance == "read" || current_token.instance == "print" || current_token.instance == "iff" || current_token.instance == "iterate" || current_token.instance == "set" || current_token.instance == "start" || current_token.instance == "func")) {
 		m_stat_node.add_child(stat()); // Parse <stat>
 		m_stat_node.add_child(m_stat()); // Parse <mStat>
 	}
@@ -177,7 +202,7 @@ Node Parser::m_stat() {
 	return m_stat_node; // Return the constructed <mStat> node
 }
 
-//<stat> -> <read> | <print> | <block> | <cond> | <iter> | <assign>
+//<stat> -> <read> | <print> | <block> | <cond> | <iter> | <assign> | <call>
 Node Parser::stat() {
 	Node stat_node = create_node("<stat>");
 
@@ -194,6 +219,8 @@ Node Parser::stat() {
             stat_node.add_child(iter()); // Parse <iter> 
         } else if (current_token.instance == "set") {
             stat_node.add_child(assign()); // Parse <assign> 
+        } else if (current_token.instance == "func") {
+            stat_node.add_child(call()); // Parse <call>
         } else {
             exit_error("Syntax Error: Unexpected keyword in <stat>");
         }
@@ -373,6 +400,37 @@ Node Parser::assign() {
 	return assign_node;
 }
 
+//<call> -> func identifier;
+Node Parser::call() {
+	Node call_node = create_node("<call>");
+
+	// Expect 'func' keyword
+	if (current_token.id == KW_TK && current_token.instance == "func") {
+		match(KW_TK); //consume 'func'
+		call_node.add_child(create_node("func"));
+	} else {
+		exit_error("Syntax error: Expected 'func' keyword in <call>.");
+	}
+
+	// Expect the name of the function
+	if (current_token.id == IDENT_TK) {
+		call_node.add_child(create_node(current_token.instance));
+		match(IDENT_TK); //consume identifier
+	} else {
+		exit_error("Syntax Error: Expected an identifier after 'func' in <call>.");
+	}
+
+	// Expect ';'
+	if (current_token.id == OP_TK && current_token.instance == ";") {
+		match(OP_TK); //consume ';'
+		call_node.add_child(create_node(";"));
+	} else {
+		exit_error("Syntax Error: Expected ';' at the end of <call>.");
+	}
+
+	return call_node;
+}
+
 //<relational> ..le. | .ge. | .lt. | .gt. | **| ~Note: these are 6 individual tokens
 Node Parser::relational() {
 	Node relational_node = create_node("<relational>");
@@ -22,7 +22,7 @@ public:
 
 	// Member functions
 	Tree parse(); // Parse the input file and return the parse tree
-	Node program(); // <program>  ->     program <vars> <block>
+	Node program(); // <program>  ->     program <vars> <funcs> <block>
 	Node create_node(const string&); // Create a node with the given data
 
 
@@ -41,15 +41,17 @@ private:
 	
 	Node vars(); // <vars>         ->      empty | var <varList>
 	Node var_list(); // <varList>     ->      identifier , integer ; | identifier , integer <varList>
+	Node funcs(); // <funcs>       ->      empty | func identifier <block> <funcs>
 	Node block(); // <block>       ->      start <vars> <stats> stop
 	Node stats(); // <stats>         ->      <stat>  <mStat>
 	Node m_stat(); // <mStat>        ->      empty | <stat> <mStat>
-	Node stat(); // <stat>           ->      <read> | <print> | <block> | <cond> | <iter> | <assign>
+	Node stat(); // <stat>           ->      <read> | <print> | <block> | <cond> | <iter> | <assign> | <call>
 	Node read(); // <read>         ->      read identifier ;
 	Node print(); // <print>        ->     print <exp> ;
 	Node cond(); // <cond>        ->      iff [ <exp> <relational> <exp> ] <stat>
 	Node iter(); // <iter>           ->      iterate [ <exp> <relational> <exp> ]  <stat>
 	Node assign(); // <assign>      ->     set identifier <exp> ;
+	Node call(); // <call>        ->      func identifier ;
 	Node exp(); //  <M> + <exp> | <M> - <exp> | <M>
 	Node relational(); // .le. | .ge. | .lt. | .gt. | **| ~Note: these are 6 individual tokens
 	Node m(); // <M>             ->      <N> % <M> | <N>
@@ -0,0 +1,314 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Partial_Evaluator.h"
+
+#include <cctype>
+#include <cstdlib>
+
+// Constructors
+Partial_Evaluator::Partial_Evaluator(const Tree& tree) : tree(tree), steps(0), step_budget(100000), output_limit(1000) {}
+
+// Getters
+const vector<long long>& Partial_Evaluator::get_output() const { return output; }
+
+size_t Partial_Evaluator::get_steps() const { return steps; }
+
+const string& Partial_Evaluator::get_failure() const { return failure; }
+
+/** Generate the code that writes the output of a finished evaluation.
+ *  Every distinct value is stored once into its own temporary and written from there;
+ *  the temporary of 0 needs no store since storage starts at 0.
+ *  @return: the program
+ */
+Program Partial_Evaluator::get_program() const {
+    Program program;
+    map<long long, string> temps;
+
+    for (size_t i = 0; i < output.size(); ++i) {
+        long long value = output.at(i);
+        map<long long, string>::const_iterator found = temps.find(value);
+
+        if (found == temps.end()) {
+            string temp = generated_name('T', temps.size());
+            found = temps.insert(std::make_pair(value, temp)).first;
+            program.add_storage(temp);
+
+            // Immediates are nonnegative, so a negative value is built from 0
+            if (value > 0) {
+                ostringstream operand;
+                operand << value;
+                program.add_instruction(Instruction("LOAD", operand.str()));
+                program.add_instruction(Instruction("STORE", found->second));
+            } else if (value < 0) {
+                long long magnitude = -value;
+                program.add_instruction(Instruction("LOAD", "0"));
+                if (magnitude > 2147483647LL) {
+                    // The smallest word has no positive counterpart
+                    program.add_instruction(Instruction("SUB", "2147483647"));
+                    magnitude -= 2147483647LL;
+                }
+                ostringstream operand;
+                operand << magnitude;
+                program.add_instruction(Instruction("SUB", operand.str()));
+                program.add_instruction(Instruction("STORE", found->second));
+            }
+        }
+
+        program.add_instruction(Instruction("WRITE", found->second));
+    }
+
+    program.add_instruction(Instruction("STOP"));
+    return program;
+}
+
+// Setters
+void Partial_Evaluator::set_step_budget(size_t budget) { step_budget = budget; }
+
+void Partial_Evaluator::set_output_limit(size_t limit) { output_limit = limit; }
+
+// Member functions
+
+/** Run the program from its first statement.
+ *  The evaluation stops at the first read, since the output then depends on the input,
+ *  and at anything the target would not compute the same way (overflow, division by zero).
+ *  @return True if the program ran to the end, false otherwise (see get_failure)
+ */
+bool Partial_Evaluator::evaluate() {
+    variables.clear();
+    output.clear();
+    steps = 0;
+    failure.clear();
+    functions.clear();
+
+    Tree::find_functions(tree.get_root(), functions);
+    return execute(tree.get_root());
+}
+
+// Record why the evaluation stopped
+bool Partial_Evaluator::fail(const string& reason) {
+    if (failure.empty()) { failure = reason; }
+    return false;
+}
+
+// Count one step, false once the budget is exhausted
+bool Partial_Evaluator::count_step() {
+    if (++steps > step_budget) { return fail("step budget exceeded"); }
+    return true;
+}
+
+// Check that a value fits in a machine word
+bool Partial_Evaluator::check_word(long long value) {
+    const long long word_limit = 2147483647LL;
+    if (value > word_limit || value < -word_limit - 1) { return fail("arithmetic overflow"); }
+    return true;
+}
+
+// Execute a statement-level node
+bool Partial_Evaluator::execute(const Node& node) {
+    const string& data = node.get_data();
+    const vector<Node>& children = node.get_children();
+
+    if (data == "<vars>" || data == "<funcs>") {
+        // Declarations do not initialize storage, which starts at 0, and funcs only run when called
+        return true;
+    } else if (data == "<call>") {
+        return count_step() && execute(*functions[children.at(1).get_data()]);
+    } else if (data == "<read>") {
+        return fail("the program reads input");
+    } else if (data == "<print>") {
+        long long value;
+        if (!count_step() || !evaluate_exp(children.at(1), value)) { return false; }
+        if (output.size() == output_limit) { return fail("too much output"); }
+        output.push_back(value);
+        return true;
+    } else if (data == "<assign>") {
+        long long value;
+        if (!count_step() || !evaluate_exp(children.at(2), value)) { return false; }
+        variables[children.at(1).get_data()] = value;
+        return true;
+    } else if (data == "<cond>") {
+        return execute_cond(node);
+    } else if (data == "<iter>") {
+        return execute_iter(node);
+    }
+
+    // <program>, <block>, <stats>, <mStat> and <stat> only group statements
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (!execute(children.at(i))) { return false; }
+    }
+    return true;
+}
+
+// Execute iff [ <exp> <relational> <exp> ] <stat>
+bool Partial_Evaluator::execute_cond(const Node& node) {
+    bool holds;
+    if (!count_step() || !evaluate_compare(node, holds)) { return false; }
+    return !holds || execute(node.get_children().at(6));
+}
+
+// Execute iterate [ <exp> <relational> <exp> ] <stat>
+bool Partial_Evaluator::execute_iter(const Node& node) {
+    while (true) {
+        bool holds;
+        if (!count_step() || !evaluate_compare(node, holds)) { return false; }
+        if (!holds) { return true; }
+        if (!execute(node.get_children().at(6))) { return false; }
+    }
+}
+
+/** Evaluate the [ <exp> <relational> <exp> ] of an <iff> or <iterate>.
+ *  Like the generated code, the relation is decided by the sign of (left - right).
+ *  @param node The <cond> or <iter> node
+ *  @param holds Receives whether the relation holds
+ *  @return True if the comparison was evaluated, false otherwise
+ */
+bool Partial_Evaluator::evaluate_compare(const Node& node, bool& holds) {
+    const vector<Node>& children = node.get_children();
+    long long left, right;
+
+    if (!evaluate_exp(children.at(2), left) || !evaluate_exp(children.at(4), right)) { return false; }
+    if (!check_word(left - right)) { return false; }
+
+    const Node& relational = children.at(3);
+    const string& rel_op = relational.get_children().empty() ? relational.get_data() : relational.get_children().at(0).get_data();
+    holds = evaluate_relation(rel_op, left - right);
+    return true;
+}
+
+// Evaluate an <exp>, <M>, <N> or <R>
+bool Partial_Evaluator::evaluate_value(const Node& node, long long& value) {
+    const string& data = node.get_data();
+
+    if (data == "<exp>") { return evaluate_exp(node, value); }
+    if (data == "<M>") { return evaluate_m(node, value); }
+    if (data == "<N>") { return evaluate_n(node, value); }
+    return evaluate_r(node, value);
+}
+
+/** Evaluate <M> + <exp> | <M> - <exp> | <M>.
+ *  The parser flattens the operators into one list, which groups to the right like the generator does.
+ *  @param node The <exp> node
+ *  @param value Receives the value of the expression
+ *  @return True if the expression was evaluated, false otherwise
+ */
+bool Partial_Evaluator::evaluate_exp(const Node& node, long long& value) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() >= 3 && (children.at(1).get_data() == "+" || children.at(1).get_data() == "-")) {
+        long long left, right;
+        if (children.size() == 3) {
+            if (!evaluate_m(children.at(2), right)) { return false; }
+        } else {
+            Node sub_exp("<exp>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_exp.add_child(children.at(i)); }
+            if (!evaluate_exp(sub_exp, right)) { return false; }
+        }
+        if (!evaluate_m(children.at(0), left) || !count_step()) { return false; }
+
+        value = children.at(1).get_data() == "+" ? left + right : left - right;
+        return check_word(value);
+    }
+
+    if (children.size() == 1) { return evaluate_m(children.at(0), value); }
+
+    return fail("invalid <exp> node structure");
+}
+
+// Evaluate <N> % <M> | <N>
+bool Partial_Evaluator::evaluate_m(const Node& node, long long& value) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() == 1) { return evaluate_n(children.at(0), value); }
+
+    if (children.size() >= 3 && children.at(1).get_data() == "%") {
+        long long left, right;
+        if (children.size() == 3) {
+            if (!evaluate_m(children.at(2), right)) { return false; }
+        } else {
+            Node sub_m("<M>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_m.add_child(children.at(i)); }
+            if (!evaluate_m(sub_m, right)) { return false; }
+        }
+        if (!evaluate_n(children.at(0), left) || !count_step()) { return false; }
+
+        value = left * right;
+        return check_word(value);
+    }
+
+    return evaluate_n(node, value);
+}
+
+// Evaluate <R> / <N> | - <N> | <R>
+bool Partial_Evaluator::evaluate_n(const Node& node, long long& value) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() == 1) { return evaluate_r(children.at(0), value); }
+
+    if (children.size() == 2 && children.at(0).get_data() == "-") {
+        long long operand;
+        if (!evaluate_n(children.at(1), operand) || !count_step()) { return false; }
+
+        value = -operand;
+        return check_word(value);
+    }
+
+    if (children.size() >= 3 && children.at(1).get_data() == "/") {
+        long long left, right;
+        if (children.size() == 3) {
+            if (!evaluate_value(children.at(2), right)) { return false; }
+        } else {
+            Node sub_n("<N>");
+            for (size_t i = 2; i < children.size(); ++i) { sub_n.add_child(children.at(i)); }
+            if (!evaluate_n(sub_n, right)) { return false; }
+        }
+        if (!evaluate_r(children.at(0), left) || !count_step()) { return false; }
+        if (right == 0) { return fail("division by zero"); }
+
+        value = left / right;
+        return check_word(value);
+    }
+
+    return fail("unexpected structure in <N> node");
+}
+
+// Evaluate ( <exp> ) | identifier | integer
+bool Partial_Evaluator::evaluate_r(const Node& node, long long& value) {
+    const vector<Node>& children = node.get_children();
+
+    if (children.size() == 1) {
+        const string& data = children.at(0).get_data();
+        if (!data.empty() && isdigit(data.at(0))) {
+            value = atoll(data.c_str());
+            return check_word(value);
+        }
+
+        // A variable that was never assigned still holds its initial 0
+        map<string, long long>::const_iterator found = variables.find(data);
+        value = found == variables.end() ? 0 : found->second;
+        return true;
+    }
+
+    if (children.size() == 3 && children.at(0).get_data() == "(" && children.at(2).get_data() == ")") {
+        return evaluate_exp(children.at(1), value);
+    }
+
+    if (children.size() > 1) {
+        Node exp("<exp>");
+        for (size_t i = 0; i < children.size(); ++i) { exp.add_child(children.at(i)); }
+        return evaluate_exp(exp, value);
+    }
+
+    return fail("unexpected structure in <R> node");
+}
+
+// Evaluate a relational operator given (left - right)
+bool Partial_Evaluator::evaluate_relation(const string& rel_op, long long difference) {
+    if (rel_op == ".ge.") { return difference >= 0; }
+    if (rel_op == ".le.") { return difference <= 0; }
+    if (rel_op == ".gt.") { return difference > 0; }
+    if (rel_op == ".lt.") { return difference < 0; }
+    if (rel_op == "**") { return difference == 0; }
+    return difference != 0; // ~
+}
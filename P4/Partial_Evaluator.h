@@ -0,0 +1,67 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef PARTIAL_EVALUATOR_H
+#define PARTIAL_EVALUATOR_H
+
+#include "Tree.h"
+#include "Program.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::string;
+using std::vector;
+
+// Runs a program at compile time when its output does not depend on any input,
+// so that only the writes of the results have to be generated
+class Partial_Evaluator {
+public:
+    // Constructors
+    Partial_Evaluator(const Tree&);
+
+    // Getters
+    const vector<long long>& get_output() const;
+    size_t get_steps() const;
+    const string& get_failure() const;
+    Program get_program() const;
+
+    // Setters
+    void set_step_budget(size_t); // Maximum number of statements and operators to evaluate
+    void set_output_limit(size_t); // Maximum number of values the program may write
+
+    // Member functions
+    bool evaluate(); // Run the program, false if it reads input, errs or runs out of budget
+
+private:
+    // Data fields
+    const Tree& tree; // The parse tree to evaluate
+    map<string, const Node*> functions; // The <block> of each func, by name
+    map<string, long long> variables; // Current value of every variable that was assigned
+    vector<long long> output; // The values written so far
+    size_t steps; // Statements and operators evaluated so far
+    size_t step_budget; // Maximum number of steps
+    size_t output_limit; // Maximum number of values written
+    string failure; // Why the evaluation stopped, empty if it finished
+
+    // Member functions
+    bool fail(const string&); // Record why the evaluation stopped
+    bool count_step(); // Count one step, false once the budget is exhausted
+    bool check_word(long long); // Check that a value fits in a machine word
+
+    bool execute(const Node&); // Execute a statement-level node
+    bool execute_cond(const Node&); // Execute an <iff>
+    bool execute_iter(const Node&); // Execute an <iterate>
+    bool evaluate_compare(const Node&, bool&); // Evaluate the [ <exp> <relational> <exp> ] of a <cond> or <iter>
+    bool evaluate_value(const Node&, long long&); // Evaluate an <exp>, <M>, <N> or <R>
+    bool evaluate_exp(const Node&, long long&); // Evaluate an <exp>
+    bool evaluate_m(const Node&, long long&); // Evaluate an <M>
+    bool evaluate_n(const Node&, long long&); // Evaluate an <N>
+    bool evaluate_r(const Node&, long long&); // Evaluate an <R>
+    static bool evaluate_relation(const string&, long long); // Evaluate a relational operator given (left - right)
+};
+
+#endif // PARTIAL_EVALUATOR_H
@@ -0,0 +1,400 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Pass_Manager.h"
+#include "Generator.h"
+#include "Optimizer.h"
+#include "IR_Builder.h"
+#include "IR_Lowering.h"
+#include "IR_Optimizer.h"
+#include "Partial_Evaluator.h"
+#include "Utility.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using std::cerr;
+using std::endl;
+using std::ofstream;
+using std::ostringstream;
+using std::setw;
+
+// Every pass and analysis, in the order -O2 runs the passes
+const Pass_Manager::Pass_Info Pass_Manager::passes[] = {
+    { "peval", PASS_CODEGEN, "", "Run programs that read no input at compile time and write only their output" },
+    { "simplify", PASS_CODEGEN, "", "Apply the algebraic rewrite rules to expressions" },
+    { "licm", PASS_CODEGEN, "", "Hoist loop-invariant expressions out of iterate loops" },
+    { "unroll", PASS_CODEGEN, "", "Unroll iterate loops with a trip count known at compile time" },
+    { "inline", PASS_CODEGEN, "", "Inline the funcs the cost model finds worth it instead of calling them" },
+    { "sccp", PASS_IR, "", "Sparse conditional constant propagation (SSA)" },
+    { "ir-dce", PASS_IR, "", "Remove SSA instructions whose values are never used (SSA)" },
+    { "ccp", PASS_PROGRAM, "cfg", "Conditional constant propagation across the basic blocks of the program" },
+    { "lvn", PASS_PROGRAM, "", "Local value numbering and constant folding" },
+    { "superopt", PASS_PROGRAM, "liveness", "Replace short straight-line windows by the shortest equivalent sequence" },
+    { "dse", PASS_PROGRAM, "liveness", "Dead store elimination and storage pruning" },
+    { "dominators", PASS_ANALYSIS, "", "Immediate dominators of the SSA blocks" },
+    { "cfg", PASS_ANALYSIS, "", "Basic blocks, dominator tree and loop nesting of the program" },
+    { "liveness", PASS_ANALYSIS, "cfg", "Variables live after each instruction" }
+};
+
+const size_t Pass_Manager::pass_count = sizeof(Pass_Manager::passes) / sizeof(Pass_Manager::passes[0]);
+
+// Constructors
+Pass_Manager::Pass_Manager() : ssa(false), evaluation_budget(100000), instrument(false) {
+    set_level(1); // The cheap passes; the costly and loop-changing ones need -O2
+}
+
+// Getters
+const vector<string>& Pass_Manager::get_pipeline() const { return pipeline; }
+
+bool Pass_Manager::uses_ssa() const { return ssa; }
+
+const map<string, size_t>& Pass_Manager::get_rule_counts() const { return rule_counts; }
+
+// Setters
+
+/** Select the passes of an optimization level.
+ *  -O0 generates code straight from the parse tree, -O1 adds the rewrite rules, constant propagation,
+ *  value numbering and dead store elimination, and -O2 adds partial evaluation, the loop transformations,
+ *  inlining and the superoptimizer. The SSA passes only run with -fssa; ccp does on the lowered program
+ *  what sccp does on the SSA form, so constants cross branches without it too.
+ *  @param level 0, 1 or 2; higher levels are treated as 2
+ */
+void Pass_Manager::set_level(size_t level) {
+    pipeline.clear();
+    if (level == 0) { return; }
+
+    if (level >= 2) { pipeline.push_back("peval"); }
+    pipeline.push_back("simplify");
+    if (level >= 2) {
+        pipeline.push_back("licm");
+        pipeline.push_back("unroll");
+        pipeline.push_back("inline");
+    }
+    pipeline.push_back("sccp");
+    if (level >= 2) { pipeline.push_back("ir-dce"); }
+    pipeline.push_back("ccp");
+    pipeline.push_back("lvn");
+    if (level >= 2) { pipeline.push_back("superopt"); }
+    pipeline.push_back("dse");
+}
+
+/** Select the passes to run from a comma-separated list, e.g. "simplify,lvn".
+ *  Listing an SSA pass turns on the SSA pipeline.
+ *  @param list The pass names in the order they should run
+ *  @return True if every name is a pass, false otherwise
+ */
+bool Pass_Manager::set_pipeline(const string& list) {
+    vector<string> names;
+    std::istringstream iss(list);
+    string name;
+
+    while (getline(iss, name, ',')) {
+        if (name.empty()) { continue; }
+
+        const Pass_Info* pass = find_pass(name);
+        if (pass == NULL || pass->kind == PASS_ANALYSIS) { return false; }
+        if (pass->kind == PASS_IR) { ssa = true; }
+        names.push_back(name);
+    }
+
+    pipeline = names;
+    return true;
+}
+
+void Pass_Manager::set_ssa(bool enabled) { ssa = enabled; }
+
+void Pass_Manager::set_ir_file(const string& file) { ir_file = file; }
+
+void Pass_Manager::set_cfg_file(const string& file) { cfg_file = file; }
+
+void Pass_Manager::set_evaluation_budget(size_t budget) { evaluation_budget = budget; }
+
+/** Load the superoptimizer rules of a database file; the rules found while compiling are written back to it.
+ *  @param file The database file, which does not need to exist yet
+ */
+void Pass_Manager::set_rule_file(const string& file) {
+    rule_file = file;
+    superoptimizer.load_rules(file);
+}
+
+/** Load the superoptimizer rules of a database file that the rules found while compiling are not written to.
+ *  @param file The database file
+ *  @return True if the file was read, false if it could not be opened
+ */
+bool Pass_Manager::add_rule_file(const string& file) { return superoptimizer.load_rules(file); }
+
+void Pass_Manager::set_superoptimizer_search(bool enabled) { superoptimizer.set_search(enabled); }
+
+void Pass_Manager::set_superoptimizer_budget(size_t budget) { superoptimizer.set_compile_budget(budget); }
+
+void Pass_Manager::set_instrumentation(bool enabled) { instrument = enabled; }
+
+/** Read the output of an instrumented run; the counters are the numbers at its end.
+ *  @param file The saved output
+ *  @return True if the file was read, false if it could not be opened or holds something other than numbers
+ */
+bool Pass_Manager::set_profile_file(const string& file) {
+    std::ifstream fin(file.c_str());
+    if (!fin.is_open()) { return false; }
+
+    profile.clear();
+    long long value;
+    while (fin >> value) { profile.push_back(value); }
+    return fin.eof();
+}
+
+// Member functions
+
+/** Generate and optimize the program for a parse tree.
+ *  A program that partial evaluation runs to the end needs no code generation at all.
+ *  Otherwise the code generation passes configure the Generator (or are ignored on the SSA path),
+ *  the SSA passes run between building and lowering the SSA form, and the program passes
+ *  run last, each in the order of the pipeline. Only the Generator instruments code and
+ *  uses a profile, so either one skips the SSA path.
+ *  @param parse_tree The checked parse tree
+ *  @return: the program
+ */
+Program Pass_Manager::compile(const Tree& parse_tree) {
+    typedef std::chrono::steady_clock Clock;
+    Program program;
+    statistics.clear();
+    rule_counts.clear();
+    valid_analyses.clear();
+
+    if (is_enabled("peval") && !instrument && evaluate_program(parse_tree, program)) {
+        // The output is known, only the program passes are left
+    } else if (ssa && !instrument && profile.empty()) {
+        Clock::time_point start = Clock::now();
+        IR_Builder builder(parse_tree);
+        builder.build();
+        IR_Module module = builder.get_module();
+        record("ir-build", std::chrono::duration<double, std::milli>(Clock::now() - start).count(), 0, count_instructions(module), 0, module.get_variables().size());
+
+        verify_module(module);
+        for (size_t i = 0; i < pipeline.size(); ++i) {
+            if (find_pass(pipeline.at(i))->kind == PASS_IR) { run_ir_pass(pipeline.at(i), module); }
+        }
+
+        if (!ir_file.empty()) {
+            ofstream fout(ir_file.c_str());
+            fout << module.dump();
+        }
+
+        start = Clock::now();
+        IR_Lowering lowering(module);
+        lowering.lower();
+        program = lowering.get_program();
+        record("ir-lower", std::chrono::duration<double, std::milli>(Clock::now() - start).count(), count_instructions(module), program.get_instructions().size(), module.get_variables().size(), program.get_storage().size());
+    } else {
+        Clock::time_point start = Clock::now();
+        Generator generator(parse_tree);
+        generator.set_simplify_expressions(is_enabled("simplify"));
+        generator.set_hoist_invariants(is_enabled("licm"));
+        generator.set_unroll_loops(is_enabled("unroll"));
+        generator.set_inline_functions(is_enabled("inline"));
+        generator.set_instrumentation(instrument);
+        generator.set_profile(profile);
+        generator.generate();
+        program = generator.get_program();
+        rule_counts = generator.get_rule_counts();
+        record("generate", std::chrono::duration<double, std::milli>(Clock::now() - start).count(), 0, program.get_instructions().size(), 0, program.get_storage().size());
+    }
+
+    valid_analyses.clear();
+    for (size_t i = 0; i < pipeline.size(); ++i) {
+        if (find_pass(pipeline.at(i))->kind == PASS_PROGRAM) { run_program_pass(pipeline.at(i), program); }
+    }
+
+    if (!cfg_file.empty()) {
+        require("cfg", NULL, &program);
+        ofstream fout(cfg_file.c_str());
+        fout << cfg.to_dot();
+    }
+
+    // Keep what the superoptimizer found for the next compilation
+    if (!rule_file.empty() && superoptimizer.get_learned_count() > 0) {
+        superoptimizer.save_rules(rule_file);
+    }
+
+    return program;
+}
+
+/** Per-pass time and sizes of the last compilation.
+ *  @return: a table with one line per step
+ */
+string Pass_Manager::get_statistics() const {
+    ostringstream oss;
+    oss << std::left << setw(12) << "pass" << std::right << setw(12) << "time (ms)" << setw(20) << "instructions" << setw(16) << "data words" << "\n";
+
+    for (size_t i = 0; i < statistics.size(); ++i) {
+        const Statistic& statistic = statistics.at(i);
+        ostringstream instructions;
+        ostringstream data;
+        instructions << statistic.instructions_before << " -> " << statistic.instructions_after;
+        data << statistic.data_before << " -> " << statistic.data_after;
+
+        oss << std::left << setw(12) << statistic.name << std::right << setw(12) << std::fixed << std::setprecision(3) << statistic.milliseconds
+            << setw(20) << instructions.str() << setw(16) << data.str() << "\n";
+    }
+
+    if (ssa) { oss << "(SSA passes count SSA instructions and variables)\n"; }
+    return oss.str();
+}
+
+// One line per pass and analysis
+string Pass_Manager::describe_passes() {
+    static const char* kinds[] = { "codegen", "ssa", "program", "analysis" };
+    ostringstream oss;
+
+    for (size_t i = 0; i < pass_count; ++i) {
+        oss << std::left << setw(12) << passes[i].name << setw(10) << kinds[passes[i].kind] << passes[i].description;
+        if (passes[i].requires[0] != '\0') { oss << " (uses " << passes[i].requires << ")"; }
+        oss << "\n";
+    }
+    return oss.str();
+}
+
+// Look up a pass by name
+const Pass_Manager::Pass_Info* Pass_Manager::find_pass(const string& name) {
+    for (size_t i = 0; i < pass_count; ++i) {
+        if (name == passes[i].name) { return &passes[i]; }
+    }
+    return NULL;
+}
+
+// Check if a pass is in the pipeline
+bool Pass_Manager::is_enabled(const string& name) const {
+    for (size_t i = 0; i < pipeline.size(); ++i) {
+        if (pipeline.at(i) == name) { return true; }
+    }
+    return false;
+}
+
+/** Compute an analysis unless a result for the current code is cached.
+ *  @param name The analysis
+ *  @param module The SSA form, for SSA analyses
+ *  @param program The lowered program, for program analyses
+ */
+void Pass_Manager::require(const string& name, const IR_Module* module, const Program* program) {
+    if (valid_analyses.count(name)) { return; }
+
+    if (name == "dominators" && module != NULL) {
+        dominators = module->get_dominators();
+    } else if (name == "cfg" && program != NULL) {
+        cfg.build(*program);
+    } else if (name == "liveness" && program != NULL) {
+        require("cfg", NULL, program);
+        Program copy = *program;
+        liveness = Optimizer(copy).get_live_variables(cfg);
+    } else {
+        return;
+    }
+    valid_analyses.insert(name);
+}
+
+/** Run a program at compile time and generate only the writes of its output.
+ *  @param parse_tree The checked parse tree
+ *  @param program Receives the writes when the evaluation finishes
+ *  @return True if the program ran to the end within the budget, false to generate code normally
+ */
+bool Pass_Manager::evaluate_program(const Tree& parse_tree, Program& program) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+
+    Partial_Evaluator evaluator(parse_tree);
+    evaluator.set_step_budget(evaluation_budget);
+    bool finished = evaluator.evaluate();
+    if (finished) { program = evaluator.get_program(); }
+
+    record("peval", std::chrono::duration<double, std::milli>(Clock::now() - start).count(), 0, program.get_instructions().size(), 0, program.get_storage().size());
+    return finished;
+}
+
+// Stop if the SSA form is invalid
+void Pass_Manager::verify_module(const IR_Module& module) {
+    require("dominators", &module, NULL);
+
+    vector<string> errors;
+    if (!module.verify(errors, dominators)) {
+        for (size_t i = 0; i < errors.size(); ++i) { cerr << errors.at(i) << endl; }
+        exit_error("[Error] Invalid SSA form.");
+    }
+}
+
+/** Run a pass over the SSA form, then verify the result if the pass changed anything.
+ *  @param name The pass
+ *  @param module The SSA form
+ */
+void Pass_Manager::run_ir_pass(const string& name, IR_Module& module) {
+    typedef std::chrono::steady_clock Clock;
+
+    const Pass_Info* pass = find_pass(name);
+    if (pass->requires[0] != '\0') { require(pass->requires, &module, NULL); }
+
+    string before = module.dump();
+    size_t instructions_before = count_instructions(module);
+    size_t variables_before = module.get_variables().size();
+    Clock::time_point start = Clock::now();
+
+    IR_Optimizer optimizer(module);
+    if (name == "sccp") { optimizer.constant_propagation(); }
+    else if (name == "ir-dce") { optimizer.remove_dead_code(); }
+
+    record(name, std::chrono::duration<double, std::milli>(Clock::now() - start).count(), instructions_before, count_instructions(module), variables_before, module.get_variables().size());
+
+    if (module.dump() != before) {
+        valid_analyses.clear();
+        verify_module(module);
+    }
+}
+
+/** Run a pass over the lowered program.
+ *  @param name The pass
+ *  @param program The program
+ */
+void Pass_Manager::run_program_pass(const string& name, Program& program) {
+    typedef std::chrono::steady_clock Clock;
+
+    const Pass_Info* pass = find_pass(name);
+    if (pass->requires[0] != '\0') { require(pass->requires, NULL, &program); }
+
+    string before = program.to_string();
+    size_t instructions_before = program.get_instructions().size();
+    size_t data_before = program.get_storage().size();
+    Clock::time_point start = Clock::now();
+
+    Optimizer optimizer(program);
+    if (name == "ccp") { optimizer.constant_propagation(cfg); }
+    else if (name == "lvn") { optimizer.value_numbering(); }
+    else if (name == "superopt") { superoptimizer.optimize(program, liveness); }
+    else if (name == "dse") { optimizer.dead_store_elimination(liveness); }
+
+    record(name, std::chrono::duration<double, std::milli>(Clock::now() - start).count(), instructions_before, program.get_instructions().size(), data_before, program.get_storage().size());
+
+    if (program.to_string() != before) { valid_analyses.clear(); }
+}
+
+// Add a statistics entry
+void Pass_Manager::record(const string& name, double milliseconds, size_t instructions_before, size_t instructions_after, size_t data_before, size_t data_after) {
+    Statistic statistic;
+    statistic.name = name;
+    statistic.milliseconds = milliseconds;
+    statistic.instructions_before = instructions_before;
+    statistic.instructions_after = instructions_after;
+    statistic.data_before = data_before;
+    statistic.data_after = data_after;
+    statistics.push_back(statistic);
+}
+
+// Number of SSA instructions
+size_t Pass_Manager::count_instructions(const IR_Module& module) {
+    size_t count = 0;
+    const vector<IR_Block>& blocks = module.get_blocks();
+    for (size_t i = 0; i < blocks.size(); ++i) { count += blocks.at(i).instructions.size(); }
+    return count;
+}
@@ -0,0 +1,113 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef PASS_MANAGER_H
+#define PASS_MANAGER_H
+
+#include "Tree.h"
+#include "IR.h"
+#include "Program.h"
+#include "Control_Flow_Graph.h"
+#include "Superoptimizer.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+// Runs the compilation pipeline: code generation, then the selected optimization passes in order
+class Pass_Manager {
+public:
+    // Constructors
+    Pass_Manager(); // Starts with the passes of -O1
+
+    // Getters
+    const vector<string>& get_pipeline() const;
+    bool uses_ssa() const;
+    const map<string, size_t>& get_rule_counts() const; // Number of times each rewrite rule applied in the last compilation
+
+    // Setters
+    void set_level(size_t); // Select the passes of -O0, -O1 or -O2
+    bool set_pipeline(const string&); // Select a comma-separated list of passes, false if a name is unknown
+    void set_ssa(bool); // Generate code through the SSA form
+    void set_ir_file(const string&); // File to write the final SSA form to, empty for none
+    void set_cfg_file(const string&); // File to write the control-flow graph of the final program to, empty for none
+    void set_evaluation_budget(size_t); // Maximum number of steps partial evaluation may take
+    void set_rule_file(const string&); // Load the superoptimizer rules of a file and save new ones to it
+    bool add_rule_file(const string&); // Load the superoptimizer rules of a file without saving to it
+    void set_superoptimizer_search(bool); // Let the superoptimizer search windows no rule covers
+    void set_superoptimizer_budget(size_t); // Maximum number of candidates the superoptimizer tries per compilation
+    void set_instrumentation(bool); // Generate code that writes branch counters after its output
+    bool set_profile_file(const string&); // Read the output of an instrumented run to lay out the branches
+
+    // Member functions
+    Program compile(const Tree&); // Generate and optimize the program for a parse tree
+    string get_statistics() const; // Per-pass time and sizes of the last compilation
+    static string describe_passes(); // One line per pass and analysis
+
+private:
+    // Where a pass runs
+    enum Pass_Kind {
+        PASS_CODEGEN, // Changes how the Generator emits code
+        PASS_IR, // Transforms the SSA form
+        PASS_PROGRAM, // Transforms the lowered program
+        PASS_ANALYSIS // Computes a result other passes use, cached until something changes
+    };
+
+    struct Pass_Info {
+        const char* name; // The name used on the command line
+        Pass_Kind kind; // Where the pass runs
+        const char* requires; // Analysis the pass needs, empty if none
+        const char* description; // One-line summary
+    };
+
+    struct Statistic {
+        string name; // The pass or step
+        double milliseconds; // Wall time
+        size_t instructions_before; // Instructions before (SSA instructions for IR passes)
+        size_t instructions_after; // Instructions after
+        size_t data_before; // Data words before (variables for IR passes)
+        size_t data_after; // Data words after
+    };
+
+    // Data fields
+    vector<string> pipeline; // The selected passes in the order they run
+    bool ssa; // Generate code through the SSA form
+    string ir_file; // File to write the final SSA form to
+    string cfg_file; // File to write the control-flow graph of the final program to
+    size_t evaluation_budget; // Maximum number of steps partial evaluation may take
+    Superoptimizer superoptimizer; // Keeps its rules from one compilation to the next
+    string rule_file; // Database file of the superoptimizer rules, empty for none
+    bool instrument; // Generate code that writes branch counters after its output
+    vector<long long> profile; // Output of an instrumented run, empty if none
+    vector<Statistic> statistics; // One entry per step of the last compilation
+    map<string, size_t> rule_counts; // Number of times each rewrite rule applied in the last compilation
+
+    // Cached analyses
+    set<string> valid_analyses; // Analyses whose results match the current code
+    vector<size_t> dominators; // "dominators": immediate dominator of each SSA block
+    Control_Flow_Graph cfg; // "cfg": basic blocks, dominators and loops of the program
+    vector<set<string> > liveness; // "liveness": variables live after each instruction
+
+    static const Pass_Info passes[]; // Every pass and analysis
+    static const size_t pass_count; // Number of entries in passes
+
+    // Member functions
+    static const Pass_Info* find_pass(const string&); // Look up a pass by name
+    bool is_enabled(const string&) const; // Check if a pass is in the pipeline
+    void require(const string&, const IR_Module*, const Program*); // Compute an analysis unless it is cached
+    bool evaluate_program(const Tree&, Program&); // Run a program that reads no input at compile time
+    void verify_module(const IR_Module&); // Stop if the SSA form is invalid
+    void run_ir_pass(const string&, IR_Module&); // Run a pass over the SSA form
+    void run_program_pass(const string&, Program&); // Run a pass over the lowered program
+    void record(const string&, double, size_t, size_t, size_t, size_t); // Add a statistics entry
+    static size_t count_instructions(const IR_Module&); // Number of SSA instructions
+};
+
+#endif // PASS_MANAGER_H
@@ -0,0 +1,108 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Program.h"
+
+#include <cctype>
+
+// Constructors
+Instruction::Instruction(const string& opcode, const string& operand, const string& label)
+    : label(label), opcode(opcode), operand(operand), line(0) {}
+
+Program::Program() {}
+
+/** Name of a generated variable
+ *  @param kind T for a temporary, R for a return slot, P for a profile counter
+ *  @param number Its number
+ *  @return: The prefix, the kind and the number, e.g. $T0
+ */
+string generated_name(char kind, size_t number) {
+    ostringstream name;
+    name << GENERATED_PREFIX << kind << number;
+    return name.str();
+}
+
+// Instruction member functions
+
+// Check if the instruction is BR or a conditional branch
+bool Instruction::is_branch() const {
+    return opcode == "BR" || is_conditional_branch();
+}
+
+// Check if the instruction is a conditional branch
+bool Instruction::is_conditional_branch() const {
+    return opcode == "BRNEG" || opcode == "BRZNEG" || opcode == "BRPOS" || opcode == "BRZPOS" || opcode == "BRZERO";
+}
+
+// Check if control does not simply fall through to the next instruction
+bool Instruction::ends_block() const {
+    return is_branch() || opcode == "STOP";
+}
+
+// Check if the instruction is ADD, SUB, MULT or DIV
+bool Instruction::is_arithmetic() const {
+    return opcode == "ADD" || opcode == "SUB" || opcode == "MULT" || opcode == "DIV";
+}
+
+// Check if the operand is an integer
+bool Instruction::has_immediate_operand() const {
+    return !operand.empty() && (isdigit(static_cast<unsigned char>(operand.at(0))) || operand.at(0) == '-');
+}
+
+// Check if the instruction reads the variable in its operand
+bool Instruction::reads_memory() const {
+    return (opcode == "LOAD" || opcode == "WRITE" || is_arithmetic()) && !operand.empty() && !has_immediate_operand();
+}
+
+// Check if the instruction writes the variable in its operand
+bool Instruction::writes_memory() const {
+    return opcode == "STORE" || opcode == "READ";
+}
+
+/** Converts the instruction to a line of assembly.
+    @return: the instruction as "label: OPCODE operand"
+*/
+string Instruction::to_string() const {
+    ostringstream oss;
+    if (!label.empty()) { oss << label << ": "; }
+    oss << opcode;
+    if (!operand.empty()) { oss << " " << operand; }
+    return oss.str();
+}
+
+// Program getters
+
+vector<Instruction>& Program::get_instructions() { return instructions; }
+
+const vector<Instruction>& Program::get_instructions() const { return instructions; }
+
+vector<string>& Program::get_storage() { return storage; }
+
+const vector<string>& Program::get_storage() const { return storage; }
+
+// Program member functions
+
+// Append an instruction
+void Program::add_instruction(const Instruction& instruction) {
+    instructions.push_back(instruction);
+}
+
+// Append a storage directive for a variable
+void Program::add_storage(const string& variable_name) {
+    storage.push_back(variable_name);
+}
+
+/** Converts the program to assembly text.
+    @return: one instruction per line, followed by one storage directive per variable
+*/
+string Program::to_string() const {
+    ostringstream oss;
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        oss << instructions.at(i).to_string() << "\n";
+    }
+    for (size_t i = 0; i < storage.size(); ++i) {
+        oss << storage.at(i) << " 0\n";
+    }
+    return oss.str();
+}
@@ -0,0 +1,66 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+
+using std::string;
+using std::vector;
+using std::ostringstream;
+
+// Variables the compiler generates start with this character. No identifier of the source can,
+// so a temporary, a return slot or a profile counter never shares a name with a variable.
+const char GENERATED_PREFIX = '$';
+
+string generated_name(char, size_t); // Name of a generated variable, e.g. $T0 for temporary 0
+
+// A single line of the target assembly: [label:] OPCODE [operand]
+struct Instruction {
+    string label; // Label attached to the instruction, empty if none
+    string opcode; // The instruction name, e.g. LOAD
+    string operand; // A variable, an integer, a label or empty
+    size_t line; // Source line of the statement that produced the instruction, 0 if none did
+
+    // Constructors
+    Instruction(const string& = "", const string& = "", const string& = "");
+
+    // Member functions
+    bool is_branch() const; // Check if the instruction is BR or a conditional branch
+    bool is_conditional_branch() const; // Check if the instruction is a conditional branch
+    bool ends_block() const; // Check if control does not simply fall through to the next instruction
+    bool is_arithmetic() const; // Check if the instruction is ADD, SUB, MULT or DIV
+    bool has_immediate_operand() const; // Check if the operand is an integer
+    bool reads_memory() const; // Check if the instruction reads the variable in its operand
+    bool writes_memory() const; // Check if the instruction writes the variable in its operand
+    string to_string() const; // Convert the instruction to a line of assembly
+};
+
+// The lowered program: the instructions followed by the storage directives
+class Program {
+public:
+    // Constructors
+    Program();
+
+    // Getters
+    vector<Instruction>& get_instructions();
+    const vector<Instruction>& get_instructions() const;
+    vector<string>& get_storage();
+    const vector<string>& get_storage() const;
+
+    // Member functions
+    void add_instruction(const Instruction&); // Append an instruction
+    void add_storage(const string&); // Append a storage directive for a variable
+    string to_string() const; // Convert the program to assembly text
+
+private:
+    // Data fields
+    vector<Instruction> instructions; // The instructions in program order
+    vector<string> storage; // The variables allocated after the instructions
+};
+
+#endif // PROGRAM_H
@@ -0,0 +1,320 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Register_Translator.h"
+#include "Virtual_Machine.h"
+
+#include <sstream>
+
+using std::ostringstream;
+
+namespace {
+    const char* const register_opcode_names[REG_OPCODE_COUNT] = {
+        "MOVE", "MOVE_I", "ADD", "ADD_I", "SUB", "SUB_I", "MULT", "MULT_I", "DIV", "DIV_I",
+        "READ", "WRITE", "WRITE_I", "BR",
+        "BRNEG", "BRNEG_I", "BRZNEG", "BRZNEG_I", "BRPOS", "BRPOS_I", "BRZPOS", "BRZPOS_I", "BRZERO", "BRZERO_I",
+        "STOP", "END"
+    };
+
+    // The register opcode of an accumulator operator, with a variable or an integer
+    int32_t operator_of(int32_t opcode) {
+        switch (opcode) {
+        case VM_ADD: case VM_ADD_I: return REG_ADD;
+        case VM_SUB: case VM_SUB_I: return REG_SUB;
+        case VM_MULT: case VM_MULT_I: return REG_MULT;
+        default: return REG_DIV;
+        }
+    }
+
+    inline bool is_conditional_branch(int32_t opcode) { return opcode >= VM_BRNEG && opcode <= VM_BRZERO; }
+
+    // Whether a register opcode computes left op right
+    inline bool is_operator(int32_t opcode) { return opcode >= REG_ADD && opcode <= REG_DIV_I; }
+
+    // Whether a register opcode branches on left - right
+    inline bool is_compare(int32_t opcode) { return opcode >= REG_BRNEG && opcode <= REG_BRZERO_I; }
+}
+
+// Constructors
+Register_Translator::Register_Translator()
+    : variable_count(0), pending(false), pending_opcode(REG_MOVE), pending_left(0), pending_right(0), holder(0) {}
+
+// Getters
+const vector<Register_Instruction>& Register_Translator::get_code() const { return code; }
+
+const vector<int32_t>& Register_Translator::get_constants() const { return constants; }
+
+size_t Register_Translator::get_variable_count() const { return variable_count; }
+
+size_t Register_Translator::get_accumulator() const { return variable_count; }
+
+size_t Register_Translator::get_register_count() const { return variable_count + 1 + constants.size(); }
+
+// Member functions
+
+/** Translate accumulator bytecode into register bytecode. Instructions are taken in order, block by
+ *  block; where a block starts the accumulator is in its register, and where one ends it is put
+ *  there if the next block reads it. A division is never left pending past another instruction,
+ *  so that it fails where the accumulator code would.
+ *  @param program The bytecode, ending with VM_END
+ *  @param variables Number of variables it addresses
+ */
+void Register_Translator::translate(const vector<Vm_Instruction>& program, size_t variables) {
+    code.clear();
+    constants.clear();
+    variable_count = variables;
+    const int32_t accumulator = static_cast<int32_t>(variable_count);
+    pending = false;
+    holder = accumulator;
+
+    // A block starts at every branch target and after every branch
+    size_t count = program.size();
+    vector<bool> starts_block(count + 1, false);
+    for (size_t i = 0; i < count; ++i) {
+        int32_t opcode = program.at(i).opcode;
+        if (opcode >= VM_BR && opcode <= VM_BRZERO) {
+            starts_block.at(program.at(i).operand) = true;
+            starts_block.at(i + 1) = true;
+        }
+    }
+    vector<bool> live;
+    find_live(program, live);
+
+    vector<int32_t> start(count, 0); // Index of the register code of each instruction
+    vector<size_t> branches; // Register instructions whose target is still an accumulator index
+    for (size_t i = 0; i < count; ++i) {
+        const Vm_Instruction& instruction = program.at(i);
+        int32_t opcode = instruction.opcode;
+        int32_t operand = instruction.operand;
+
+        if (starts_block.at(i)) {
+            int32_t previous = i > 0 ? program.at(i - 1).opcode : VM_BR;
+            bool reached = previous != VM_BR && previous != VM_STOP; // Control can fall into the block
+            if (reached && (live.at(i) || (pending && pending_opcode == REG_DIV))) { materialize(accumulator); }
+            pending = false;
+            holder = accumulator;
+        }
+        start.at(i) = static_cast<int32_t>(code.size());
+        if (pending && pending_opcode == REG_DIV && opcode != VM_STORE) { materialize(accumulator); }
+
+        switch (opcode) {
+        case VM_LOAD:
+            pending = false;
+            holder = operand;
+            break;
+        case VM_LOAD_I:
+            pending = false;
+            holder = constant(operand);
+            break;
+        case VM_STORE:
+            if (pending) { materialize(operand); } // The operator reads its operands before it writes
+            else if (holder != operand) { emit(REG_MOVE, operand, holder); }
+            break;
+        case VM_ADD: case VM_SUB: case VM_MULT: case VM_DIV:
+        case VM_ADD_I: case VM_SUB_I: case VM_MULT_I: case VM_DIV_I: {
+            bool immediate = opcode == VM_ADD_I || opcode == VM_SUB_I || opcode == VM_MULT_I || opcode == VM_DIV_I;
+            int32_t right = immediate ? constant(operand) : operand;
+            available();
+            pending = true;
+            pending_opcode = operator_of(opcode);
+            pending_left = holder;
+            pending_right = right;
+            break;
+        }
+        case VM_READ:
+            overwrite(operand, live.at(i + 1));
+            emit(REG_READ, operand);
+            break;
+        case VM_WRITE:
+            emit(REG_WRITE, 0, operand);
+            break;
+        case VM_WRITE_I:
+            emit(REG_WRITE, 0, constant(operand));
+            break;
+        case VM_BR:
+            if (live.at(operand)) { materialize(accumulator); }
+            branches.push_back(code.size()); // After what materialize emitted
+            emit(REG_BR, operand);
+            break;
+        case VM_BRNEG: case VM_BRZNEG: case VM_BRPOS: case VM_BRZPOS: case VM_BRZERO: {
+            int32_t branch = REG_BRNEG + 2 * (opcode - VM_BRNEG);
+            if (live.at(operand) || live.at(i + 1)) {
+                materialize(accumulator); // Both ways may read it
+                branches.push_back(code.size());
+                emit(branch, operand, accumulator, constant(0));
+            } else if (pending && pending_opcode == REG_SUB) {
+                branches.push_back(code.size());
+                emit(branch, operand, pending_left, pending_right); // The difference is only compared
+                pending = false;
+                holder = accumulator;
+            } else {
+                available();
+                branches.push_back(code.size());
+                emit(branch, operand, holder, constant(0));
+            }
+            break;
+        }
+        case VM_NOOP:
+            break;
+        case VM_STOP:
+            emit(REG_STOP, 0);
+            break;
+        default: // VM_END
+            emit(REG_END, 0);
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < branches.size(); ++i) {
+        Register_Instruction& branch = code.at(branches.at(i));
+        branch.target = start.at(branch.target);
+    }
+}
+
+/** The register code as text, one instruction per line after its index
+ *  @param names Name of each variable, by register
+ *  @return: The text
+ */
+string Register_Translator::disassemble(const vector<string>& names) const {
+    ostringstream text;
+    for (size_t i = 0; i < code.size(); ++i) {
+        const Register_Instruction& instruction = code.at(i);
+        int32_t opcode = instruction.opcode;
+        bool immediate = opcode == REG_MOVE_I || opcode == REG_WRITE_I || ((is_operator(opcode) || is_compare(opcode)) && (opcode - REG_ADD) % 2 == 1);
+        vector<int32_t> registers; // Registers the instruction names, in order
+        if (opcode <= REG_DIV_I || opcode == REG_READ) { registers.push_back(instruction.target); }
+        if (opcode <= REG_DIV_I || opcode == REG_WRITE || opcode == REG_WRITE_I || is_compare(opcode)) {
+            registers.push_back(instruction.left);
+        }
+        if (is_operator(opcode) || is_compare(opcode)) { registers.push_back(instruction.right); }
+
+        text << i << "\t" << get_opcode_name(opcode);
+        for (size_t j = 0; j < registers.size(); ++j) {
+            text << (j == 0 ? " " : ", ");
+            if (immediate && j + 1 == registers.size()) {
+                text << registers.at(j); // The integer itself
+                continue;
+            }
+            size_t index = static_cast<size_t>(registers.at(j));
+            if (index < variable_count && index < names.size()) { text << names.at(index); }
+            else if (index == variable_count) { text << "ACC"; }
+            else { text << constants.at(index - variable_count - 1); }
+        }
+        if (opcode == REG_BR || is_compare(opcode)) {
+            text << (registers.empty() ? " " : " -> ") << instruction.target;
+        }
+        text << "\n";
+    }
+    return text.str();
+}
+
+// Name of a register opcode
+const char* Register_Translator::get_opcode_name(int32_t opcode) {
+    if (opcode < 0 || opcode >= REG_OPCODE_COUNT) { return "?"; }
+    return register_opcode_names[opcode];
+}
+
+// Register of a constant, added after the others on first use
+int32_t Register_Translator::constant(int32_t value) {
+    for (size_t i = 0; i < constants.size(); ++i) {
+        if (constants.at(i) == value) { return static_cast<int32_t>(variable_count + 1 + i); }
+    }
+    constants.push_back(value);
+    return static_cast<int32_t>(variable_count + constants.size());
+}
+
+/** Append an instruction. A constant that is its last operand is given as the integer, to the
+ *  _I opcode; ADD and MULT swap their operands when only the first is a constant.
+ *  @param opcode A Register_Opcode without _I
+ *  @param target Register written, or index of a branch target
+ *  @param left First register read
+ *  @param right Second register read
+ */
+void Register_Translator::emit(int32_t opcode, int32_t target, int32_t left, int32_t right) {
+    const int32_t first_constant = static_cast<int32_t>(variable_count + 1);
+    if (opcode == REG_MOVE || opcode == REG_WRITE) {
+        if (left >= first_constant) {
+            ++opcode;
+            left = constants.at(left - first_constant);
+        }
+    } else if (is_operator(opcode) || is_compare(opcode)) {
+        if (right < first_constant && left >= first_constant && (opcode == REG_ADD || opcode == REG_MULT)) {
+            int32_t swapped = left;
+            left = right;
+            right = swapped;
+        }
+        if (right >= first_constant) {
+            ++opcode;
+            right = constants.at(right - first_constant);
+        }
+    }
+
+    Register_Instruction instruction;
+    instruction.opcode = opcode;
+    instruction.target = target;
+    instruction.left = left;
+    instruction.right = right;
+    code.push_back(instruction);
+}
+
+/** Write the accumulator to a register, which then holds it
+ *  @param target The register
+ */
+void Register_Translator::materialize(int32_t target) {
+    if (pending) {
+        emit(pending_opcode, target, pending_left, pending_right);
+        pending = false;
+    } else if (holder != target) {
+        emit(REG_MOVE, target, holder);
+    }
+    holder = target;
+}
+
+// Make some register hold the accumulator, computing a pending operator into the accumulator's
+void Register_Translator::available() {
+    if (pending) { materialize(static_cast<int32_t>(variable_count)); }
+}
+
+/** Save the accumulator before a register it depends on is written by something else
+ *  @param target The register about to be written
+ *  @param needed Whether the accumulator is read later; if not it is dropped
+ */
+void Register_Translator::overwrite(int32_t target, bool needed) {
+    bool depends = pending ? (pending_left == target || pending_right == target) : holder == target;
+    if (!depends) { return; }
+
+    if (needed) {
+        materialize(static_cast<int32_t>(variable_count));
+    } else {
+        pending = false;
+        holder = static_cast<int32_t>(variable_count);
+    }
+}
+
+/** Find where the accumulator is live: read, on some path, before it is written
+ *  @param program The bytecode, ending with VM_END
+ *  @param live Receives whether it is live before each instruction, and after the last
+ */
+void Register_Translator::find_live(const vector<Vm_Instruction>& program, vector<bool>& live) {
+    size_t count = program.size();
+    live.assign(count + 1, false);
+
+    // Liveness only grows, so going backward until nothing changes reaches the fixed point
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (size_t i = count; i-- > 0;) {
+            int32_t opcode = program.at(i).opcode;
+            bool value = false;
+            if (opcode == VM_LOAD || opcode == VM_LOAD_I || opcode == VM_STOP || opcode == VM_END) { value = false; }
+            else if (opcode == VM_STORE || (opcode >= VM_ADD && opcode <= VM_DIV_I) || is_conditional_branch(opcode)) { value = true; }
+            else if (opcode == VM_BR) { value = live.at(program.at(i).operand); }
+            else { value = live.at(i + 1); } // READ, WRITE and NOOP leave it alone
+
+            if (value != live.at(i)) {
+                live.at(i) = value;
+                changed = true;
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef REGISTER_TRANSLATOR_H
+#define REGISTER_TRANSLATOR_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+struct Vm_Instruction;
+
+// Opcodes of the register bytecode. Every operand is a register: the variables come first, then
+// the register that carries the accumulator from block to block, then one register per constant.
+// As in the accumulator bytecode, an instruction whose last operand may be an integer has an _I
+// twin right after it that takes the integer itself, so no handler loads a constant register.
+enum Register_Opcode {
+    REG_MOVE, REG_MOVE_I, // target = left
+    REG_ADD, REG_ADD_I, REG_SUB, REG_SUB_I, // target = left op right
+    REG_MULT, REG_MULT_I, REG_DIV, REG_DIV_I,
+    REG_READ, // target = the next integer of the input
+    REG_WRITE, REG_WRITE_I, // Write left
+    REG_BR, // Go to target
+    REG_BRNEG, REG_BRNEG_I, REG_BRZNEG, REG_BRZNEG_I, // Go to target on the sign of left - right
+    REG_BRPOS, REG_BRPOS_I, REG_BRZPOS, REG_BRZPOS_I, REG_BRZERO, REG_BRZERO_I,
+    REG_STOP,
+    REG_END, // Placed after the last instruction: control fell off the program
+    REG_OPCODE_COUNT
+};
+
+// One register instruction
+struct Register_Instruction {
+    int32_t opcode; // A Register_Opcode
+    int32_t target; // Register written, or index of a branch target
+    int32_t left; // First register read, or the integer of MOVE_I and WRITE_I
+    int32_t right; // Second register read, or the integer of the other _I opcodes
+};
+
+// Translates the accumulator bytecode into three-operand register bytecode, so that a LOAD, an
+// operator and a STORE become one instruction. The accumulator is followed symbolically through
+// each block: a LOAD only notes which register holds it, an operator is kept pending until a STORE
+// names where its result goes, and a SUB followed by a conditional branch becomes one compare and
+// branch. So the temporaries $T<n> are written by the instruction that computes them and read
+// where they are used, and no instruction moves values in or out of them. The accumulator is
+// only put in its own register where a block ends and the next one reads it.
+class Register_Translator {
+public:
+    // Constructors
+    Register_Translator();
+
+    // Getters
+    const vector<Register_Instruction>& get_code() const; // The program, followed by REG_END
+    const vector<int32_t>& get_constants() const; // Value of each constant register, in order
+    size_t get_variable_count() const; // Registers that are variables, from 0
+    size_t get_accumulator() const; // Register of the accumulator, after the variables
+    size_t get_register_count() const; // Variables, accumulator and constants
+
+    // Member functions
+    void translate(const vector<Vm_Instruction>&, size_t); // Translate bytecode ending with VM_END over that many variables
+    string disassemble(const vector<string>&) const; // The register code as text, with variables by name
+    static const char* get_opcode_name(int32_t); // Name of a register opcode
+
+private:
+    // Data fields
+    vector<Register_Instruction> code; // The translated program
+    vector<int32_t> constants; // Value of each constant register
+    size_t variable_count; // Registers that are variables
+
+    // Where the accumulator is while a block is translated
+    bool pending; // An operator whose result has not been written yet
+    int32_t pending_opcode; // Its Register_Opcode
+    int32_t pending_left; // Its first operand
+    int32_t pending_right; // Its second operand
+    int32_t holder; // Register that holds the accumulator when nothing is pending
+
+    // Member functions
+    int32_t constant(int32_t); // Register of a constant, added on first use
+    void emit(int32_t, int32_t, int32_t = 0, int32_t = 0); // Append an instruction, taking constants as integers
+    void materialize(int32_t); // Write the accumulator to a register, which then holds it
+    void available(); // Make some register hold the accumulator
+    void overwrite(int32_t, bool); // Save the accumulator before a register it depends on is written
+    static void find_live(const vector<Vm_Instruction>&, vector<bool>&); // Where the accumulator is read before it is written
+};
+
+#endif // REGISTER_TRANSLATOR_H
@@ -0,0 +1,194 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Rewriter.h"
+
+#include <cctype>
+
+// Constructors
+Rewriter::Rewriter() {
+    add_rule(&Rewriter::add_zero, "add-zero");
+    add_rule(&Rewriter::sub_zero, "sub-zero");
+    add_rule(&Rewriter::zero_sub, "zero-sub");
+    add_rule(&Rewriter::sub_negation, "sub-negation");
+    add_rule(&Rewriter::mul_one, "mul-one");
+    add_rule(&Rewriter::div_one, "div-one");
+    add_rule(&Rewriter::double_negation, "double-negation");
+    add_rule(&Rewriter::mul_to_add, "mul-to-add");
+}
+
+// Getters
+const map<string, size_t>& Rewriter::get_rule_counts() const { return rule_counts; }
+
+// Member functions
+
+// Register a rule
+void Rewriter::add_rule(Rule rule, const string& name) {
+    rules.push_back(rule);
+    rule_names.push_back(name);
+}
+
+/** Apply the rules everywhere until none applies.
+ *  The operands are simplified first, then the rules are retried on the node itself
+ *  until it stops changing, so one rewrite can expose another (0 - - x -> - - x -> x).
+ *  @param expression The expression to simplify in place
+ */
+void Rewriter::simplify(Expression& expression) {
+    for (size_t i = 0; i < expression.operands.size(); ++i) {
+        simplify(expression.operands.at(i));
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < rules.size(); ++i) {
+            if ((this->*rules.at(i))(expression)) {
+                ++rule_counts[rule_names.at(i)];
+                changed = true;
+                break;
+            }
+        }
+    }
+}
+
+/** Cost of the code Generator::emit_expression produces for an expression.
+ *  A leaf right operand is used directly, a leaf left operand of a commutative operator is swapped
+ *  to the right, and any other right operand is computed first and kept in a temporary.
+ *  @param expression The expression
+ *  @return: the total cost of the instructions
+ */
+size_t Rewriter::get_cost(const Expression& expression) {
+    static const char* opcodes[] = { "LOAD", "ADD", "SUB", "MULT", "DIV", "SUB" };
+    const vector<Expression>& operands = expression.operands;
+
+    if (expression.is_leaf()) { return get_instruction_cost("LOAD"); }
+
+    if (expression.kind == Expression::EXPRESSION_NEG) {
+        // LOAD 0; SUB x, with x stored first unless it is a leaf
+        size_t cost = get_instruction_cost("LOAD") + get_instruction_cost("SUB");
+        if (!operands.at(0).is_leaf()) { cost += get_cost(operands.at(0)) + get_instruction_cost("STORE"); }
+        return cost;
+    }
+
+    size_t cost = get_instruction_cost(opcodes[expression.kind]);
+    if (operands.at(1).is_leaf()) { return cost + get_cost(operands.at(0)); }
+    if (operands.at(0).is_leaf() && expression.is_commutative()) { return cost + get_cost(operands.at(1)); }
+    return cost + get_cost(operands.at(1)) + get_instruction_cost("STORE") + get_cost(operands.at(0));
+}
+
+// Cost of one instruction on the target: multiplication and division take several cycles
+size_t Rewriter::get_instruction_cost(const string& opcode) {
+    if (opcode == "MULT" || opcode == "DIV") { return 4; }
+    return 1;
+}
+
+// x + 0 -> x, 0 + x -> x
+bool Rewriter::add_zero(Expression& expression) const {
+    if (expression.kind != Expression::EXPRESSION_ADD) { return false; }
+
+    if (expression.operands.at(1).is_constant(0)) {
+        Expression left = expression.operands.at(0);
+        expression = left;
+        return true;
+    }
+    if (expression.operands.at(0).is_constant(0)) {
+        Expression right = expression.operands.at(1);
+        expression = right;
+        return true;
+    }
+    return false;
+}
+
+// x - 0 -> x
+bool Rewriter::sub_zero(Expression& expression) const {
+    if (expression.kind != Expression::EXPRESSION_SUB || !expression.operands.at(1).is_constant(0)) { return false; }
+
+    Expression left = expression.operands.at(0);
+    expression = left;
+    return true;
+}
+
+// 0 - x -> - x, which the generator emits without a temporary
+bool Rewriter::zero_sub(Expression& expression) const {
+    if (expression.kind != Expression::EXPRESSION_SUB || !expression.operands.at(0).is_constant(0)) { return false; }
+
+    Expression right = expression.operands.at(1);
+    expression = Expression(Expression::EXPRESSION_NEG, right);
+    return true;
+}
+
+// x - - y -> x + y
+bool Rewriter::sub_negation(Expression& expression) const {
+    if (expression.kind != Expression::EXPRESSION_SUB || expression.operands.at(1).kind != Expression::EXPRESSION_NEG) { return false; }
+
+    Expression left = expression.operands.at(0);
+    Expression right = expression.operands.at(1).operands.at(0);
+    expression = Expression(Expression::EXPRESSION_ADD, left, right);
+    return true;
+}
+
+// x % 1 -> x, 1 % x -> x
+bool Rewriter::mul_one(Expression& expression) const {
+    if (expression.kind != Expression::EXPRESSION_MUL) { return false; }
+
+    if (expression.operands.at(1).is_constant(1)) {
+        Expression left = expression.operands.at(0);
+        expression = left;
+        return true;
+    }
+    if (expression.operands.at(0).is_constant(1)) {
+        Expression right = expression.operands.at(1);
+        expression = right;
+        return true;
+    }
+    return false;
+}
+
+// x / 1 -> x
+bool Rewriter::div_one(Expression& expression) const {
+    if (expression.kind != Expression::EXPRESSION_DIV || !expression.operands.at(1).is_constant(1)) { return false; }
+
+    Expression left = expression.operands.at(0);
+    expression = left;
+    return true;
+}
+
+// - - x -> x, exact on machine words since negation wraps around
+bool Rewriter::double_negation(Expression& expression) const {
+    if (expression.kind != Expression::EXPRESSION_NEG || expression.operands.at(0).kind != Expression::EXPRESSION_NEG) { return false; }
+
+    Expression inner = expression.operands.at(0).operands.at(0);
+    expression = inner;
+    return true;
+}
+
+/** x % c -> x + x + ... + x when the additions cost less than the multiplication.
+ *  Only a variable is repeated, since any other operand would need a temporary.
+ *  @param expression The expression to rewrite
+ *  @return True if the rule applied, false otherwise
+ */
+bool Rewriter::mul_to_add(Expression& expression) const {
+    const size_t max_factor = 16; // Longer chains never beat a single MULT
+    if (expression.kind != Expression::EXPRESSION_MUL) { return false; }
+
+    for (size_t side = 0; side < 2; ++side) {
+        const Expression& factor = expression.operands.at(side);
+        const Expression& variable = expression.operands.at(1 - side);
+
+        long long constant;
+        if (!factor.get_constant(constant) || constant < 2 || constant > static_cast<long long>(max_factor)) { continue; }
+        if (!variable.is_leaf() || !isalpha(static_cast<unsigned char>(variable.value.at(0)))) { continue; }
+
+        Expression sum = variable;
+        for (long long i = 1; i < constant; ++i) {
+            sum = Expression(Expression::EXPRESSION_ADD, sum, variable);
+        }
+
+        if (get_cost(sum) < get_cost(expression)) {
+            expression = sum;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,54 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef REWRITER_H
+#define REWRITER_H
+
+#include "Expression.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::string;
+using std::vector;
+
+// Rewrite rules that simplify expression trees before code is generated for them
+class Rewriter {
+public:
+    // Constructors
+    Rewriter();
+
+    // Getters
+    const map<string, size_t>& get_rule_counts() const;
+
+    // Member functions
+    void simplify(Expression&); // Apply the rules everywhere until none applies
+    static size_t get_cost(const Expression&); // Cost of the code Generator::emit_expression produces
+    static size_t get_instruction_cost(const string&); // Cost of one instruction on the target
+
+private:
+    typedef bool (Rewriter::*Rule)(Expression&) const; // Rewrites an expression in place, true if it applied
+
+    // Data fields
+    vector<Rule> rules; // The rules in the order they are tried
+    vector<string> rule_names; // The name of each rule
+    map<string, size_t> rule_counts; // Number of times each rule applied
+
+    // Rules
+    bool add_zero(Expression&) const; // x + 0 -> x, 0 + x -> x
+    bool sub_zero(Expression&) const; // x - 0 -> x
+    bool zero_sub(Expression&) const; // 0 - x -> - x
+    bool sub_negation(Expression&) const; // x - - y -> x + y
+    bool mul_one(Expression&) const; // x % 1 -> x, 1 % x -> x
+    bool div_one(Expression&) const; // x / 1 -> x
+    bool double_negation(Expression&) const; // - - x -> x
+    bool mul_to_add(Expression&) const; // x % c -> x + x + ... when cheaper
+
+    // Member functions
+    void add_rule(Rule, const string&); // Register a rule
+};
+
+#endif // REWRITER_H
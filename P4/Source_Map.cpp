@@ -0,0 +1,93 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Source_Map.h"
+
+#include <fstream>
+#include <sstream>
+
+using std::ifstream;
+using std::istringstream;
+using std::ostringstream;
+
+// Constructors
+Source_Map::Source_Map() {}
+
+// Getters
+const string& Source_Map::get_source_file() const { return source_file; }
+
+size_t Source_Map::get_line(size_t instruction) const { return instruction < lines.size() ? lines.at(instruction) : 0; }
+
+size_t Source_Map::get_instruction_count() const { return lines.size(); }
+
+const string& Source_Map::get_error() const { return error; }
+
+// Member functions
+
+/** Map the instructions of a program to their source lines. An instruction no statement produced,
+ *  such as the STOP after the last statement, the return of a func or an instruction a program pass
+ *  put in place of others, takes the line of the instruction before it.
+ *  @param instructions The instructions of the program, each with its line
+ *  @param source The source file the lines refer to
+ */
+void Source_Map::build(const vector<Instruction>& instructions, const string& source) {
+    source_file = source;
+    lines.assign(instructions.size(), 0);
+
+    size_t line = 0;
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        if (instructions.at(i).line != 0) { line = instructions.at(i).line; }
+        lines.at(i) = line;
+    }
+}
+
+// Convert the map to the text of a map file
+string Source_Map::to_string() const {
+    ostringstream oss;
+    oss << "# instruction line\n";
+    oss << "source " << source_file << "\n";
+    for (size_t i = 0; i < lines.size(); ++i) {
+        oss << i << " " << lines.at(i) << "\n";
+    }
+    return oss.str();
+}
+
+/** Read a map file written by to_string.
+ *  @param file The map file
+ *  @return True if the file was read, false otherwise (see get_error)
+ */
+bool Source_Map::read(const string& file) {
+    source_file.clear();
+    lines.clear();
+    error.clear();
+
+    ifstream fin(file.c_str());
+    if (!fin.is_open()) {
+        error = "cannot open " + file;
+        return false;
+    }
+
+    string text;
+    size_t line_number = 0;
+    while (getline(fin, text)) {
+        ++line_number;
+        if (text.empty() || text.at(0) == '#') { continue; }
+        if (text.compare(0, 7, "source ") == 0) {
+            source_file = text.substr(7);
+            continue;
+        }
+
+        istringstream fields(text);
+        size_t instruction;
+        size_t line;
+        if (!(fields >> instruction >> line) || instruction != lines.size()) {
+            ostringstream where;
+            where << file << ":" << line_number << ": expected instruction " << lines.size() << " and its line";
+            error = where.str();
+            return false;
+        }
+        lines.push_back(line);
+    }
+    return true;
+}
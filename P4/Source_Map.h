@@ -0,0 +1,42 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef SOURCE_MAP_H
+#define SOURCE_MAP_H
+
+#include "Program.h"
+
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// Maps each instruction of a program to the source line of the statement that produced it, so
+// counts taken while running the program can be reported against the source. The map is a text
+// file next to the output: a "source" line naming the source file, then "instruction line" pairs.
+class Source_Map {
+public:
+    // Constructors
+    Source_Map();
+
+    // Getters
+    const string& get_source_file() const; // The source file, empty if unknown
+    size_t get_line(size_t) const; // Source line of an instruction, 0 if unknown
+    size_t get_instruction_count() const; // Number of instructions mapped
+    const string& get_error() const;
+
+    // Member functions
+    void build(const vector<Instruction>&, const string&); // Map the instructions of a program to their lines
+    string to_string() const; // Convert the map to the text of a map file
+    bool read(const string&); // Read a map file, false with get_error set if it is invalid
+
+private:
+    // Data fields
+    string source_file; // The source file the lines refer to
+    vector<size_t> lines; // Source line of each instruction, 0 if unknown
+    string error; // Why the last read failed
+};
+
+#endif // SOURCE_MAP_H
@@ -4,6 +4,11 @@
 
 #include "Static_Semantics.h"
 
+#include <algorithm>
+
+using std::cerr;
+using std::endl;
+
 // Constructors
 Static_Semantics::Static_Semantics(const Tree& tree, Scanner& scanner) : parse_tree(tree), scanner(scanner) {}
 Static_Semantics::Static_Semantics(const Tree& tree, istringstream& iss) : parse_tree(tree), scanner(iss) {}
@@ -21,6 +26,8 @@ void Static_Semantics::check_semantics(const Node& node) {
         check_declaration(node);
     } else if (node.get_data() == "<read>" || node.get_data() == "<assign>" || node.get_data() == "<print>") {
         check_usage(node);
+    } else if (node.get_data() == "<call>") {
+        check_call(node);
     }
 
     // Recursively check all children nodes
@@ -32,6 +39,16 @@ void Static_Semantics::check_semantics(const Node& node) {
 }
 // Check the semantics of the parse tree wrapper function
 void Static_Semantics::check_semantics() {
+    // Every func can be called from anywhere, so they are all known before the walk
+    const vector<Node>& children = parse_tree.get_root().get_children();
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (children.at(i).get_data() == "<funcs>") { collect_functions(children.at(i)); }
+    }
+    for (map<string, const Node*>::const_iterator it = functions.begin(); it != functions.end(); ++it) {
+        vector<string> path;
+        check_recursion(it->first, path);
+    }
+
     check_semantics(parse_tree.get_root());
     symbol_table.check_variable(); // Check whether is there any unused variable after traversing the tree
 }
@@ -81,4 +98,75 @@ void Static_Semantics::check_usage(const Node& node) {
     for (size_t i = 0; i < children.size(); i++) {
         check_usage(children.at(i));
     }
-}
\ No newline at end of file
+}
+/** Record the func definitions of a <funcs> node
+ *  @param node The <funcs> node
+ */
+void Static_Semantics::collect_functions(const Node& node) {
+    const vector<Node>& children = node.get_children();
+    if (children.size() < 4) { return; } // Empty production
+
+    const Node& name = children.at(1);
+    if (functions.find(name.get_data()) != functions.end()) {
+        error_message("ERROR in static semantics: Function '" + name.get_data() + "' redefined at line " + to_string(name.get_line_number()));
+    }
+    functions[name.get_data()] = &children.at(2);
+
+    collect_functions(children.at(3));
+}
+
+/** Check that a <call> names a defined func
+ *  @param node The <call> node
+ */
+void Static_Semantics::check_call(const Node& node) {
+    const Node& name = node.get_children().at(1);
+    if (functions.find(name.get_data()) == functions.end()) {
+        error_message("ERROR in static semantics: Function '" + name.get_data() + "' called without definition at line " + to_string(name.get_line_number()));
+    }
+}
+
+/** Check that a func does not call itself, directly or through other funcs.
+ *  A call only stores one return address, so recursion cannot be generated.
+ *  @param name The func to check
+ *  @param path The funcs being called on the way to this one
+ */
+void Static_Semantics::check_recursion(const string& name, vector<string>& path) {
+    map<string, const Node*>::const_iterator function = functions.find(name);
+    if (function == functions.end()) { return; } // Reported by check_call
+
+    path.push_back(name);
+    vector<const Node*> calls;
+    find_calls(*function->second, calls);
+    for (size_t i = 0; i < calls.size(); ++i) {
+        const Node& callee = calls.at(i)->get_children().at(1);
+        if (std::find(path.begin(), path.end(), callee.get_data()) != path.end()) {
+            error_message("ERROR in static semantics: Function '" + callee.get_data() + "' called recursively at line " + to_string(callee.get_line_number()));
+        }
+        check_recursion(callee.get_data(), path);
+    }
+    path.pop_back();
+}
+
+/** Find the <call> nodes under a node
+ *  @param node The node to search
+ *  @param calls Receives the <call> nodes
+ */
+void Static_Semantics::find_calls(const Node& node, vector<const Node*>& calls) {
+    if (node.get_data() == "<call>") {
+        calls.push_back(&node);
+        return;
+    }
+
+    const vector<Node>& children = node.get_children();
+    for (size_t i = 0; i < children.size(); ++i) {
+        find_calls(children.at(i), calls);
+    }
+}
+
+/** Reports an error message
+ *  @param message The error message to report
+ */
+void Static_Semantics::error_message(const string& message) {
+    cerr << message << endl;
+    exit(1);
+}
@@ -33,12 +33,18 @@ private:
     const Tree& parse_tree; // Parse tree
     Scanner scanner; 
     Symbol_Table symbol_table; 
+    map<string, const Node*> functions; // The <block> of each func, by name
 
     // Member functions
     void check_semantics(const Node&); // Check the semantics of the parse tree recursive function
     void check_declaration(const Node&); // Check the semantics of the declaration
     void check_usage(const Node&); // Check the semantics of the usage
     bool is_variable(const string&); // Check if a string is a variable
+    void collect_functions(const Node&); // Record the func definitions of a <funcs> node
+    void check_call(const Node&); // Check that a <call> names a defined func
+    void check_recursion(const string&, vector<string>&); // Check that a func does not call itself, directly or not
+    void find_calls(const Node&, vector<const Node*>&); // Find the <call> nodes under a node
+    void error_message(const string&); // Reports an error message
                 
 };
 
@@ -0,0 +1,534 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Superoptimizer.h"
+#include "Rewriter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+
+using std::ifstream;
+using std::ofstream;
+
+static const char* opcode_names[] = { "LOAD", "STORE", "ADD", "SUB", "MULT", "DIV" };
+
+// Constructors
+Superoptimizer::Operation::Operation(Opcode opcode, bool immediate, long long value) : opcode(opcode), immediate(immediate), value(value) {}
+
+Superoptimizer::Superoptimizer()
+    : search(true), search_budget(300000), compile_budget(20000), compile_nodes(0), max_window(6), max_length(3), learned_count(0), replacement_count(0),
+      variable_count(0), accumulator_live(true), window_cost(0), window_budget(0), nodes(0) {}
+
+// Getters
+size_t Superoptimizer::get_rule_count() const { return rules.size(); }
+
+size_t Superoptimizer::get_learned_count() const { return learned_count; }
+
+size_t Superoptimizer::get_replacement_count() const { return replacement_count; }
+
+// Setters
+void Superoptimizer::set_search(bool enabled) { search = enabled; }
+
+void Superoptimizer::set_search_budget(size_t budget) { search_budget = budget; }
+
+void Superoptimizer::set_compile_budget(size_t budget) { compile_budget = budget; }
+
+// Member functions
+
+/** Add the rules of a database file.
+ *  Each line is "window | live => replacement", where the variables of the window are numbered
+ *  $0, $1, ... in order of appearance and "live" lists what is read after the window.
+ *  @param file The database file
+ *  @return True if the file was read, false if it could not be opened
+ */
+bool Superoptimizer::load_rules(const string& file) {
+    ifstream fin(file.c_str());
+    if (!fin.is_open()) { return false; }
+
+    string line;
+    while (getline(fin, line)) {
+        if (line.empty() || line.at(0) == '#') { continue; }
+
+        size_t arrow = line.find(" => ");
+        if (arrow == string::npos) { continue; }
+        rules[line.substr(0, arrow)] = line.substr(arrow + 4);
+    }
+    learned_count = 0;
+    return true;
+}
+
+// Write every rule to a database file
+bool Superoptimizer::save_rules(const string& file) const {
+    ofstream fout(file.c_str());
+    if (!fout.is_open()) { return false; }
+
+    fout << "# Superoptimizer rules: window | live after the window => shortest equivalent sequence\n";
+    for (map<string, string>::const_iterator it = rules.begin(); it != rules.end(); ++it) {
+        fout << it->first << " => " << it->second << "\n";
+    }
+    return true;
+}
+
+/** Replace straight-line windows of up to max_window instructions by shorter equivalent sequences.
+ *  Windows are taken from the end of the program backwards, so the liveness computed for the
+ *  original instructions still holds before every window (replacements only read fewer values).
+ *  Searching stops once the compile budget is spent; the remaining windows only use the rules.
+ *  @param program The program to optimize
+ *  @param live_variables The variables live after each instruction of the program
+ */
+void Superoptimizer::optimize(Program& program, const vector<set<string> >& live_variables) {
+    vector<Instruction>& instructions = program.get_instructions();
+    vector<bool> accumulator_liveness = get_accumulator_liveness(instructions);
+    replacement_count = 0;
+    compile_nodes = 0;
+
+    size_t end = instructions.size();
+    while (end > 0) {
+        // The straight-line run ending at end; only its first instruction may carry a label
+        size_t start = end;
+        while (start > 0 && is_window_instruction(instructions.at(start - 1)) && (start == end || instructions.at(start).label.empty())) {
+            --start;
+        }
+
+        // Try the longest window ending here first
+        bool replaced = false;
+        for (size_t length = std::min(max_window, end - start); length >= 2 && !replaced; --length) {
+            replaced = optimize_window(instructions, end - length, end, live_variables.at(end - 1), accumulator_liveness.at(end - 1));
+            if (replaced) { end -= length; }
+        }
+        if (!replaced) { --end; }
+    }
+}
+
+/** Replace one window with a rule from the database, searching for one if there is none.
+ *  @param instructions The instructions of the program
+ *  @param start The first instruction of the window
+ *  @param end One past the last instruction of the window
+ *  @param live_after The variables read after the window
+ *  @param accumulator_live_after True if the accumulator is read after the window
+ *  @return True if the window was replaced, false otherwise
+ */
+bool Superoptimizer::optimize_window(vector<Instruction>& instructions, size_t start, size_t end, const set<string>& live_after, bool accumulator_live_after) {
+    // Number the variables in order of appearance
+    vector<string> names;
+    window.clear();
+    for (size_t i = start; i < end; ++i) {
+        const Instruction& instruction = instructions.at(i);
+        Operation operation(static_cast<Opcode>(std::find(opcode_names, opcode_names + 6, instruction.opcode) - opcode_names));
+
+        if (instruction.has_immediate_operand()) {
+            operation.immediate = true;
+            operation.value = atoll(instruction.operand.c_str());
+        } else {
+            operation.value = std::find(names.begin(), names.end(), instruction.operand) - names.begin();
+            if (operation.value == static_cast<long long>(names.size())) { names.push_back(instruction.operand); }
+        }
+        window.push_back(operation);
+    }
+    if (names.size() > max_variables) { return false; }
+
+    variable_count = names.size();
+    accumulator_live = accumulator_live_after;
+    live.assign(variable_count, false);
+    written.assign(variable_count, false);
+    window_cost = get_cost(window);
+
+    // The key of the rule: the window and what is read after it
+    ostringstream key;
+    for (size_t i = 0; i < window.size(); ++i) {
+        key << (i == 0 ? "" : "; ") << to_string(window.at(i));
+        if (window.at(i).opcode == OP_STORE) { written.at(window.at(i).value) = true; }
+    }
+    key << " |";
+    if (accumulator_live) { key << " acc"; }
+    for (size_t v = 0; v < variable_count; ++v) {
+        live.at(v) = live_after.count(names.at(v)) > 0;
+        if (live.at(v)) { key << " $" << v; }
+    }
+    if (!accumulator_live && std::find(live.begin(), live.end(), true) == live.end()) { key << " none"; }
+
+    string replacement;
+    map<string, string>::const_iterator rule = rules.find(key.str());
+    if (rule != rules.end()) {
+        replacement = rule->second;
+    } else if (search && compile_nodes < compile_budget) {
+        window_budget = std::min(search_budget, compile_budget - compile_nodes);
+        replacement = search_window();
+        compile_nodes += nodes;
+
+        // A search the compile budget cut short proves nothing, a later compilation can finish it
+        if (replacement == "keep" && nodes > window_budget && window_budget < search_budget) { return false; }
+        rules[key.str()] = replacement;
+        ++learned_count;
+    } else {
+        return false;
+    }
+
+    // A rule from a database file is only trusted after the checks a search makes
+    vector<Operation> sequence;
+    if (replacement == "keep" || !parse_sequence(replacement, variable_count, sequence)) { return false; }
+    if (sequence.size() >= window.size() || get_cost(sequence) > window_cost || !is_equivalent(sequence)) { return false; }
+
+    vector<Instruction> code;
+    for (size_t i = 0; i < sequence.size(); ++i) {
+        ostringstream operand;
+        if (sequence.at(i).immediate) { operand << sequence.at(i).value; }
+        else { operand << names.at(sequence.at(i).value); }
+        code.push_back(Instruction(opcode_names[sequence.at(i).opcode], operand.str()));
+        code.back().line = instructions.at(start).line; // The replacement maps to where the window starts
+    }
+
+    // Keep a branch target in place
+    const string label = instructions.at(start).label;
+    if (!label.empty()) {
+        if (code.empty()) {
+            code.push_back(Instruction("NOOP"));
+            code.back().line = instructions.at(start).line;
+        }
+        code.front().label = label;
+    }
+
+    instructions.erase(instructions.begin() + start, instructions.begin() + end);
+    instructions.insert(instructions.begin() + start, code.begin(), code.end());
+    ++replacement_count;
+    return true;
+}
+
+/** Find the shortest sequence that leaves the same observable state as the window.
+ *  Candidates are enumerated exhaustively by length, filtered on one test input while
+ *  they are built, tested on the other inputs once complete, and finally proven equivalent.
+ *  @return: the replacement, "nothing" if the window can simply be removed, or "keep" if none is shorter
+ */
+string Superoptimizer::search_window() {
+    // Fixed pseudo-random inputs, so the generated code does not change between runs
+    unsigned long long seed = 4280;
+    tests.assign(test_count, State());
+    expected.clear();
+    for (size_t t = 0; t < test_count; ++t) {
+        State& state = tests.at(t);
+        state.trapped = false;
+        for (size_t v = 0; v <= max_variables; ++v) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            long long bits = static_cast<long long>(seed >> 32);
+            long long value;
+            if (t == 0) { value = (bits % 1000000 + 2) * (bits & 1 ? -1 : 1); } // Large enough to tell operations apart
+            else if (t == 1) { value = 0; }
+            else if (t == 2) { value = bits % 7 - 3; }
+            else { value = bits >= 0x80000000LL ? bits - 0x100000000LL : bits; }
+
+            if (v == max_variables) { state.accumulator = value; }
+            else { state.memory[v] = value; }
+        }
+
+        State result = state;
+        for (size_t i = 0; i < window.size(); ++i) { execute(window.at(i), result); }
+        expected.push_back(result);
+    }
+
+    // The integers of the window, 0 and 1
+    vector<long long> immediates;
+    immediates.push_back(0);
+    immediates.push_back(1);
+    for (size_t i = 0; i < window.size(); ++i) {
+        if (window.at(i).immediate && std::find(immediates.begin(), immediates.end(), window.at(i).value) == immediates.end()) {
+            immediates.push_back(window.at(i).value);
+        }
+    }
+
+    // Cheap instructions first, so the first sequence found is also cheap
+    alphabet.clear();
+    for (int opcode = OP_LOAD; opcode <= OP_DIV; ++opcode) {
+        for (size_t v = 0; v < variable_count; ++v) {
+            if (opcode != OP_STORE || written.at(v)) { alphabet.push_back(Operation(static_cast<Opcode>(opcode), false, v)); }
+        }
+        if (opcode == OP_STORE) { continue; }
+        for (size_t i = 0; i < immediates.size(); ++i) {
+            long long value = immediates.at(i);
+            // Adding 0 or multiplying by 1 changes nothing, and multiplying by 0 is a longer LOAD 0
+            bool useless = ((opcode == OP_ADD || opcode == OP_SUB) && value == 0) || ((opcode == OP_MULT || opcode == OP_DIV) && (value == 0 || value == 1));
+            if (!useless) { alphabet.push_back(Operation(static_cast<Opcode>(opcode), true, value)); }
+        }
+    }
+
+    nodes = 0;
+    size_t longest = std::min(window.size() - 1, max_length);
+    for (size_t length = 0; length <= longest && nodes <= window_budget; ++length) {
+        vector<Operation> candidate;
+        if (!search_sequences(candidate, length, tests.at(0))) { continue; }
+        if (candidate.empty()) { return "nothing"; }
+
+        ostringstream oss;
+        for (size_t i = 0; i < candidate.size(); ++i) { oss << (i == 0 ? "" : "; ") << to_string(candidate.at(i)); }
+        return oss.str();
+    }
+    return "keep";
+}
+
+/** Extend a candidate one instruction at a time until it has the given length.
+ *  @param candidate The instructions chosen so far
+ *  @param length The length of the sequences to try
+ *  @param state The state the candidate leaves on the first test input
+ *  @return True if the candidate was completed into a proven replacement, false otherwise
+ */
+bool Superoptimizer::search_sequences(vector<Operation>& candidate, size_t length, const State& state) {
+    const State& goal = expected.at(0);
+    if (state.trapped && !goal.trapped) { return false; }
+    if (candidate.size() == length) { return matches(state, goal) && check_candidate(candidate); }
+    if (++nodes > window_budget) { return false; }
+
+    // Every live variable still holding the wrong value needs a store of its own
+    if (!goal.trapped) {
+        size_t stores_needed = 0;
+        for (size_t v = 0; v < variable_count; ++v) {
+            if (live.at(v) && written.at(v) && state.memory[v] != goal.memory[v]) { ++stores_needed; }
+        }
+        if (stores_needed > length - candidate.size()) { return false; }
+    }
+
+    for (size_t i = 0; i < alphabet.size(); ++i) {
+        const Operation& operation = alphabet.at(i);
+        if (!candidate.empty()) {
+            const Operation& last = candidate.back();
+            // A load discards everything computed since the last store
+            if (operation.opcode == OP_LOAD && last.opcode != OP_STORE) { continue; }
+            // Storing the value the variable already holds
+            if (operation.opcode == OP_STORE && (last.opcode == OP_STORE || last.opcode == OP_LOAD) && !last.immediate && last.value == operation.value) { continue; }
+        }
+
+        State next = state;
+        execute(operation, next);
+        candidate.push_back(operation);
+        if (search_sequences(candidate, length, next)) { return true; }
+        candidate.pop_back();
+    }
+    return false;
+}
+
+// Test a complete candidate on the remaining inputs, then prove it
+bool Superoptimizer::check_candidate(const vector<Operation>& candidate) {
+    for (size_t t = 1; t < test_count; ++t) {
+        State state = tests.at(t);
+        for (size_t i = 0; i < candidate.size(); ++i) { execute(candidate.at(i), state); }
+        if (!matches(state, expected.at(t))) { return false; }
+    }
+    return get_cost(candidate) <= window_cost && is_equivalent(candidate);
+}
+
+// Compare the accumulator and the variables read after the window; a stopped program shows nothing else
+bool Superoptimizer::matches(const State& left, const State& right) const {
+    if (left.trapped || right.trapped) { return left.trapped == right.trapped; }
+    if (accumulator_live && left.accumulator != right.accumulator) { return false; }
+    for (size_t v = 0; v < variable_count; ++v) {
+        if (live.at(v) && left.memory[v] != right.memory[v]) { return false; }
+    }
+    return true;
+}
+
+// Run one instruction on a concrete state with 32-bit words
+void Superoptimizer::execute(const Operation& operation, State& state) const {
+    if (state.trapped) { return; }
+
+    long long operand = operation.immediate ? operation.value : state.memory[operation.value];
+    long long result = state.accumulator;
+    switch (operation.opcode) {
+    case OP_LOAD: result = operand; break;
+    case OP_STORE: state.memory[operation.value] = state.accumulator; return;
+    case OP_ADD: result += operand; break;
+    case OP_SUB: result -= operand; break;
+    case OP_MULT: result *= operand; break;
+    case OP_DIV:
+        if (operand == 0) {
+            state.trapped = true;
+            return;
+        }
+        result /= operand;
+        break;
+    }
+
+    // Wrap around to a 32-bit word
+    result = static_cast<long long>(static_cast<unsigned long long>(result) & 0xffffffffULL);
+    state.accumulator = result >= 0x80000000LL ? result - 0x100000000LL : result;
+}
+
+// Run one instruction on a symbolic state
+void Superoptimizer::execute(const Operation& operation, Symbolic_State& state) const {
+    Polynomial operand = operation.immediate ? make_constant(operation.value) : state.memory.at(operation.value);
+
+    switch (operation.opcode) {
+    case OP_LOAD: state.accumulator = operand; break;
+    case OP_STORE: state.memory.at(operation.value) = state.accumulator; break;
+    case OP_ADD: state.accumulator = add(state.accumulator, operand, false); break;
+    case OP_SUB: state.accumulator = add(state.accumulator, operand, true); break;
+    case OP_MULT: state.accumulator = multiply(state.accumulator, operand); break;
+    case OP_DIV: {
+        // A quotient is an unknown of its own, equal only to the same division
+        string division = to_string(state.accumulator) + " / " + to_string(operand);
+        state.divisions.insert(division);
+        state.accumulator = make_atom("(" + division + ")");
+        break;
+    }
+    }
+}
+
+/** Prove that a candidate leaves the same observable state as the window for every input.
+ *  Both are run on symbolic initial values; sums and products become polynomials modulo 2^64,
+ *  which agree exactly when the 32-bit results always agree, and both must divide the same
+ *  values, so they also stop on a division by zero for the same inputs.
+ *  @param candidate The candidate sequence
+ *  @return True if the candidate is equivalent to the window, false otherwise
+ */
+bool Superoptimizer::is_equivalent(const vector<Operation>& candidate) {
+    Symbolic_State original;
+    original.accumulator = make_atom("acc");
+    for (size_t v = 0; v < variable_count; ++v) {
+        ostringstream atom;
+        atom << "$" << v;
+        original.memory.push_back(make_atom(atom.str()));
+    }
+    Symbolic_State replacement = original;
+
+    for (size_t i = 0; i < window.size(); ++i) { execute(window.at(i), original); }
+    for (size_t i = 0; i < candidate.size(); ++i) { execute(candidate.at(i), replacement); }
+
+    if (original.divisions != replacement.divisions) { return false; }
+    if (accumulator_live && original.accumulator != replacement.accumulator) { return false; }
+    for (size_t v = 0; v < variable_count; ++v) {
+        if (live.at(v) && original.memory.at(v) != replacement.memory.at(v)) { return false; }
+    }
+    return true;
+}
+
+// Total cost of a sequence on the target
+size_t Superoptimizer::get_cost(const vector<Operation>& sequence) const {
+    size_t cost = 0;
+    for (size_t i = 0; i < sequence.size(); ++i) { cost += Rewriter::get_instruction_cost(opcode_names[sequence.at(i).opcode]); }
+    return cost;
+}
+
+// Check if an instruction can be part of a window: it only moves values between the accumulator and memory
+bool Superoptimizer::is_window_instruction(const Instruction& instruction) {
+    return (instruction.opcode == "LOAD" || instruction.opcode == "STORE" || instruction.is_arithmetic()) && !instruction.operand.empty();
+}
+
+/** Whether the accumulator may be read after each instruction.
+ *  Like the dead accumulator removal of the Optimizer, the accumulator is assumed to be read after every basic block.
+ *  @param instructions The instructions of the program
+ *  @return: for each instruction, true if the accumulator is live after it
+ */
+vector<bool> Superoptimizer::get_accumulator_liveness(const vector<Instruction>& instructions) {
+    vector<bool> liveness(instructions.size(), true);
+    bool live = true;
+
+    for (size_t i = instructions.size(); i-- > 0;) {
+        const Instruction& instruction = instructions.at(i);
+        if (instruction.ends_block() || (i + 1 < instructions.size() && !instructions.at(i + 1).label.empty())) { live = true; }
+        liveness.at(i) = live;
+
+        if (instruction.opcode == "LOAD" || instruction.opcode == "STOP") { live = false; }
+        else if (instruction.opcode == "STORE" || instruction.is_arithmetic() || instruction.is_branch()) { live = true; }
+    }
+    return liveness;
+}
+
+// Convert an operation to its text in the database, e.g. "ADD $1" or "SUB 3"
+string Superoptimizer::to_string(const Operation& operation) {
+    ostringstream oss;
+    oss << opcode_names[operation.opcode] << " " << (operation.immediate ? "" : "$") << operation.value;
+    return oss.str();
+}
+
+/** Parse the operations of a replacement.
+ *  @param text The replacement, e.g. "LOAD $1; SUB $0", or "nothing"
+ *  @param variable_count The number of variables of the window
+ *  @param sequence Receives the operations
+ *  @return True if the text is a valid replacement for the window, false otherwise
+ */
+bool Superoptimizer::parse_sequence(const string& text, size_t variable_count, vector<Operation>& sequence) {
+    sequence.clear();
+    if (text == "nothing") { return true; }
+
+    std::istringstream iss(text);
+    string part;
+    while (getline(iss, part, ';')) {
+        std::istringstream words(part);
+        string opcode, operand;
+        if (!(words >> opcode >> operand)) { return false; }
+
+        size_t index = std::find(opcode_names, opcode_names + 6, opcode) - opcode_names;
+        if (index == 6) { return false; }
+
+        Operation operation(static_cast<Opcode>(index));
+        if (operand.at(0) == '$') {
+            operation.value = atoll(operand.c_str() + 1);
+            if (operation.value < 0 || operation.value >= static_cast<long long>(variable_count)) { return false; }
+        } else if (isdigit(static_cast<unsigned char>(operand.at(0))) && operation.opcode != OP_STORE) {
+            operation.immediate = true;
+            operation.value = atoll(operand.c_str());
+        } else {
+            return false;
+        }
+        sequence.push_back(operation);
+    }
+    return true;
+}
+
+// A polynomial for an integer
+Superoptimizer::Polynomial Superoptimizer::make_constant(long long constant) {
+    Polynomial polynomial;
+    if (constant != 0) { polynomial[vector<string>()] = static_cast<unsigned long long>(constant); }
+    return polynomial;
+}
+
+// A polynomial for an unknown value
+Superoptimizer::Polynomial Superoptimizer::make_atom(const string& atom) {
+    Polynomial polynomial;
+    polynomial[vector<string>(1, atom)] = 1;
+    return polynomial;
+}
+
+// Sum, or difference if subtract is true, of two polynomials
+Superoptimizer::Polynomial Superoptimizer::add(const Polynomial& left, const Polynomial& right, bool subtract) {
+    Polynomial result = left;
+    for (Polynomial::const_iterator it = right.begin(); it != right.end(); ++it) {
+        unsigned long long& coefficient = result[it->first];
+        coefficient = subtract ? coefficient - it->second : coefficient + it->second;
+        if (coefficient == 0) { result.erase(it->first); }
+    }
+    return result;
+}
+
+// Product of two polynomials
+Superoptimizer::Polynomial Superoptimizer::multiply(const Polynomial& left, const Polynomial& right) {
+    Polynomial result;
+    for (Polynomial::const_iterator l = left.begin(); l != left.end(); ++l) {
+        for (Polynomial::const_iterator r = right.begin(); r != right.end(); ++r) {
+            vector<string> monomial = l->first;
+            monomial.insert(monomial.end(), r->first.begin(), r->first.end());
+            std::sort(monomial.begin(), monomial.end());
+            result[monomial] += l->second * r->second;
+        }
+    }
+
+    // Drop the terms that cancelled out
+    for (Polynomial::iterator it = result.begin(); it != result.end();) {
+        if (it->second == 0) { result.erase(it++); }
+        else { ++it; }
+    }
+    return result;
+}
+
+// Convert a polynomial to a canonical text, e.g. "3*$0*$1 + 18446744073709551615*acc"
+string Superoptimizer::to_string(const Polynomial& polynomial) {
+    if (polynomial.empty()) { return "0"; }
+
+    ostringstream oss;
+    for (Polynomial::const_iterator it = polynomial.begin(); it != polynomial.end(); ++it) {
+        if (it != polynomial.begin()) { oss << " + "; }
+        oss << it->second;
+        for (size_t i = 0; i < it->first.size(); ++i) { oss << "*" << it->first.at(i); }
+    }
+    return oss.str();
+}
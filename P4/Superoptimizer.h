@@ -0,0 +1,120 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef SUPEROPTIMIZER_H
+#define SUPEROPTIMIZER_H
+
+#include "Program.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+// Replaces short straight-line windows of accumulator instructions by the shortest equivalent sequence.
+// Every window shape is searched once and the result is kept in a rule database that can be saved and reloaded.
+class Superoptimizer {
+public:
+    // Constructors
+    Superoptimizer();
+
+    // Getters
+    size_t get_rule_count() const;
+    size_t get_learned_count() const; // Rules found by searching since the database was loaded
+    size_t get_replacement_count() const; // Windows replaced by the last optimize
+
+    // Setters
+    void set_search(bool); // Search the windows no rule covers
+    void set_search_budget(size_t); // Maximum number of candidate prefixes tried per window
+    void set_compile_budget(size_t); // Maximum number of candidate prefixes tried by one optimize
+
+    // Member functions
+    bool load_rules(const string&); // Add the rules of a database file
+    bool save_rules(const string&) const; // Write every rule to a database file
+    void optimize(Program&, const vector<set<string> >&); // Replace windows, given the variables live after each instruction
+
+private:
+    enum Opcode { OP_LOAD, OP_STORE, OP_ADD, OP_SUB, OP_MULT, OP_DIV };
+
+    // One instruction of a window, with its variables numbered in order of appearance
+    struct Operation {
+        Opcode opcode;
+        bool immediate; // True if the operand is an integer
+        long long value; // The integer, or the number of the variable
+
+        Operation(Opcode = OP_LOAD, bool = false, long long = 0);
+    };
+
+    static const size_t max_variables = 8; // A window of max_window instructions mentions at most this many variables
+    static const size_t test_count = 8; // Number of inputs every candidate is tested on
+
+    // The machine state for one test
+    struct State {
+        long long accumulator;
+        long long memory[max_variables];
+        bool trapped; // A division by zero stopped the program
+    };
+
+    typedef map<vector<string>, unsigned long long> Polynomial; // Coefficient of each product of atoms, modulo 2^64
+
+    // The machine state in terms of the initial values, for the symbolic check
+    struct Symbolic_State {
+        Polynomial accumulator;
+        vector<Polynomial> memory;
+        set<string> divisions; // Every division performed, as "numerator / denominator"
+    };
+
+    // Data fields
+    map<string, string> rules; // Replacement of each window, or "keep" if none is shorter
+    bool search; // Search the windows no rule covers
+    size_t search_budget; // Maximum number of candidate prefixes tried per window
+    size_t compile_budget; // Maximum number of candidate prefixes tried by one optimize
+    size_t compile_nodes; // Candidate prefixes tried by the current optimize
+    size_t max_window; // Longest window considered
+    size_t max_length; // Longest replacement searched for
+    size_t learned_count; // Rules found by searching since the database was loaded
+    size_t replacement_count; // Windows replaced by the last optimize
+
+    // The window being searched
+    vector<Operation> window; // The original instructions
+    size_t variable_count; // Number of variables the window mentions
+    vector<Operation> alphabet; // The instructions a replacement is built from
+    bool accumulator_live; // The accumulator is read after the window
+    vector<bool> live; // Each variable is read after the window
+    vector<bool> written; // Each variable is stored by the window
+    vector<State> tests; // The inputs every candidate is tested on
+    vector<State> expected; // The state the window leaves for each input
+    size_t window_cost; // Cost of the original instructions
+    size_t window_budget; // Maximum number of candidate prefixes tried for this window
+    size_t nodes; // Candidate prefixes tried so far
+
+    // Member functions
+    bool optimize_window(vector<Instruction>&, size_t, size_t, const set<string>&, bool); // Replace one window if possible
+    string search_window(); // Find the shortest replacement of the window, "keep" if none
+    bool search_sequences(vector<Operation>&, size_t, const State&); // Extend a candidate to the given length
+    bool check_candidate(const vector<Operation>&); // Test and prove a complete candidate
+    bool matches(const State&, const State&) const; // Compare the observable parts of two states
+    void execute(const Operation&, State&) const; // Run one instruction on a concrete state
+    void execute(const Operation&, Symbolic_State&) const; // Run one instruction on a symbolic state
+    bool is_equivalent(const vector<Operation>&); // Prove a candidate computes what the window computes
+    size_t get_cost(const vector<Operation>&) const; // Total cost of a sequence on the target
+
+    static bool is_window_instruction(const Instruction&); // Check if an instruction can be part of a window
+    static vector<bool> get_accumulator_liveness(const vector<Instruction>&); // Whether the accumulator is read after each instruction
+    static string to_string(const Operation&); // Convert an operation to its text in the database
+    static bool parse_sequence(const string&, size_t, vector<Operation>&); // Parse the operations of a replacement
+
+    static Polynomial make_constant(long long); // A polynomial for an integer
+    static Polynomial make_atom(const string&); // A polynomial for an unknown value
+    static Polynomial add(const Polynomial&, const Polynomial&, bool); // Sum or difference of two polynomials
+    static Polynomial multiply(const Polynomial&, const Polynomial&); // Product of two polynomials
+    static string to_string(const Polynomial&); // Convert a polynomial to a canonical text
+};
+
+#endif // SUPEROPTIMIZER_H
@@ -10,7 +10,7 @@ Tree::Tree(const Node& root) : root(root) {}
 // Getters
 
 // Returns the root of the tree.
-Node Tree::get_root() const {
+const Node& Tree::get_root() const {
 	return root;
 }
 
@@ -54,3 +54,22 @@ string Tree::pre_order() const {
 	return pre_order(root, 0);
 }
 
+
+/** Find the func definitions of a program.
+	@param program: the <program> node
+	@param functions: receives the <block> of each func, by name
+*/
+void Tree::find_functions(const Node& program, map<string, const Node*>& functions) {
+	const vector<Node>& children = program.get_children();
+	for (size_t i = 0; i < children.size(); i++) {
+		if (children[i].get_data() != "<funcs>") { continue; }
+
+		// <funcs> -> empty | func identifier <block> <funcs>
+		const Node* funcs = &children[i];
+		while (funcs->get_children().size() == 4) {
+			const vector<Node>& definition = funcs->get_children();
+			functions[definition[1].get_data()] = &definition[2];
+			funcs = &definition[3];
+		}
+	}
+}
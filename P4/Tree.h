@@ -7,7 +7,9 @@
 
 #include "Node.h"
 
+#include <map>
 #include <stack>
+using std::map;
 using std::stack;
 
 class Tree {
@@ -17,7 +19,7 @@ public:
 	Tree(const Node & = Node()); // Default constructor
 
 	// Getters
-	Node get_root() const;
+	const Node& get_root() const;
 	const Node& get_root();
 
 	// Setters
@@ -25,6 +27,7 @@ public:
 
 	// Member functions
 	string pre_order() const; // Pre-order traversal of the tree wrapper function
+	static void find_functions(const Node&, map<string, const Node*>&); // Find the <block> of each func of a <program>
 private:
 	Node root; // Root of the tree
 
@@ -0,0 +1,857 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Virtual_Machine.h"
+#include "Object_File.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+using std::copy;
+using std::istringstream;
+using std::ostringstream;
+
+// GCC and Clang can jump to the address of a label, which lets every handler dispatch the next
+// instruction itself (direct threading); other compilers, or -DVM_NO_THREADING, get a switch in a loop
+#if defined(__GNUC__) && !defined(VM_NO_THREADING)
+#define VM_THREADED
+#endif
+
+namespace {
+    // The opcode of each assembly instruction that takes a variable or an integer: [variable, integer]
+    struct Operand_Forms {
+        const char* name;
+        Vm_Opcode variable;
+        Vm_Opcode integer;
+    };
+
+    const Operand_Forms value_instructions[] = {
+        { "LOAD", VM_LOAD, VM_LOAD_I },
+        { "ADD", VM_ADD, VM_ADD_I },
+        { "SUB", VM_SUB, VM_SUB_I },
+        { "MULT", VM_MULT, VM_MULT_I },
+        { "DIV", VM_DIV, VM_DIV_I },
+        { "WRITE", VM_WRITE, VM_WRITE_I }
+    };
+
+    const char* const opcode_names[VM_OPCODE_COUNT] = {
+        "LOAD", "LOAD", "STORE",
+        "ADD", "ADD", "SUB", "SUB", "MULT", "MULT", "DIV", "DIV",
+        "READ", "WRITE", "WRITE",
+        "BR", "BRNEG", "BRZNEG", "BRPOS", "BRZPOS", "BRZERO",
+        "NOOP", "STOP",
+        "END",
+        "LOAD+STORE", "STORE+WRITE", "STORE+LOAD", "NOOP+LOAD",
+        "LOAD+ADD", "LOAD+SUB", "ADD+STORE", "ADD+STORE", "SUB+STORE", "WRITE+LOAD",
+        "LOAD+ADD+STORE", "LOAD+SUB+STORE",
+        "STORE+BRNEG", "STORE+BRZNEG", "STORE+BRPOS", "STORE+BRZPOS", "STORE+BRZERO",
+        "SUB+BRNEG", "SUB+BRZNEG", "SUB+BRPOS", "SUB+BRZPOS", "SUB+BRZERO",
+        "SUB+BRNEG", "SUB+BRZNEG", "SUB+BRPOS", "SUB+BRZPOS", "SUB+BRZERO",
+        "LOAD+SUB+BRNEG", "LOAD+SUB+BRZNEG", "LOAD+SUB+BRPOS", "LOAD+SUB+BRZPOS", "LOAD+SUB+BRZERO",
+        "LOAD+SUB+BRNEG", "LOAD+SUB+BRZNEG", "LOAD+SUB+BRPOS", "LOAD+SUB+BRZPOS", "LOAD+SUB+BRZERO"
+    };
+
+    // A sequence of instructions one dispatch runs. These are the most frequent pairs and triples of
+    // the generated code: over the sample programs, LOAD n STORE WRITE is the output of every constant,
+    // LOAD ADD STORE every counter update and LOAD SUB BRcc every relational of a loop or an iff.
+    // WRITE LOAD and STORE BRcc are rarer but make up the bodies of loops like p4_7's.
+    struct Superinstruction {
+        Vm_Opcode fused;
+        size_t length;
+        Vm_Opcode parts[3];
+    };
+
+    const Superinstruction sequences[] = {
+        { VM_LOAD_ADD_I_STORE, 3, { VM_LOAD, VM_ADD_I, VM_STORE } },
+        { VM_LOAD_SUB_I_STORE, 3, { VM_LOAD, VM_SUB_I, VM_STORE } },
+        { VM_LOAD_SUB_BRNEG, 3, { VM_LOAD, VM_SUB, VM_BRNEG } },
+        { VM_LOAD_SUB_BRZNEG, 3, { VM_LOAD, VM_SUB, VM_BRZNEG } },
+        { VM_LOAD_SUB_BRPOS, 3, { VM_LOAD, VM_SUB, VM_BRPOS } },
+        { VM_LOAD_SUB_BRZPOS, 3, { VM_LOAD, VM_SUB, VM_BRZPOS } },
+        { VM_LOAD_SUB_BRZERO, 3, { VM_LOAD, VM_SUB, VM_BRZERO } },
+        { VM_LOAD_SUB_I_BRNEG, 3, { VM_LOAD, VM_SUB_I, VM_BRNEG } },
+        { VM_LOAD_SUB_I_BRZNEG, 3, { VM_LOAD, VM_SUB_I, VM_BRZNEG } },
+        { VM_LOAD_SUB_I_BRPOS, 3, { VM_LOAD, VM_SUB_I, VM_BRPOS } },
+        { VM_LOAD_SUB_I_BRZPOS, 3, { VM_LOAD, VM_SUB_I, VM_BRZPOS } },
+        { VM_LOAD_SUB_I_BRZERO, 3, { VM_LOAD, VM_SUB_I, VM_BRZERO } },
+        { VM_LOAD_I_STORE, 2, { VM_LOAD_I, VM_STORE } },
+        { VM_STORE_WRITE, 2, { VM_STORE, VM_WRITE } },
+        { VM_STORE_LOAD, 2, { VM_STORE, VM_LOAD } },
+        { VM_NOOP_LOAD, 2, { VM_NOOP, VM_LOAD } },
+        { VM_LOAD_ADD, 2, { VM_LOAD, VM_ADD } },
+        { VM_LOAD_SUB, 2, { VM_LOAD, VM_SUB } },
+        { VM_ADD_STORE, 2, { VM_ADD, VM_STORE } },
+        { VM_ADD_I_STORE, 2, { VM_ADD_I, VM_STORE } },
+        { VM_SUB_I_STORE, 2, { VM_SUB_I, VM_STORE } },
+        { VM_WRITE_LOAD, 2, { VM_WRITE, VM_LOAD } },
+        { VM_STORE_BRNEG, 2, { VM_STORE, VM_BRNEG } },
+        { VM_STORE_BRZNEG, 2, { VM_STORE, VM_BRZNEG } },
+        { VM_STORE_BRPOS, 2, { VM_STORE, VM_BRPOS } },
+        { VM_STORE_BRZPOS, 2, { VM_STORE, VM_BRZPOS } },
+        { VM_STORE_BRZERO, 2, { VM_STORE, VM_BRZERO } },
+        { VM_SUB_BRNEG, 2, { VM_SUB, VM_BRNEG } },
+        { VM_SUB_BRZNEG, 2, { VM_SUB, VM_BRZNEG } },
+        { VM_SUB_BRPOS, 2, { VM_SUB, VM_BRPOS } },
+        { VM_SUB_BRZPOS, 2, { VM_SUB, VM_BRZPOS } },
+        { VM_SUB_BRZERO, 2, { VM_SUB, VM_BRZERO } },
+        { VM_SUB_I_BRNEG, 2, { VM_SUB_I, VM_BRNEG } },
+        { VM_SUB_I_BRZNEG, 2, { VM_SUB_I, VM_BRZNEG } },
+        { VM_SUB_I_BRPOS, 2, { VM_SUB_I, VM_BRPOS } },
+        { VM_SUB_I_BRZPOS, 2, { VM_SUB_I, VM_BRZPOS } },
+        { VM_SUB_I_BRZERO, 2, { VM_SUB_I, VM_BRZERO } }
+    };
+
+    const size_t buffer_size = 1 << 16;
+
+    // Arithmetic on 32-bit words that wraps around instead of overflowing
+    inline int32_t wrap(uint32_t value) { return static_cast<int32_t>(value); }
+
+    inline int32_t add(int32_t left, int32_t right) { return wrap(static_cast<uint32_t>(left) + static_cast<uint32_t>(right)); }
+
+    inline int32_t subtract(int32_t left, int32_t right) { return wrap(static_cast<uint32_t>(left) - static_cast<uint32_t>(right)); }
+
+    // Division truncating toward zero; the one quotient that does not fit wraps around
+    inline int32_t divide(int32_t left, int32_t right) {
+        if (right == -1) { return wrap(0u - static_cast<uint32_t>(left)); }
+        return left / right;
+    }
+}
+
+// Constructors
+Virtual_Machine::Virtual_Machine() : superinstructions(true), jit(false), profiling(false), registers(false), steps(0), dispatches(0), input(NULL), output(NULL), input_position(0), input_size(0), output_size(0) {}
+
+// Getters
+const vector<Vm_Instruction>& Virtual_Machine::get_code() const { return code; }
+
+const vector<Vm_Instruction>& Virtual_Machine::get_fused_code() const { return fused_code; }
+
+const vector<int32_t>& Virtual_Machine::get_memory() const { return memory; }
+
+const vector<int32_t>& Virtual_Machine::get_initial_memory() const { return initial_memory; }
+
+const vector<string>& Virtual_Machine::get_variables() const { return variables; }
+
+const string& Virtual_Machine::get_error() const { return error; }
+
+unsigned long long Virtual_Machine::get_steps() const { return steps; }
+
+unsigned long long Virtual_Machine::get_dispatches() const { return dispatches; }
+
+const vector<unsigned long long>& Virtual_Machine::get_executions() const { return executions; }
+
+const vector<unsigned long long>& Virtual_Machine::get_branches_taken() const { return branches_taken; }
+
+const Register_Translator& Virtual_Machine::get_register_translator() const { return register_translator; }
+
+// Setters
+void Virtual_Machine::set_superinstructions(bool fusing) { superinstructions = fusing; }
+
+void Virtual_Machine::set_jit(bool compiling) { jit = compiling; }
+
+void Virtual_Machine::set_profiling(bool counting) { profiling = counting; }
+
+void Virtual_Machine::set_registers(bool translating) { registers = translating; }
+
+// Member functions
+
+// Name of a bytecode opcode, e.g. LOAD+SUB+BRNEG for a superinstruction
+const char* Virtual_Machine::get_opcode_name(int32_t opcode) {
+    if (opcode < 0 || opcode >= VM_OPCODE_COUNT) { return "?"; }
+    return opcode_names[opcode];
+}
+
+// Record why assembly or a run failed
+bool Virtual_Machine::fail(const string& reason) {
+    error = reason;
+    return false;
+}
+
+/** Assemble .asm text into bytecode.
+ *  Each line is [label:] OPCODE [operand]; the first line whose first word is not an opcode starts
+ *  the data section of "variable initial-value" lines. Labels and variables are resolved here, once,
+ *  so the bytecode holds instruction indices and memory addresses.
+ *  @param text The assembly
+ *  @return True if the text was assembled, false otherwise (see get_error)
+ */
+bool Virtual_Machine::assemble(const string& text) {
+    code.clear();
+    fused_code.clear();
+    initial_memory.clear();
+    variables.clear();
+    error.clear();
+
+    map<string, size_t> labels; // Index of the instruction each label is on
+    map<string, size_t> addresses; // Address of each variable
+    vector<string> operands; // The symbolic operand of each instruction, empty if it has none or it is an integer
+    vector<size_t> lines; // Line number of each instruction
+    bool in_data = false;
+    string pending_label;
+
+    istringstream lines_in(text);
+    string line;
+    size_t line_number = 0;
+    while (std::getline(lines_in, line)) {
+        ++line_number;
+        istringstream words(line);
+        string word;
+        if (!(words >> word)) { continue; }
+
+        ostringstream where;
+        where << "line " << line_number << ": ";
+
+        if (!in_data && word.size() > 1 && word.at(word.size() - 1) == ':') {
+            if (!pending_label.empty()) { return fail(where.str() + "two labels on one instruction"); }
+            pending_label = word.substr(0, word.size() - 1);
+            if (labels.count(pending_label)) { return fail(where.str() + "label " + pending_label + " defined twice"); }
+            if (!(words >> word)) { continue; } // The label is on the next instruction
+        }
+
+        string operand;
+        bool has_operand = static_cast<bool>(words >> operand);
+        string extra;
+        if (words >> extra) { return fail(where.str() + "unexpected " + extra); }
+
+        // The instruction, in each of its forms
+        Vm_Instruction instruction;
+        instruction.operand = 0;
+        string symbol;
+        bool found = false;
+        bool takes_operand = true;
+
+        for (size_t i = 0; !in_data && i < sizeof(value_instructions) / sizeof(value_instructions[0]); ++i) {
+            if (word != value_instructions[i].name) { continue; }
+            found = true;
+            if (has_operand && parse_integer(operand, instruction.operand)) {
+                instruction.opcode = value_instructions[i].integer;
+            } else {
+                instruction.opcode = value_instructions[i].variable;
+                symbol = operand;
+            }
+        }
+        if (!in_data && !found) {
+            static const char* const symbolic[] = { "STORE", "READ", "BR", "BRNEG", "BRZNEG", "BRPOS", "BRZPOS", "BRZERO" };
+            static const Vm_Opcode symbolic_opcodes[] = { VM_STORE, VM_READ, VM_BR, VM_BRNEG, VM_BRZNEG, VM_BRPOS, VM_BRZPOS, VM_BRZERO };
+            for (size_t i = 0; i < sizeof(symbolic) / sizeof(symbolic[0]); ++i) {
+                if (word == symbolic[i]) {
+                    found = true;
+                    instruction.opcode = symbolic_opcodes[i];
+                    symbol = operand;
+                }
+            }
+            if (word == "NOOP" || word == "STOP") {
+                found = true;
+                takes_operand = false;
+                instruction.opcode = word == "NOOP" ? VM_NOOP : VM_STOP;
+            }
+        }
+
+        if (found) {
+            if (has_operand != takes_operand) { return fail(where.str() + (takes_operand ? "missing operand of " : "unexpected operand of ") + word); }
+            if (!pending_label.empty()) {
+                labels[pending_label] = code.size();
+                pending_label.clear();
+            }
+            code.push_back(instruction);
+            operands.push_back(symbol);
+            lines.push_back(line_number);
+            continue;
+        }
+
+        // A storage directive: variable initial-value
+        if (!pending_label.empty()) { return fail(where.str() + "label " + pending_label + " on a storage directive"); }
+        in_data = true;
+        int32_t value = 0;
+        if (!has_operand || !parse_integer(operand, value)) { return fail(where.str() + "expected an opcode or a variable and its initial value"); }
+        if (addresses.count(word)) { return fail(where.str() + "variable " + word + " defined twice"); }
+        addresses[word] = variables.size();
+        variables.push_back(word);
+        initial_memory.push_back(value);
+    }
+
+    if (!pending_label.empty()) {
+        labels[pending_label] = code.size(); // A label on nothing refers to the end of the program
+    }
+
+    // Resolve the symbolic operands
+    for (size_t i = 0; i < code.size(); ++i) {
+        if (operands.at(i).empty()) { continue; }
+
+        ostringstream where;
+        where << "line " << lines.at(i) << ": ";
+        int32_t opcode = code.at(i).opcode;
+        bool branch = opcode >= VM_BR && opcode <= VM_BRZERO;
+        const map<string, size_t>& symbols = branch ? labels : addresses;
+        map<string, size_t>::const_iterator found = symbols.find(operands.at(i));
+        if (found == symbols.end()) { return fail(where.str() + (branch ? "undefined label " : "undefined variable ") + operands.at(i)); }
+        code.at(i).operand = static_cast<int32_t>(found->second);
+    }
+
+    Vm_Instruction end;
+    end.opcode = VM_END;
+    end.operand = 0;
+    code.push_back(end);
+    prepare();
+    return true;
+}
+
+/** Take the bytecode of a loaded object file, which Object_File::load has already checked.
+ *  @param object The object file
+ */
+void Virtual_Machine::load(const Object_File& object) {
+    load(object.get_instructions(), object.get_instruction_count(), object.get_variable_names());
+    initial_memory.assign(object.get_initial_values(), object.get_initial_values() + object.get_variable_count());
+}
+
+/** Take bytecode built elsewhere, such as a program compiled by Constexpr_Compiler
+ *  @param instructions The program, without VM_END
+ *  @param count Number of instructions
+ *  @param names Name of each variable, by address; all of them start at 0
+ */
+void Virtual_Machine::load(const Vm_Instruction* instructions, size_t count, const vector<string>& names) {
+    error.clear();
+    code.assign(instructions, instructions + count);
+    initial_memory.assign(names.size(), 0);
+    variables = names;
+
+    Vm_Instruction end;
+    end.opcode = VM_END;
+    end.operand = 0;
+    code.push_back(end);
+    prepare();
+}
+
+// Fuse and translate the bytecode once it is loaded, as the settings ask
+void Virtual_Machine::prepare() {
+    fuse();
+    if (registers) { register_translator.translate(code, variables.size()); }
+}
+
+/** Choose the superinstructions with the fewest dispatches for straight-line code.
+ *  A superinstruction replaces the opcode of the first slot it covers and leaves the other slots,
+ *  and their operands, where they are, so instruction indices do not change. Only its first slot
+ *  may be a branch target, since a branch into the middle would skip the rest of the sequence.
+ */
+void Virtual_Machine::fuse() {
+    fused_code = code;
+    if (!superinstructions) { return; }
+
+    vector<bool> targets(code.size() + 1, false);
+    for (size_t i = 0; i < code.size(); ++i) {
+        if (code.at(i).opcode >= VM_BR && code.at(i).opcode <= VM_BRZERO) { targets.at(code.at(i).operand) = true; }
+    }
+
+    // From the last instruction back: the fewest dispatches from each instruction to the end and how
+    // to get them, preferring the longer sequence when two are as good
+    size_t count = sizeof(sequences) / sizeof(sequences[0]);
+    vector<size_t> best(code.size() + 1, 0);
+    vector<size_t> choice(code.size(), count); // Index of the superinstruction starting here, count if none
+    for (size_t i = code.size(); i-- > 0;) {
+        best.at(i) = best.at(i + 1) + 1;
+        for (size_t j = 0; j < count; ++j) {
+            const Superinstruction& candidate = sequences[j];
+            if (i + candidate.length > code.size()) { continue; }
+
+            bool matches = true;
+            for (size_t k = 0; k < candidate.length && matches; ++k) {
+                matches = code.at(i + k).opcode == candidate.parts[k] && (k == 0 || !targets.at(i + k));
+            }
+            if (matches && best.at(i + candidate.length) + 1 < best.at(i)) {
+                best.at(i) = best.at(i + candidate.length) + 1;
+                choice.at(i) = j;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < code.size();) {
+        if (choice.at(i) == count) {
+            ++i;
+            continue;
+        }
+        fused_code.at(i).opcode = sequences[choice.at(i)].fused;
+        i += sequences[choice.at(i)].length;
+    }
+}
+
+/** Run the bytecode from its first instruction with memory at its initial values.
+ *  @param in Where READ takes whitespace-separated integers from
+ *  @param out Where WRITE puts one integer per line
+ *  @return True if the program reached STOP, false on a runtime error (see get_error)
+ */
+bool Virtual_Machine::run(FILE* in, FILE* out) {
+    input = in;
+    output = out;
+    input_buffer.resize(buffer_size);
+    output_buffer.resize(buffer_size);
+    input_position = 0;
+    input_size = 0;
+    output_size = 0;
+    error.clear();
+    memory = initial_memory;
+
+    if (fused_code.empty()) { return fail("nothing to run"); }
+    if (profiling) { return run_profiled(); }
+    if (jit) { return run_compiled(); }
+    if (registers) { return run_registers(); }
+
+    int32_t accumulator = 0;
+    int32_t* const data = memory.empty() ? NULL : &memory.at(0);
+    unsigned long long count = 0;
+    unsigned long long fused = 0; // Instructions run by superinstructions besides the first of each
+    bool stopped = false;
+
+#ifdef VM_THREADED
+    // Translate the opcodes into the addresses of their handlers once per run
+    static const void* const handlers[VM_OPCODE_COUNT] = {
+        &&op_LOAD, &&op_LOAD_I, &&op_STORE,
+        &&op_ADD, &&op_ADD_I, &&op_SUB, &&op_SUB_I, &&op_MULT, &&op_MULT_I, &&op_DIV, &&op_DIV_I,
+        &&op_READ, &&op_WRITE, &&op_WRITE_I,
+        &&op_BR, &&op_BRNEG, &&op_BRZNEG, &&op_BRPOS, &&op_BRZPOS, &&op_BRZERO,
+        &&op_NOOP, &&op_STOP, &&op_END,
+        &&op_LOAD_I_STORE, &&op_STORE_WRITE, &&op_STORE_LOAD, &&op_NOOP_LOAD,
+        &&op_LOAD_ADD, &&op_LOAD_SUB, &&op_ADD_STORE, &&op_ADD_I_STORE, &&op_SUB_I_STORE, &&op_WRITE_LOAD,
+        &&op_LOAD_ADD_I_STORE, &&op_LOAD_SUB_I_STORE,
+        &&op_STORE_BRNEG, &&op_STORE_BRZNEG, &&op_STORE_BRPOS, &&op_STORE_BRZPOS, &&op_STORE_BRZERO,
+        &&op_SUB_BRNEG, &&op_SUB_BRZNEG, &&op_SUB_BRPOS, &&op_SUB_BRZPOS, &&op_SUB_BRZERO,
+        &&op_SUB_I_BRNEG, &&op_SUB_I_BRZNEG, &&op_SUB_I_BRPOS, &&op_SUB_I_BRZPOS, &&op_SUB_I_BRZERO,
+        &&op_LOAD_SUB_BRNEG, &&op_LOAD_SUB_BRZNEG, &&op_LOAD_SUB_BRPOS, &&op_LOAD_SUB_BRZPOS, &&op_LOAD_SUB_BRZERO,
+        &&op_LOAD_SUB_I_BRNEG, &&op_LOAD_SUB_I_BRZNEG, &&op_LOAD_SUB_I_BRPOS, &&op_LOAD_SUB_I_BRZPOS, &&op_LOAD_SUB_I_BRZERO
+    };
+    struct Threaded {
+        const void* handler;
+        int32_t operand;
+    };
+    vector<Threaded> threaded(fused_code.size());
+    for (size_t i = 0; i < fused_code.size(); ++i) {
+        threaded.at(i).handler = handlers[fused_code.at(i).opcode];
+        threaded.at(i).operand = fused_code.at(i).operand;
+    }
+    const Threaded* const base = &threaded.at(0);
+    const Threaded* pc = base;
+
+#define VM_CASE(name) op_##name:
+#define VM_NEXT() do { ++count; goto *(pc++)->handler; } while (0)
+#define VM_OPERAND (pc[-1].operand)
+#define VM_JUMP(target) (pc = base + (target))
+
+    VM_NEXT();
+#else
+    const Vm_Instruction* const base = &fused_code.at(0);
+    const Vm_Instruction* pc = base;
+
+#define VM_CASE(name) case VM_##name:
+#define VM_NEXT() continue
+#define VM_OPERAND (pc[-1].operand)
+#define VM_JUMP(target) (pc = base + (target))
+
+    for (;;) {
+        ++count;
+        switch ((pc++)->opcode) {
+#endif
+
+    // Each handler runs with pc already past its instruction
+    VM_CASE(LOAD) accumulator = data[VM_OPERAND]; VM_NEXT();
+    VM_CASE(LOAD_I) accumulator = VM_OPERAND; VM_NEXT();
+    VM_CASE(STORE) data[VM_OPERAND] = accumulator; VM_NEXT();
+    VM_CASE(ADD) accumulator = wrap(static_cast<uint32_t>(accumulator) + static_cast<uint32_t>(data[VM_OPERAND])); VM_NEXT();
+    VM_CASE(ADD_I) accumulator = wrap(static_cast<uint32_t>(accumulator) + static_cast<uint32_t>(VM_OPERAND)); VM_NEXT();
+    VM_CASE(SUB) accumulator = wrap(static_cast<uint32_t>(accumulator) - static_cast<uint32_t>(data[VM_OPERAND])); VM_NEXT();
+    VM_CASE(SUB_I) accumulator = wrap(static_cast<uint32_t>(accumulator) - static_cast<uint32_t>(VM_OPERAND)); VM_NEXT();
+    VM_CASE(MULT) accumulator = wrap(static_cast<uint32_t>(accumulator) * static_cast<uint32_t>(data[VM_OPERAND])); VM_NEXT();
+    VM_CASE(MULT_I) accumulator = wrap(static_cast<uint32_t>(accumulator) * static_cast<uint32_t>(VM_OPERAND)); VM_NEXT();
+    VM_CASE(DIV)
+        if (data[VM_OPERAND] == 0) { fail("division by zero"); goto finish; }
+        accumulator = divide(accumulator, data[VM_OPERAND]);
+        VM_NEXT();
+    VM_CASE(DIV_I)
+        if (VM_OPERAND == 0) { fail("division by zero"); goto finish; }
+        accumulator = divide(accumulator, VM_OPERAND);
+        VM_NEXT();
+    VM_CASE(READ)
+        if (!read_word(data[VM_OPERAND])) { goto finish; }
+        VM_NEXT();
+    VM_CASE(WRITE) write_word(data[VM_OPERAND]); VM_NEXT();
+    VM_CASE(WRITE_I) write_word(VM_OPERAND); VM_NEXT();
+    VM_CASE(BR) VM_JUMP(VM_OPERAND); VM_NEXT();
+    VM_CASE(BRNEG) if (accumulator < 0) { VM_JUMP(VM_OPERAND); } VM_NEXT();
+    VM_CASE(BRZNEG) if (accumulator <= 0) { VM_JUMP(VM_OPERAND); } VM_NEXT();
+    VM_CASE(BRPOS) if (accumulator > 0) { VM_JUMP(VM_OPERAND); } VM_NEXT();
+    VM_CASE(BRZPOS) if (accumulator >= 0) { VM_JUMP(VM_OPERAND); } VM_NEXT();
+    VM_CASE(BRZERO) if (accumulator == 0) { VM_JUMP(VM_OPERAND); } VM_NEXT();
+    VM_CASE(NOOP) VM_NEXT();
+    VM_CASE(STOP) stopped = true; goto finish;
+    VM_CASE(END) --count; // Not an instruction of the program
+        fail("control fell off the end of the program"); goto finish;
+
+    // Superinstructions run with pc past their first slot; VM_ARG(k) is the operand of the k-th
+    // instruction they cover and VM_SKIP moves pc past the last
+#define VM_ARG(k) (pc[(k) - 1].operand)
+#define VM_SKIP(length) do { pc += (length) - 1; fused += (length) - 1; } while (0)
+#define VM_BRANCH(length, condition) do { \
+        fused += (length) - 1; \
+        if (condition) { VM_JUMP(VM_ARG((length) - 1)); } else { pc += (length) - 1; } \
+    } while (0)
+#define VM_BRANCHES(prefix, length, compute) \
+    VM_CASE(prefix##_BRNEG) compute; VM_BRANCH(length, accumulator < 0); VM_NEXT(); \
+    VM_CASE(prefix##_BRZNEG) compute; VM_BRANCH(length, accumulator <= 0); VM_NEXT(); \
+    VM_CASE(prefix##_BRPOS) compute; VM_BRANCH(length, accumulator > 0); VM_NEXT(); \
+    VM_CASE(prefix##_BRZPOS) compute; VM_BRANCH(length, accumulator >= 0); VM_NEXT(); \
+    VM_CASE(prefix##_BRZERO) compute; VM_BRANCH(length, accumulator == 0); VM_NEXT();
+
+    VM_CASE(LOAD_I_STORE) accumulator = VM_ARG(0); data[VM_ARG(1)] = accumulator; VM_SKIP(2); VM_NEXT();
+    VM_CASE(STORE_WRITE) data[VM_ARG(0)] = accumulator; write_word(data[VM_ARG(1)]); VM_SKIP(2); VM_NEXT();
+    VM_CASE(STORE_LOAD) data[VM_ARG(0)] = accumulator; accumulator = data[VM_ARG(1)]; VM_SKIP(2); VM_NEXT();
+    VM_CASE(NOOP_LOAD) accumulator = data[VM_ARG(1)]; VM_SKIP(2); VM_NEXT();
+    VM_CASE(LOAD_ADD) accumulator = add(data[VM_ARG(0)], data[VM_ARG(1)]); VM_SKIP(2); VM_NEXT();
+    VM_CASE(LOAD_SUB) accumulator = subtract(data[VM_ARG(0)], data[VM_ARG(1)]); VM_SKIP(2); VM_NEXT();
+    VM_CASE(ADD_STORE) accumulator = add(accumulator, data[VM_ARG(0)]); data[VM_ARG(1)] = accumulator; VM_SKIP(2); VM_NEXT();
+    VM_CASE(ADD_I_STORE) accumulator = add(accumulator, VM_ARG(0)); data[VM_ARG(1)] = accumulator; VM_SKIP(2); VM_NEXT();
+    VM_CASE(SUB_I_STORE) accumulator = subtract(accumulator, VM_ARG(0)); data[VM_ARG(1)] = accumulator; VM_SKIP(2); VM_NEXT();
+    VM_CASE(WRITE_LOAD) write_word(data[VM_ARG(0)]); accumulator = data[VM_ARG(1)]; VM_SKIP(2); VM_NEXT();
+    VM_CASE(LOAD_ADD_I_STORE)
+        accumulator = add(data[VM_ARG(0)], VM_ARG(1));
+        data[VM_ARG(2)] = accumulator;
+        VM_SKIP(3);
+        VM_NEXT();
+    VM_CASE(LOAD_SUB_I_STORE)
+        accumulator = subtract(data[VM_ARG(0)], VM_ARG(1));
+        data[VM_ARG(2)] = accumulator;
+        VM_SKIP(3);
+        VM_NEXT();
+    VM_BRANCHES(STORE, 2, data[VM_ARG(0)] = accumulator)
+    VM_BRANCHES(SUB, 2, accumulator = subtract(accumulator, data[VM_ARG(0)]))
+    VM_BRANCHES(SUB_I, 2, accumulator = subtract(accumulator, VM_ARG(0)))
+    VM_BRANCHES(LOAD_SUB, 3, accumulator = subtract(data[VM_ARG(0)], data[VM_ARG(1)]))
+    VM_BRANCHES(LOAD_SUB_I, 3, accumulator = subtract(data[VM_ARG(0)], VM_ARG(1)))
+
+#ifndef VM_THREADED
+        default:
+            fail("invalid opcode");
+            goto finish;
+        }
+    }
+#endif
+
+#undef VM_CASE
+#undef VM_NEXT
+#undef VM_OPERAND
+#undef VM_JUMP
+#undef VM_ARG
+#undef VM_SKIP
+#undef VM_BRANCH
+#undef VM_BRANCHES
+
+finish:
+    dispatches = count;
+    steps = count + fused;
+    flush_output();
+    return stopped;
+}
+
+/** Run the bytecode as x86-64 machine code, with the same memory, input and output as run.
+ *  The machine code is compiled from the plain bytecode, since it needs no superinstructions.
+ *  @return True if the program reached STOP, false on a runtime error (see get_error)
+ */
+bool Virtual_Machine::run_compiled() {
+    steps = 0;
+    dispatches = 0;
+    if (!jit_compiler.compile(code, jit_read, jit_write)) { return fail(jit_compiler.get_error()); }
+
+    int32_t* const data = memory.empty() ? NULL : &memory.at(0);
+    int exit = jit_compiler.get_entry()(data, this);
+
+    flush_output();
+    switch (exit) {
+    case Jit_Compiler::JIT_STOP: return true;
+    case Jit_Compiler::JIT_IO_ERROR: return false; // read_word said why
+    case Jit_Compiler::JIT_DIVISION_BY_ZERO: return fail("division by zero");
+    default: return fail("control fell off the end of the program");
+    }
+}
+
+/** Run the plain bytecode one instruction at a time, counting how often each instruction runs and
+ *  each branch is taken. It is slower than the dispatch loop, which keeps no counters, and every
+ *  step counts as a dispatch since no superinstruction is used.
+ *  @return True if the program reached STOP, false on a runtime error (see get_error)
+ */
+bool Virtual_Machine::run_profiled() {
+    executions.assign(code.size(), 0);
+    branches_taken.assign(code.size(), 0);
+
+    int32_t accumulator = 0;
+    int32_t* const data = memory.empty() ? NULL : &memory.at(0);
+    unsigned long long* const counts = &executions.at(0);
+    unsigned long long* const taken = &branches_taken.at(0);
+    unsigned long long count = 0;
+    bool stopped = false;
+    size_t pc = 0;
+
+    for (bool running = true; running; ) {
+        ++count;
+        size_t current = pc++;
+        ++counts[current];
+        const int32_t operand = code[current].operand;
+        bool branch = false; // Whether a branch is taken
+
+        switch (code[current].opcode) {
+        case VM_LOAD: accumulator = data[operand]; break;
+        case VM_LOAD_I: accumulator = operand; break;
+        case VM_STORE: data[operand] = accumulator; break;
+        case VM_ADD: accumulator = add(accumulator, data[operand]); break;
+        case VM_ADD_I: accumulator = add(accumulator, operand); break;
+        case VM_SUB: accumulator = subtract(accumulator, data[operand]); break;
+        case VM_SUB_I: accumulator = subtract(accumulator, operand); break;
+        case VM_MULT: accumulator = wrap(static_cast<uint32_t>(accumulator) * static_cast<uint32_t>(data[operand])); break;
+        case VM_MULT_I: accumulator = wrap(static_cast<uint32_t>(accumulator) * static_cast<uint32_t>(operand)); break;
+        case VM_DIV:
+        case VM_DIV_I: {
+            int32_t divisor = code[current].opcode == VM_DIV ? data[operand] : operand;
+            if (divisor == 0) {
+                fail("division by zero");
+                running = false;
+                break;
+            }
+            accumulator = divide(accumulator, divisor);
+            break;
+        }
+        case VM_READ: running = read_word(data[operand]); break;
+        case VM_WRITE: write_word(data[operand]); break;
+        case VM_WRITE_I: write_word(operand); break;
+        case VM_BR: branch = true; break;
+        case VM_BRNEG: branch = accumulator < 0; break;
+        case VM_BRZNEG: branch = accumulator <= 0; break;
+        case VM_BRPOS: branch = accumulator > 0; break;
+        case VM_BRZPOS: branch = accumulator >= 0; break;
+        case VM_BRZERO: branch = accumulator == 0; break;
+        case VM_NOOP: break;
+        case VM_STOP:
+            stopped = true;
+            running = false;
+            break;
+        default: // VM_END
+            fail("control fell off the end of the program");
+            running = false;
+            break;
+        }
+
+        if (branch) {
+            ++taken[current];
+            pc = static_cast<size_t>(operand);
+        }
+    }
+
+    steps = count;
+    dispatches = count;
+    flush_output();
+    return stopped;
+}
+
+/** Run the register bytecode. The variables are the first registers, the accumulator's follows
+ *  and the constants come after it; the variables are copied back to memory at the end.
+ *  @return True if the program reached STOP, false on a runtime error (see get_error)
+ */
+bool Virtual_Machine::run_registers() {
+    const vector<Register_Instruction>& program = register_translator.get_code();
+    const vector<int32_t>& constants = register_translator.get_constants();
+    if (program.empty() || register_translator.get_variable_count() != memory.size()) { return fail("no register code to run"); }
+
+    vector<int32_t> file(register_translator.get_register_count(), 0);
+    copy(memory.begin(), memory.end(), file.begin());
+    copy(constants.begin(), constants.end(), file.begin() + memory.size() + 1);
+    int32_t* const r = &file.at(0);
+    unsigned long long count = 0;
+    bool stopped = false;
+
+#ifdef VM_THREADED
+    static const void* const handlers[REG_OPCODE_COUNT] = {
+        &&op_MOVE, &&op_MOVE_I, &&op_ADD, &&op_ADD_I, &&op_SUB, &&op_SUB_I, &&op_MULT, &&op_MULT_I, &&op_DIV, &&op_DIV_I,
+        &&op_READ, &&op_WRITE, &&op_WRITE_I, &&op_BR,
+        &&op_BRNEG, &&op_BRNEG_I, &&op_BRZNEG, &&op_BRZNEG_I, &&op_BRPOS, &&op_BRPOS_I,
+        &&op_BRZPOS, &&op_BRZPOS_I, &&op_BRZERO, &&op_BRZERO_I, &&op_STOP, &&op_END
+    };
+    struct Threaded {
+        const void* handler;
+        int32_t target;
+        int32_t left;
+        int32_t right;
+    };
+    vector<Threaded> threaded(program.size());
+    for (size_t i = 0; i < program.size(); ++i) {
+        threaded.at(i).handler = handlers[program.at(i).opcode];
+        threaded.at(i).target = program.at(i).target;
+        threaded.at(i).left = program.at(i).left;
+        threaded.at(i).right = program.at(i).right;
+    }
+    const Threaded* const base = &threaded.at(0);
+    const Threaded* pc = base;
+
+#define REG_CASE(name) op_##name:
+#define REG_NEXT() do { ++count; goto *(pc++)->handler; } while (0)
+#else
+    const Register_Instruction* const base = &program.at(0);
+    const Register_Instruction* pc = base;
+
+#define REG_CASE(name) case REG_##name:
+#define REG_NEXT() continue
+
+    for (;;) {
+        ++count;
+        switch ((pc++)->opcode) {
+#endif
+#define REG_TARGET (pc[-1].target)
+#define REG_LEFT (r[pc[-1].left])
+#define REG_RIGHT (r[pc[-1].right])
+#define REG_LEFT_I (pc[-1].left)
+#define REG_RIGHT_I (pc[-1].right)
+#define REG_BRANCH(condition) do { if (condition) { pc = base + REG_TARGET; } } while (0)
+
+#ifdef VM_THREADED
+    REG_NEXT();
+#endif
+
+    // Each handler runs with pc already past its instruction
+    REG_CASE(MOVE) r[REG_TARGET] = REG_LEFT; REG_NEXT();
+    REG_CASE(MOVE_I) r[REG_TARGET] = REG_LEFT_I; REG_NEXT();
+    REG_CASE(ADD) r[REG_TARGET] = add(REG_LEFT, REG_RIGHT); REG_NEXT();
+    REG_CASE(ADD_I) r[REG_TARGET] = add(REG_LEFT, REG_RIGHT_I); REG_NEXT();
+    REG_CASE(SUB) r[REG_TARGET] = subtract(REG_LEFT, REG_RIGHT); REG_NEXT();
+    REG_CASE(SUB_I) r[REG_TARGET] = subtract(REG_LEFT, REG_RIGHT_I); REG_NEXT();
+    REG_CASE(MULT) r[REG_TARGET] = wrap(static_cast<uint32_t>(REG_LEFT) * static_cast<uint32_t>(REG_RIGHT)); REG_NEXT();
+    REG_CASE(MULT_I) r[REG_TARGET] = wrap(static_cast<uint32_t>(REG_LEFT) * static_cast<uint32_t>(REG_RIGHT_I)); REG_NEXT();
+    REG_CASE(DIV)
+        if (REG_RIGHT == 0) { fail("division by zero"); goto finish; }
+        r[REG_TARGET] = divide(REG_LEFT, REG_RIGHT);
+        REG_NEXT();
+    REG_CASE(DIV_I)
+        if (REG_RIGHT_I == 0) { fail("division by zero"); goto finish; }
+        r[REG_TARGET] = divide(REG_LEFT, REG_RIGHT_I);
+        REG_NEXT();
+    REG_CASE(READ)
+        if (!read_word(r[REG_TARGET])) { goto finish; }
+        REG_NEXT();
+    REG_CASE(WRITE) write_word(REG_LEFT); REG_NEXT();
+    REG_CASE(WRITE_I) write_word(REG_LEFT_I); REG_NEXT();
+    REG_CASE(BR) pc = base + REG_TARGET; REG_NEXT();
+    REG_CASE(BRNEG) REG_BRANCH(subtract(REG_LEFT, REG_RIGHT) < 0); REG_NEXT();
+    REG_CASE(BRNEG_I) REG_BRANCH(subtract(REG_LEFT, REG_RIGHT_I) < 0); REG_NEXT();
+    REG_CASE(BRZNEG) REG_BRANCH(subtract(REG_LEFT, REG_RIGHT) <= 0); REG_NEXT();
+    REG_CASE(BRZNEG_I) REG_BRANCH(subtract(REG_LEFT, REG_RIGHT_I) <= 0); REG_NEXT();
+    REG_CASE(BRPOS) REG_BRANCH(subtract(REG_LEFT, REG_RIGHT) > 0); REG_NEXT();
+    REG_CASE(BRPOS_I) REG_BRANCH(subtract(REG_LEFT, REG_RIGHT_I) > 0); REG_NEXT();
+    REG_CASE(BRZPOS) REG_BRANCH(subtract(REG_LEFT, REG_RIGHT) >= 0); REG_NEXT();
+    REG_CASE(BRZPOS_I) REG_BRANCH(subtract(REG_LEFT, REG_RIGHT_I) >= 0); REG_NEXT();
+    REG_CASE(BRZERO) REG_BRANCH(REG_LEFT == REG_RIGHT); REG_NEXT();
+    REG_CASE(BRZERO_I) REG_BRANCH(REG_LEFT == REG_RIGHT_I); REG_NEXT();
+    REG_CASE(STOP) stopped = true; goto finish;
+    REG_CASE(END) --count; // Not an instruction of the program
+        fail("control fell off the end of the program"); goto finish;
+
+#ifndef VM_THREADED
+        default:
+            fail("invalid opcode");
+            goto finish;
+        }
+    }
+#endif
+
+#undef REG_CASE
+#undef REG_NEXT
+#undef REG_TARGET
+#undef REG_LEFT
+#undef REG_RIGHT
+#undef REG_LEFT_I
+#undef REG_RIGHT_I
+#undef REG_BRANCH
+
+finish:
+    copy(file.begin(), file.begin() + memory.size(), memory.begin());
+    steps = count;
+    dispatches = count;
+    flush_output();
+    return stopped;
+}
+
+// READ for the machine code: the context is the Virtual_Machine
+int Virtual_Machine::jit_read(void* context, int32_t* variable) {
+    return static_cast<Virtual_Machine*>(context)->read_word(*variable) ? 1 : 0;
+}
+
+// WRITE for the machine code
+void Virtual_Machine::jit_write(void* context, int32_t value) { static_cast<Virtual_Machine*>(context)->write_word(value); }
+
+// Next byte of input, EOF at the end
+int Virtual_Machine::next_input_byte() {
+    if (input_position == input_size) {
+        input_size = input == NULL ? 0 : fread(&input_buffer.at(0), 1, input_buffer.size(), input);
+        input_position = 0;
+        if (input_size == 0) { return EOF; }
+    }
+    return static_cast<unsigned char>(input_buffer[input_position++]);
+}
+
+/** Parse the next whitespace-separated integer of the input.
+ *  @param value Receives the integer, wrapped to a word
+ *  @return True if an integer was read, false at the end of the input or on anything else
+ */
+bool Virtual_Machine::read_word(int32_t& value) {
+    int c = next_input_byte();
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') { c = next_input_byte(); }
+    if (c == EOF) { return fail("READ past the end of the input"); }
+
+    bool negative = c == '-';
+    if (c == '-' || c == '+') { c = next_input_byte(); }
+    if (c < '0' || c > '9') { return fail("READ found something other than an integer"); }
+
+    uint32_t magnitude = 0;
+    while (c >= '0' && c <= '9') {
+        magnitude = magnitude * 10 + static_cast<uint32_t>(c - '0');
+        c = next_input_byte();
+    }
+    if (c != EOF) { --input_position; } // Leave the delimiter for the next READ
+
+    value = wrap(negative ? 0u - magnitude : magnitude);
+    return true;
+}
+
+// Append an integer and a newline to the output
+void Virtual_Machine::write_word(int32_t value) {
+    if (output_size + 16 > output_buffer.size()) { flush_output(); }
+
+    char digits[12];
+    size_t length = 0;
+    uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+    do {
+        digits[length++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    if (value < 0) { output_buffer[output_size++] = '-'; }
+    while (length > 0) { output_buffer[output_size++] = digits[--length]; }
+    output_buffer[output_size++] = '\n';
+}
+
+// Write the buffered output
+void Virtual_Machine::flush_output() {
+    if (output != NULL && output_size > 0) {
+        fwrite(&output_buffer.at(0), 1, output_size, output);
+        fflush(output);
+    }
+    output_size = 0;
+}
+
+/** Parse an operand or initial value.
+ *  @param text The text
+ *  @param value Receives the integer, wrapped to a word
+ *  @return True if the text is an integer, false otherwise
+ */
+bool Virtual_Machine::parse_integer(const string& text, int32_t& value) {
+    if (text.empty()) { return false; }
+
+    size_t start = (text.at(0) == '-' || text.at(0) == '+') ? 1 : 0;
+    if (start == text.size() || text.find_first_not_of("0123456789", start) != string::npos) { return false; }
+
+    long long parsed = strtoll(text.c_str(), NULL, 10);
+    value = wrap(static_cast<uint32_t>(parsed));
+    return true;
+}
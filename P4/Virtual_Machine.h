@@ -0,0 +1,131 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#ifndef VIRTUAL_MACHINE_H
+#define VIRTUAL_MACHINE_H
+
+#include "Jit_Compiler.h"
+#include "Register_Translator.h"
+
+#include <cstdio>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::string;
+using std::vector;
+
+class Object_File;
+
+// Opcodes of the bytecode. The instructions that take a variable or an integer
+// get one opcode for each, so the dispatch loop never checks which it is.
+enum Vm_Opcode {
+    VM_LOAD, VM_LOAD_I, VM_STORE,
+    VM_ADD, VM_ADD_I, VM_SUB, VM_SUB_I, VM_MULT, VM_MULT_I, VM_DIV, VM_DIV_I,
+    VM_READ, VM_WRITE, VM_WRITE_I,
+    VM_BR, VM_BRNEG, VM_BRZNEG, VM_BRPOS, VM_BRZPOS, VM_BRZERO,
+    VM_NOOP, VM_STOP,
+    VM_END, // Placed after the last instruction: control fell off the program
+
+    // Superinstructions: one dispatch runs a sequence, whose operands stay in the slots it covers
+    VM_LOAD_I_STORE, VM_STORE_WRITE, VM_STORE_LOAD, VM_NOOP_LOAD,
+    VM_LOAD_ADD, VM_LOAD_SUB, VM_ADD_STORE, VM_ADD_I_STORE, VM_SUB_I_STORE, VM_WRITE_LOAD,
+    VM_LOAD_ADD_I_STORE, VM_LOAD_SUB_I_STORE,
+    VM_STORE_BRNEG, VM_STORE_BRZNEG, VM_STORE_BRPOS, VM_STORE_BRZPOS, VM_STORE_BRZERO,
+    VM_SUB_BRNEG, VM_SUB_BRZNEG, VM_SUB_BRPOS, VM_SUB_BRZPOS, VM_SUB_BRZERO,
+    VM_SUB_I_BRNEG, VM_SUB_I_BRZNEG, VM_SUB_I_BRPOS, VM_SUB_I_BRZPOS, VM_SUB_I_BRZERO,
+    VM_LOAD_SUB_BRNEG, VM_LOAD_SUB_BRZNEG, VM_LOAD_SUB_BRPOS, VM_LOAD_SUB_BRZPOS, VM_LOAD_SUB_BRZERO,
+    VM_LOAD_SUB_I_BRNEG, VM_LOAD_SUB_I_BRZNEG, VM_LOAD_SUB_I_BRPOS, VM_LOAD_SUB_I_BRZPOS, VM_LOAD_SUB_I_BRZERO,
+
+    VM_OPCODE_COUNT
+};
+
+// One bytecode instruction
+struct Vm_Instruction {
+    int32_t opcode; // A Vm_Opcode
+    int32_t operand; // Address of a variable, an integer, or the index of a branch target
+};
+
+// Assembles the accumulator assembly the compiler writes into bytecode and runs it.
+// Words are 32 bits and wrap around like the target's; READ and WRITE are buffered.
+class Virtual_Machine {
+public:
+    // Constructors
+    Virtual_Machine();
+
+    // Getters
+    const vector<Vm_Instruction>& get_code() const; // The instructions as assembled, without superinstructions
+    const vector<Vm_Instruction>& get_fused_code() const; // The instructions the dispatch loop runs
+    const vector<int32_t>& get_memory() const; // Value of each variable, by address
+    const vector<int32_t>& get_initial_memory() const; // Value of each variable before a run, by address
+    const vector<string>& get_variables() const; // Name of each variable, by address
+    const string& get_error() const;
+    unsigned long long get_steps() const; // Instructions executed by the last run
+    unsigned long long get_dispatches() const; // Dispatches of the last run, fewer than steps with superinstructions
+    const vector<unsigned long long>& get_executions() const; // Times each instruction ran in the last profiled run
+    const vector<unsigned long long>& get_branches_taken() const; // Times each branch was taken in the last profiled run
+    const Register_Translator& get_register_translator() const; // The register code, when registers is set
+
+    // Setters
+    void set_superinstructions(bool); // Fuse frequent sequences when assembling
+    void set_jit(bool); // Run x86-64 machine code compiled from the bytecode instead of interpreting it
+    void set_profiling(bool); // Count how often each instruction runs and each branch is taken
+    void set_registers(bool); // Translate the bytecode into register bytecode when loading and run that
+
+    // Member functions
+    bool assemble(const string&); // Assemble .asm text, false with get_error set if it is invalid
+    void load(const Object_File&); // Take the bytecode of a loaded object file
+    void load(const Vm_Instruction*, size_t, const vector<string>&); // Take bytecode built elsewhere, with its variables starting at 0
+    bool run(FILE*, FILE*); // Run from the first instruction, false with get_error set on a runtime error
+    static const char* get_opcode_name(int32_t); // Name of a bytecode opcode, e.g. LOAD+SUB+BRNEG
+
+private:
+    // Data fields
+    vector<Vm_Instruction> code; // The program, followed by VM_END
+    vector<Vm_Instruction> fused_code; // The same with the first slot of each fused sequence replaced
+    bool superinstructions; // Fuse frequent sequences when assembling
+    bool jit; // Run compiled machine code, which counts neither steps nor dispatches
+    Jit_Compiler jit_compiler; // Compiles the bytecode for each run when jit is set
+    bool profiling; // Run with counters instead of the dispatch loop or the JIT
+    bool registers; // Run the register bytecode, whose steps and dispatches are its own instructions
+    Register_Translator register_translator; // Translates the bytecode when registers is set
+    vector<unsigned long long> executions; // Times each instruction ran, when profiling
+    vector<unsigned long long> branches_taken; // Times each branch was taken, when profiling
+    vector<int32_t> initial_memory; // Initial value of each variable from the data section
+    vector<int32_t> memory; // Value of each variable during and after a run
+    vector<string> variables; // Name of each variable
+    string error; // Why the last assembly or run failed
+    unsigned long long steps; // Instructions executed by the last run
+    unsigned long long dispatches; // Dispatches of the last run
+
+    // Buffered input and output
+    FILE* input; // Where READ takes its numbers from
+    FILE* output; // Where WRITE puts its numbers
+    vector<char> input_buffer; // Bytes read but not parsed yet
+    size_t input_position; // Next byte of input_buffer to parse
+    size_t input_size; // Number of valid bytes in input_buffer
+    vector<char> output_buffer; // Text written but not flushed yet
+    size_t output_size; // Number of valid bytes in output_buffer
+
+    // Member functions
+    Virtual_Machine(const Virtual_Machine&); // Not copyable, the JIT owns a mapping
+    Virtual_Machine& operator=(const Virtual_Machine&);
+    bool fail(const string&); // Record why assembly or a run failed
+    bool run_compiled(); // Run the bytecode as machine code
+    bool run_profiled(); // Run the bytecode counting every instruction and taken branch
+    bool run_registers(); // Run the register bytecode
+    void prepare(); // Fuse and translate the bytecode once it is loaded
+    static int jit_read(void*, int32_t*); // READ for the machine code
+    static void jit_write(void*, int32_t); // WRITE for the machine code
+    void fuse(); // Choose the superinstructions, none of which spans a branch target
+    int next_input_byte(); // Next byte of input, EOF at the end
+    bool read_word(int32_t&); // Parse the next integer of the input
+    void write_word(int32_t); // Append an integer and a newline to the output
+    void flush_output(); // Write the buffered output
+    static bool parse_integer(const string&, int32_t&); // Parse an operand or initial value
+};
+
+#endif // VIRTUAL_MACHINE_H
@@ -0,0 +1,22 @@
+READ z
+LOAD z
+BRZNEG L0
+LOAD 2
+STORE y
+L0: NOOP
+LOAD 10
+STORE $T0
+WRITE $T0
+L1: NOOP
+LOAD 2
+L2: NOOP
+LOAD 5
+ADD y
+STORE $T2
+WRITE $T2
+STOP
+y 0
+z 0
+$T0 0
+$T2 0
+
@@ -0,0 +1,65 @@
+/* Generated by compile from accumulator assembly */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Words are 32 bits and wrap around like the target's */
+static int32_t wrap(uint32_t value) { return (int32_t)value; }
+
+static int32_t add(int32_t left, int32_t right) { return wrap((uint32_t)left + (uint32_t)right); }
+
+static void fail(const char* reason) {
+    fflush(stdout);
+    fprintf(stderr, "[Error] %s\n", reason);
+    exit(1);
+}
+
+/* Next whitespace-separated integer of the input, wrapped to a word */
+static int32_t read_word(void) {
+    uint32_t magnitude = 0;
+    int negative;
+    int c = getchar();
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') { c = getchar(); }
+    if (c == EOF) { fail("READ past the end of the input"); }
+    negative = c == '-';
+    if (c == '-' || c == '+') { c = getchar(); }
+    if (c < '0' || c > '9') { fail("READ found something other than an integer"); }
+    while (c >= '0' && c <= '9') {
+        magnitude = magnitude * 10 + (uint32_t)(c - '0');
+        c = getchar();
+    }
+    if (c != EOF) { ungetc(c, stdin); }
+    return wrap(negative ? 0u - magnitude : magnitude);
+}
+
+static void write_word(int32_t value) { printf("%ld\n", (long)value); }
+
+int main(void) {
+    static char output_buffer[1 << 16];
+    int32_t a = 0; /* The accumulator */
+    int32_t v_y = 0;
+    int32_t v_z = 0;
+    int32_t g_T0 = 0;
+    int32_t g_T2 = 0;
+
+    setvbuf(stdout, output_buffer, _IOFBF, sizeof output_buffer);
+
+    v_z = read_word();
+    a = v_z;
+    if (a <= 0) goto l_L0;
+    a = 2;
+    v_y = a;
+l_L0:
+    ;
+    a = 10;
+    g_T0 = a;
+    write_word(g_T0);
+    ;
+    a = 2;
+    ;
+    a = 5;
+    a = add(a, v_y);
+    g_T2 = a;
+    write_word(g_T2);
+    return 0;
+}
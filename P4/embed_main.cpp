@@ -0,0 +1,132 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Constexpr_Compiler.h"
+#include "Virtual_Machine.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::ifstream;
+using std::ostringstream;
+using std::string;
+
+// The program of func.4280fs24, compiled while this file is: nothing is scanned or parsed at startup
+constexpr auto embedded = embed_program<R"(
+program
+  var n , 0
+  a , 0 b , 0 i , 0 ;
+func square start
+  set b a % a ;
+stop
+func bump start
+  set a a + 1 ;
+  func square ;
+stop
+func report start
+  var k , 0 ;
+  set k b - a ;
+  iff [ k .gt. 20 ] start
+    set k k / 2 ;
+    set k k + 1 ;
+  stop
+  iff [ k .lt. 0 ] set k 0 - k ;
+  set k k + 10 ;
+  print k ;
+stop
+start
+  read n ;
+  set a n ;
+  func bump ;
+  print a ;
+  print b ;
+  func report ;
+  func report ;
+  set i 1 ;
+  set a 0 ;
+  iterate [ i .le. 6 ] start
+    set a a + a + 2 ;
+    print a ;
+    set i i + 1 ;
+  stop
+  set a n ;
+  print a ;
+stop
+)">();
+
+static_assert(embedded.code.back().opcode == VM_STOP, "an embedded program ends with STOP");
+
+/** Print the bytecode of a program, one instruction per line
+ *  @param code The instructions
+ *  @param count Number of instructions
+ *  @param variables Name of each variable, by address
+ */
+void list(const Vm_Instruction* code, size_t count, const vector<string>& variables) {
+    for (size_t i = 0; i < count; ++i) {
+        const Vm_Instruction& instruction = code[i];
+        cout << i << "\t" << Virtual_Machine::get_opcode_name(instruction.opcode);
+        if (instruction.opcode == VM_LOAD || instruction.opcode == VM_STORE || instruction.opcode == VM_ADD ||
+            instruction.opcode == VM_SUB || instruction.opcode == VM_MULT || instruction.opcode == VM_DIV ||
+            instruction.opcode == VM_READ || instruction.opcode == VM_WRITE) {
+            cout << " " << variables.at(instruction.operand);
+        } else if (instruction.opcode != VM_STOP && instruction.opcode != VM_NOOP) {
+            cout << " " << instruction.operand;
+        }
+        cout << endl;
+    }
+}
+
+// Runs the embedded program on the standard input, or compiles a file at run time with the same
+// compiler, which is how a program can be tried before it is embedded
+int main(int argc, char* argv[]) {
+    bool listing = false;
+    string file_name;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-list") { listing = true; }
+        else if (file_name.empty() && arg.at(0) != '-') { file_name = arg; }
+        else {
+            cerr << "Usage: " << argv[0] << " [-list] [file]" << endl;
+            return 1;
+        }
+    }
+
+    Virtual_Machine machine;
+    if (file_name.empty()) {
+        embedded.load_into(machine);
+        if (listing) { list(embedded.code.data(), embedded.code.size(), embedded.get_variables()); }
+    } else {
+        ifstream fin(file_name.c_str());
+        if (!fin.is_open()) {
+            cerr << "[Error] Cannot open " << file_name << endl;
+            return 1;
+        }
+        ostringstream text;
+        text << fin.rdbuf();
+        string source = text.str();
+
+        Constexpr_Compiler compiler(source);
+        try {
+            compiler.compile();
+        } catch (const Constexpr_Error& error) {
+            cerr << error.describe() << endl;
+            return 1;
+        }
+        machine.load(compiler.get_code().data(), compiler.get_code().size(), compiler.get_variables());
+        if (listing) { list(compiler.get_code().data(), compiler.get_code().size(), compiler.get_variables()); }
+    }
+    if (listing) { return 0; }
+
+    if (!machine.run(stdin, stdout)) {
+        cerr << "[Error] " << machine.get_error() << endl;
+        return 1;
+    }
+    return 0;
+}
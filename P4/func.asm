@@ -0,0 +1,72 @@
+READ n
+LOAD n
+ADD 1
+STORE a
+MULT a
+STORE b
+WRITE a
+WRITE b
+SUB a
+STORE k
+SUB 20
+BRZNEG L3
+LOAD k
+DIV 2
+ADD 1
+STORE k
+L3: NOOP
+LOAD k
+BRZPOS L4
+LOAD 0
+SUB k
+STORE k
+L4: NOOP
+LOAD k
+ADD 10
+STORE k
+WRITE k
+LOAD b
+SUB a
+STORE k
+SUB 20
+BRZNEG L5
+LOAD k
+DIV 2
+ADD 1
+STORE k
+L5: NOOP
+LOAD k
+BRZPOS L6
+LOAD 0
+SUB k
+STORE k
+L6: NOOP
+LOAD k
+ADD 10
+STORE k
+WRITE k
+LOAD 2
+STORE a
+WRITE a
+LOAD 6
+STORE a
+WRITE a
+LOAD 14
+STORE a
+WRITE a
+LOAD 30
+STORE a
+WRITE a
+LOAD 62
+STORE a
+WRITE a
+LOAD 126
+STORE a
+WRITE a
+WRITE n
+STOP
+n 0
+a 0
+b 0
+k 0
+
@@ -0,0 +1,129 @@
+/* Generated by compile from accumulator assembly */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Words are 32 bits and wrap around like the target's */
+static int32_t wrap(uint32_t value) { return (int32_t)value; }
+
+static int32_t add(int32_t left, int32_t right) { return wrap((uint32_t)left + (uint32_t)right); }
+
+static int32_t subtract(int32_t left, int32_t right) { return wrap((uint32_t)left - (uint32_t)right); }
+
+static int32_t multiply(int32_t left, int32_t right) { return wrap((uint32_t)left * (uint32_t)right); }
+
+static void fail(const char* reason) {
+    fflush(stdout);
+    fprintf(stderr, "[Error] %s\n", reason);
+    exit(1);
+}
+
+/* Division truncating toward zero; the one quotient that does not fit wraps around */
+static int32_t divide(int32_t left, int32_t right) {
+    if (right == 0) { fail("division by zero"); }
+    if (right == -1) { return wrap(0u - (uint32_t)left); }
+    return left / right;
+}
+
+/* Next whitespace-separated integer of the input, wrapped to a word */
+static int32_t read_word(void) {
+    uint32_t magnitude = 0;
+    int negative;
+    int c = getchar();
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') { c = getchar(); }
+    if (c == EOF) { fail("READ past the end of the input"); }
+    negative = c == '-';
+    if (c == '-' || c == '+') { c = getchar(); }
+    if (c < '0' || c > '9') { fail("READ found something other than an integer"); }
+    while (c >= '0' && c <= '9') {
+        magnitude = magnitude * 10 + (uint32_t)(c - '0');
+        c = getchar();
+    }
+    if (c != EOF) { ungetc(c, stdin); }
+    return wrap(negative ? 0u - magnitude : magnitude);
+}
+
+static void write_word(int32_t value) { printf("%ld\n", (long)value); }
+
+int main(void) {
+    static char output_buffer[1 << 16];
+    int32_t a = 0; /* The accumulator */
+    int32_t v_n = 0;
+    int32_t v_a = 0;
+    int32_t v_b = 0;
+    int32_t v_k = 0;
+
+    setvbuf(stdout, output_buffer, _IOFBF, sizeof output_buffer);
+
+    v_n = read_word();
+    a = v_n;
+    a = add(a, 1);
+    v_a = a;
+    a = multiply(a, v_a);
+    v_b = a;
+    write_word(v_a);
+    write_word(v_b);
+    a = subtract(a, v_a);
+    v_k = a;
+    a = subtract(a, 20);
+    if (a <= 0) goto l_L3;
+    a = v_k;
+    a = divide(a, 2);
+    a = add(a, 1);
+    v_k = a;
+l_L3:
+    ;
+    a = v_k;
+    if (a >= 0) goto l_L4;
+    a = 0;
+    a = subtract(a, v_k);
+    v_k = a;
+l_L4:
+    ;
+    a = v_k;
+    a = add(a, 10);
+    v_k = a;
+    write_word(v_k);
+    a = v_b;
+    a = subtract(a, v_a);
+    v_k = a;
+    a = subtract(a, 20);
+    if (a <= 0) goto l_L5;
+    a = v_k;
+    a = divide(a, 2);
+    a = add(a, 1);
+    v_k = a;
+l_L5:
+    ;
+    a = v_k;
+    if (a >= 0) goto l_L6;
+    a = 0;
+    a = subtract(a, v_k);
+    v_k = a;
+l_L6:
+    ;
+    a = v_k;
+    a = add(a, 10);
+    v_k = a;
+    write_word(v_k);
+    a = 2;
+    v_a = a;
+    write_word(v_a);
+    a = 6;
+    v_a = a;
+    write_word(v_a);
+    a = 14;
+    v_a = a;
+    write_word(v_a);
+    a = 30;
+    v_a = a;
+    write_word(v_a);
+    a = 62;
+    v_a = a;
+    write_word(v_a);
+    a = 126;
+    v_a = a;
+    write_word(v_a);
+    write_word(v_n);
+    return 0;
+}
@@ -0,0 +1,18 @@
+LOAD 1
+STORE $T0
+WRITE $T0
+LOAD 3
+STORE $T1
+WRITE $T1
+LOAD 6
+STORE $T2
+WRITE $T2
+WRITE $T3
+WRITE $T3
+WRITE $T3
+STOP
+$T0 0
+$T1 0
+$T2 0
+$T3 0
+
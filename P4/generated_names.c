@@ -0,0 +1,31 @@
+/* Generated by compile from accumulator assembly */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void write_word(int32_t value) { printf("%ld\n", (long)value); }
+
+int main(void) {
+    static char output_buffer[1 << 16];
+    int32_t a = 0; /* The accumulator */
+    int32_t g_T0 = 0;
+    int32_t g_T1 = 0;
+    int32_t g_T2 = 0;
+    int32_t g_T3 = 0;
+
+    setvbuf(stdout, output_buffer, _IOFBF, sizeof output_buffer);
+
+    a = 1;
+    g_T0 = a;
+    write_word(g_T0);
+    a = 3;
+    g_T1 = a;
+    write_word(g_T1);
+    a = 6;
+    g_T2 = a;
+    write_word(g_T2);
+    write_word(g_T3);
+    write_word(g_T3);
+    write_word(g_T3);
+    return 0;
+}
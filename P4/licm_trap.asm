@@ -0,0 +1,19 @@
+READ x1
+READ x2
+LOAD x1
+BRZNEG L1
+L0: WRITE x1
+LOAD 100
+DIV x2
+STORE $T0
+WRITE $T0
+LOAD x1
+SUB 1
+STORE x1
+BRPOS L0
+L1: NOOP
+STOP
+x1 0
+x2 0
+$T0 0
+
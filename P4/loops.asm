@@ -0,0 +1,54 @@
+READ n
+LOAD 0
+STORE i
+SUB n
+BRZPOS L1
+L0: LOAD 0
+STORE j
+SUB n
+BRZPOS L3
+L2: LOAD i
+SUB j
+MULT 2
+STORE $T0
+LOAD i
+MULT j
+ADD 3
+SUB $T0
+STORE t
+DIV 7
+MULT 7
+STORE $T1
+LOAD t
+SUB $T1
+ADD s
+STORE s
+SUB 100000
+STORE $T2
+BRZNEG L4
+LOAD $T2
+STORE s
+L4: NOOP
+LOAD j
+ADD 1
+STORE j
+SUB n
+BRNEG L2
+L3: NOOP
+LOAD i
+ADD 1
+STORE i
+SUB n
+BRNEG L0
+L1: NOOP
+WRITE s
+STOP
+n 0
+i 0
+j 0
+s 0
+t 0
+$T0 0
+$T1 0
+$T2 0
+
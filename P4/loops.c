@@ -0,0 +1,112 @@
+/* Generated by compile from accumulator assembly */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Words are 32 bits and wrap around like the target's */
+static int32_t wrap(uint32_t value) { return (int32_t)value; }
+
+static int32_t add(int32_t left, int32_t right) { return wrap((uint32_t)left + (uint32_t)right); }
+
+static int32_t subtract(int32_t left, int32_t right) { return wrap((uint32_t)left - (uint32_t)right); }
+
+static int32_t multiply(int32_t left, int32_t right) { return wrap((uint32_t)left * (uint32_t)right); }
+
+static void fail(const char* reason) {
+    fflush(stdout);
+    fprintf(stderr, "[Error] %s\n", reason);
+    exit(1);
+}
+
+/* Division truncating toward zero; the one quotient that does not fit wraps around */
+static int32_t divide(int32_t left, int32_t right) {
+    if (right == 0) { fail("division by zero"); }
+    if (right == -1) { return wrap(0u - (uint32_t)left); }
+    return left / right;
+}
+
+/* Next whitespace-separated integer of the input, wrapped to a word */
+static int32_t read_word(void) {
+    uint32_t magnitude = 0;
+    int negative;
+    int c = getchar();
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') { c = getchar(); }
+    if (c == EOF) { fail("READ past the end of the input"); }
+    negative = c == '-';
+    if (c == '-' || c == '+') { c = getchar(); }
+    if (c < '0' || c > '9') { fail("READ found something other than an integer"); }
+    while (c >= '0' && c <= '9') {
+        magnitude = magnitude * 10 + (uint32_t)(c - '0');
+        c = getchar();
+    }
+    if (c != EOF) { ungetc(c, stdin); }
+    return wrap(negative ? 0u - magnitude : magnitude);
+}
+
+static void write_word(int32_t value) { printf("%ld\n", (long)value); }
+
+int main(void) {
+    static char output_buffer[1 << 16];
+    int32_t a = 0; /* The accumulator */
+    int32_t v_n = 0;
+    int32_t v_i = 0;
+    int32_t v_j = 0;
+    int32_t v_s = 0;
+    int32_t v_t = 0;
+    int32_t g_T0 = 0;
+    int32_t g_T1 = 0;
+    int32_t g_T2 = 0;
+
+    setvbuf(stdout, output_buffer, _IOFBF, sizeof output_buffer);
+
+    v_n = read_word();
+    a = 0;
+    v_i = a;
+    a = subtract(a, v_n);
+    if (a >= 0) goto l_L1;
+l_L0:
+    a = 0;
+    v_j = a;
+    a = subtract(a, v_n);
+    if (a >= 0) goto l_L3;
+l_L2:
+    a = v_i;
+    a = subtract(a, v_j);
+    a = multiply(a, 2);
+    g_T0 = a;
+    a = v_i;
+    a = multiply(a, v_j);
+    a = add(a, 3);
+    a = subtract(a, g_T0);
+    v_t = a;
+    a = divide(a, 7);
+    a = multiply(a, 7);
+    g_T1 = a;
+    a = v_t;
+    a = subtract(a, g_T1);
+    a = add(a, v_s);
+    v_s = a;
+    a = subtract(a, 100000);
+    g_T2 = a;
+    if (a <= 0) goto l_L4;
+    a = g_T2;
+    v_s = a;
+l_L4:
+    ;
+    a = v_j;
+    a = add(a, 1);
+    v_j = a;
+    a = subtract(a, v_n);
+    if (a < 0) goto l_L2;
+l_L3:
+    ;
+    a = v_i;
+    a = add(a, 1);
+    v_i = a;
+    a = subtract(a, v_n);
+    if (a < 0) goto l_L0;
+l_L1:
+    ;
+    write_word(v_s);
+    return 0;
+}
@@ -6,10 +6,16 @@
 #include "Tree.h"
 #include "Static_Semantics.h"
 #include "Utility.h"
-#include "Generator.h"
+#include "Pass_Manager.h"
+#include "Object_File.h"
+#include "C_Backend.h"
+#include "Virtual_Machine.h"
+#include "Interpreter.h"
+#include "Source_Map.h"
 
 #include <iostream>
 #include <fstream>
+#include <map>
 #include <string>
 
 using std::cout;
@@ -18,14 +24,184 @@ using std::endl;
 using std::ifstream;
 using std::ofstream;
 using std::istringstream;
+using std::map;
 using std::string;
+using std::vector;
+
+// Print the number of times each rewrite rule applied, one rule per line
+void print_rule_counts(const map<string, size_t>& rule_counts) {
+    for (map<string, size_t>::const_iterator it = rule_counts.begin(); it != rule_counts.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+}
+
+/** Write the generated code as assembly, an object file or C.
+ *  @param program The generated code
+ *  @param base The name of the output without its extension
+ *  @param binary True for an object file
+ *  @param c_source True for a C translation unit
+ *  @return: the name of the file written
+ */
+string write_output(const Program& program, const string& base, bool binary, bool c_source) {
+    if (binary) {
+        string file = base + ".bin";
+        Object_File object;
+        if (!object.assemble(program.to_string())) {
+            exit_error("[Error] Cannot assemble the generated code: " + object.get_error());
+        }
+        if (!object.write(file)) {
+            exit_error("[Error] Cannot write " + file);
+        }
+        return file;
+    }
+
+    string file = base + (c_source ? ".c" : ".asm");
+    ofstream fout;
+    fout.open(file.c_str());
+
+    if (c_source) {
+        C_Backend backend(program);
+        backend.translate();
+        fout << backend.get_source();
+    } else {
+        fout << program.to_string() << endl;
+    }
+    fout.close();
+    return file;
+}
+
+/** Write the source map of the generated code next to it.
+ *  @param program The generated code
+ *  @param base The name of the output without its extension
+ *  @param source The source file, empty for the keyboard
+ *  @return: the name of the file written
+ */
+string write_source_map(const Program& program, const string& base, const string& source) {
+    Source_Map source_map;
+    source_map.build(program.get_instructions(), source);
+
+    string file = base + ".map";
+    ofstream fout(file.c_str());
+    fout << source_map.to_string();
+    return file;
+}
+
+/** Run the generated code in this process, as machine code where the JIT is supported and
+ *  interpreted elsewhere. READ takes integers from standard input.
+ *  @param program The generated code
+ *  @return: the exit status, 0 if the program reached STOP
+ */
+int run_program(const Program& program) {
+    Virtual_Machine machine;
+    machine.set_jit(Jit_Compiler::is_supported());
+    if (!machine.assemble(program.to_string())) {
+        exit_error("[Error] Cannot assemble the generated code: " + machine.get_error());
+    }
+    if (!machine.run(stdin, stdout)) {
+        std::cerr << "[Error] " << machine.get_error() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/** Run the checked tree directly with the Interpreter. READ takes integers from standard input.
+ *  @param parse_tree The checked tree
+ *  @return: the exit status, 0 if the program ran to its end
+ */
+int run_tree(const Tree& parse_tree) {
+    Interpreter interpreter(parse_tree);
+    interpreter.resolve();
+    if (!interpreter.run(stdin, stdout)) {
+        std::cerr << "[Error] " << interpreter.get_error() << endl;
+        return 1;
+    }
+    return 0;
+}
 
 int main(int argc, char** argv) {
     string file_name;
+    vector<string> arguments;
+    Pass_Manager pass_manager;
+    bool dump_ir = false; // -fdump-ir: write the SSA form next to the output
+    bool dump_cfg = false; // -fdump-cfg: write the control-flow graph of the output as DOT next to it
+    bool pass_statistics = false; // -fpass-stats: print the time and sizes of every pass
+    bool rule_statistics = false; // -frule-stats: print how often each rewrite rule applied
+    bool binary = false; // -fbinary: write an object file instead of assembly
+    bool c_source = false; // -fc: write a C translation unit instead of assembly
+    bool jit = false; // -fjit: run the generated code as machine code instead of writing it
+    bool interpret = false; // --run: run the checked tree directly, generating no code
+    bool source_map = false; // -fsource-map: write the source line of each instruction next to the output
+
+    // The rule database installed next to compile; -fsuperopt-rules adds one that learns new rules
+    string program_path = argv[0];
+    size_t slash = program_path.find_last_of('/');
+    pass_manager.add_rule_file((slash == string::npos ? "" : program_path.substr(0, slash + 1)) + "superopt.rules");
+
+    // Option processing
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "-O0" || argument == "-O1" || argument == "-O2") { // -O1 is the default
+            pass_manager.set_level(argument.at(2) - '0');
+        } else if (argument == "-passes=help") {
+            cout << Pass_Manager::describe_passes();
+            return 0;
+        } else if (argument.compare(0, 8, "-passes=") == 0) {
+            if (!pass_manager.set_pipeline(argument.substr(8))) {
+                exit_error("[Error] Unknown pass in " + argument + " (see -passes=help)");
+            }
+        } else if (argument == "-fssa") {
+            pass_manager.set_ssa(true);
+        } else if (argument == "-fdump-ir") {
+            pass_manager.set_ssa(true);
+            dump_ir = true;
+        } else if (argument == "-fdump-cfg") {
+            dump_cfg = true;
+        } else if (argument.compare(0, 15, "-fpeval-budget=") == 0) {
+            string budget = argument.substr(15);
+            if (budget.empty() || budget.find_first_not_of("0123456789") != string::npos) {
+                exit_error("[Error] Invalid budget in " + argument);
+            }
+            pass_manager.set_evaluation_budget(atol(budget.c_str()));
+        } else if (argument.compare(0, 17, "-fsuperopt-rules=") == 0) {
+            pass_manager.set_rule_file(argument.substr(17));
+        } else if (argument == "-fno-superopt-search") {
+            pass_manager.set_superoptimizer_search(false);
+        } else if (argument.compare(0, 18, "-fsuperopt-budget=") == 0) {
+            string budget = argument.substr(18);
+            if (budget.empty() || budget.find_first_not_of("0123456789") != string::npos) {
+                exit_error("[Error] Invalid budget in " + argument);
+            }
+            pass_manager.set_superoptimizer_budget(atol(budget.c_str()));
+        } else if (argument == "-fprofile-generate") {
+            pass_manager.set_instrumentation(true);
+        } else if (argument.compare(0, 14, "-fprofile-use=") == 0) {
+            if (!pass_manager.set_profile_file(argument.substr(14))) {
+                exit_error("[Error] Cannot read the profile " + argument.substr(14));
+            }
+        } else if (argument == "-fbinary") {
+            binary = true;
+        } else if (argument == "-fc") {
+            c_source = true;
+        } else if (argument == "-fsource-map") {
+            source_map = true;
+        } else if (argument == "-fjit") {
+            jit = true;
+        } else if (argument == "--run") {
+            interpret = true;
+        } else if (argument == "-fpass-stats") {
+            pass_statistics = true;
+        } else if (argument == "-frule-stats") {
+            rule_statistics = true;
+        } else if (!argument.empty() && argument.at(0) == '-') {
+            exit_error("[Error] Unknown option " + argument);
+        } else {
+            arguments.push_back(argument);
+        }
+    }
 
     // Argument processing
-    switch (argc) {
-    case 1: {
+    switch (arguments.size()) {
+    case 0: {
         // Reads from the keyboard
         cout << "Reading from the keyboard" << endl;
 
@@ -54,26 +230,28 @@ int main(int argc, char** argv) {
         // Perform static semantics checks
         Static_Semantics semantics(parse_tree, iss);
         semantics.check_semantics();
+        if (interpret) { return run_tree(parse_tree); }
 
         // Generate code
-        Generator generator(parse_tree);
+        pass_manager.set_ir_file(dump_ir ? "a.ir" : "");
+        pass_manager.set_cfg_file(dump_cfg ? "a.dot" : "");
+        Program program = pass_manager.compile(parse_tree);
 
-        // Output the generated code
-        ofstream fout;
-        string filename = "a.asm";
-        fout.open(filename.c_str());
+        if (jit) { return run_program(program); }
 
-        fout << generator.get_code() << endl;
-        fout.close();
+        // Output the generated code
+        string filename = write_output(program, "a", binary, c_source);
+        if (source_map) { write_source_map(program, "a", ""); }
 
         cout << "Generated code has been written to " << filename << endl;
+        if (rule_statistics) { print_rule_counts(pass_manager.get_rule_counts()); }
 
         break;
     }
 
-    case 2: {
+    case 1: {
         // Read from a file
-        file_name = argv[1];
+        file_name = arguments.at(0);
         string file = file_name + ".4280fs24";
 
         ifstream fin;
@@ -93,22 +271,22 @@ int main(int argc, char** argv) {
         Scanner scanner(fin);
         Static_Semantics semantics(parse_tree, fin);
         semantics.check_semantics();
+        if (interpret) { return run_tree(parse_tree); }
 
         // Generate code
-        Generator generator(parse_tree);
-        generator.generate();
+        pass_manager.set_ir_file(dump_ir ? file_name + ".ir" : "");
+        pass_manager.set_cfg_file(dump_cfg ? file_name + ".dot" : "");
+        Program program = pass_manager.compile(parse_tree);
 
-        // Write the generated code to a file
-        string output_file = file_name + ".asm";
-
-        ofstream fout;
-        fout.open(output_file.c_str());
+        if (jit) { return run_program(program); }
 
-        fout << generator.get_code() << endl;
+        // Write the generated code to a file
+        string output_file = write_output(program, file_name, binary, c_source);
+        if (source_map) { write_source_map(program, file_name, file); }
 
         cout << "Generated code has been written to " << output_file << endl;
+        if (rule_statistics) { print_rule_counts(pass_manager.get_rule_counts()); }
 
-        fout.close();
         fin.close();
         break;
     }
@@ -118,6 +296,8 @@ int main(int argc, char** argv) {
         break;
     }
 
+    if (pass_statistics) { cout << pass_manager.get_statistics(); }
+
     //pause_program();
     return 0;
 }
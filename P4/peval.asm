@@ -0,0 +1,14 @@
+LOAD 120
+STORE $T0
+WRITE $T0
+LOAD 0
+SUB 6
+STORE $T1
+WRITE $T1
+WRITE $T2
+WRITE $T0
+STOP
+$T0 0
+$T1 0
+$T2 0
+
@@ -0,0 +1,32 @@
+/* Generated by compile from accumulator assembly */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Words are 32 bits and wrap around like the target's */
+static int32_t wrap(uint32_t value) { return (int32_t)value; }
+
+static int32_t subtract(int32_t left, int32_t right) { return wrap((uint32_t)left - (uint32_t)right); }
+
+static void write_word(int32_t value) { printf("%ld\n", (long)value); }
+
+int main(void) {
+    static char output_buffer[1 << 16];
+    int32_t a = 0; /* The accumulator */
+    int32_t g_T0 = 0;
+    int32_t g_T1 = 0;
+    int32_t g_T2 = 0;
+
+    setvbuf(stdout, output_buffer, _IOFBF, sizeof output_buffer);
+
+    a = 120;
+    g_T0 = a;
+    write_word(g_T0);
+    a = 0;
+    a = subtract(a, 6);
+    g_T1 = a;
+    write_word(g_T1);
+    write_word(g_T2);
+    write_word(g_T0);
+    return 0;
+}
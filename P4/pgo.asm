@@ -0,0 +1,58 @@
+READ n
+LOAD 0
+STORE i
+SUB n
+BRZPOS L1
+L0: LOAD s
+ADD i
+STORE s
+SUB 1000
+STORE $T0
+BRZNEG L2
+LOAD $T0
+STORE s
+LOAD e
+ADD 1
+STORE e
+L2: NOOP
+LOAD i
+SUB 7
+BRNEG L3
+BRPOS L3
+LOAD t
+ADD 100
+STORE t
+L3: NOOP
+LOAD i
+SUB 3
+BRZERO L4
+LOAD t
+ADD 1
+STORE t
+L4: NOOP
+LOAD e
+SUB 1000
+BRZNEG L6
+L5: LOAD e
+SUB 1
+STORE e
+SUB 1000
+BRPOS L5
+L6: NOOP
+LOAD i
+ADD 1
+STORE i
+SUB n
+BRNEG L0
+L1: NOOP
+WRITE s
+WRITE e
+WRITE t
+STOP
+n 0
+i 0
+s 0
+e 0
+t 0
+$T0 0
+
@@ -0,0 +1,109 @@
+/* Generated by compile from accumulator assembly */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Words are 32 bits and wrap around like the target's */
+static int32_t wrap(uint32_t value) { return (int32_t)value; }
+
+static int32_t add(int32_t left, int32_t right) { return wrap((uint32_t)left + (uint32_t)right); }
+
+static int32_t subtract(int32_t left, int32_t right) { return wrap((uint32_t)left - (uint32_t)right); }
+
+static void fail(const char* reason) {
+    fflush(stdout);
+    fprintf(stderr, "[Error] %s\n", reason);
+    exit(1);
+}
+
+/* Next whitespace-separated integer of the input, wrapped to a word */
+static int32_t read_word(void) {
+    uint32_t magnitude = 0;
+    int negative;
+    int c = getchar();
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') { c = getchar(); }
+    if (c == EOF) { fail("READ past the end of the input"); }
+    negative = c == '-';
+    if (c == '-' || c == '+') { c = getchar(); }
+    if (c < '0' || c > '9') { fail("READ found something other than an integer"); }
+    while (c >= '0' && c <= '9') {
+        magnitude = magnitude * 10 + (uint32_t)(c - '0');
+        c = getchar();
+    }
+    if (c != EOF) { ungetc(c, stdin); }
+    return wrap(negative ? 0u - magnitude : magnitude);
+}
+
+static void write_word(int32_t value) { printf("%ld\n", (long)value); }
+
+int main(void) {
+    static char output_buffer[1 << 16];
+    int32_t a = 0; /* The accumulator */
+    int32_t v_n = 0;
+    int32_t v_i = 0;
+    int32_t v_s = 0;
+    int32_t v_e = 0;
+    int32_t v_t = 0;
+    int32_t g_T0 = 0;
+
+    setvbuf(stdout, output_buffer, _IOFBF, sizeof output_buffer);
+
+    v_n = read_word();
+    a = 0;
+    v_i = a;
+    a = subtract(a, v_n);
+    if (a >= 0) goto l_L1;
+l_L0:
+    a = v_s;
+    a = add(a, v_i);
+    v_s = a;
+    a = subtract(a, 1000);
+    g_T0 = a;
+    if (a <= 0) goto l_L2;
+    a = g_T0;
+    v_s = a;
+    a = v_e;
+    a = add(a, 1);
+    v_e = a;
+l_L2:
+    ;
+    a = v_i;
+    a = subtract(a, 7);
+    if (a < 0) goto l_L3;
+    if (a > 0) goto l_L3;
+    a = v_t;
+    a = add(a, 100);
+    v_t = a;
+l_L3:
+    ;
+    a = v_i;
+    a = subtract(a, 3);
+    if (a == 0) goto l_L4;
+    a = v_t;
+    a = add(a, 1);
+    v_t = a;
+l_L4:
+    ;
+    a = v_e;
+    a = subtract(a, 1000);
+    if (a <= 0) goto l_L6;
+l_L5:
+    a = v_e;
+    a = subtract(a, 1);
+    v_e = a;
+    a = subtract(a, 1000);
+    if (a > 0) goto l_L5;
+l_L6:
+    ;
+    a = v_i;
+    a = add(a, 1);
+    v_i = a;
+    a = subtract(a, v_n);
+    if (a < 0) goto l_L0;
+l_L1:
+    ;
+    write_word(v_s);
+    write_word(v_e);
+    write_word(v_t);
+    return 0;
+}
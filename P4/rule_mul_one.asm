@@ -0,0 +1,6 @@
+READ x
+WRITE x
+WRITE x
+STOP
+x 0
+
@@ -0,0 +1,15 @@
+READ x
+LOAD x
+ADD x
+ADD x
+STORE $T0
+WRITE $T0
+LOAD 9
+MULT x
+STORE $T1
+WRITE $T1
+STOP
+x 0
+$T0 0
+$T1 0
+
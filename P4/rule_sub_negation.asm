@@ -0,0 +1,11 @@
+READ x
+READ y
+LOAD x
+ADD y
+STORE $T0
+WRITE $T0
+STOP
+x 0
+y 0
+$T0 0
+
@@ -0,0 +1,5 @@
+READ x
+WRITE x
+STOP
+x 0
+
@@ -0,0 +1,9 @@
+READ x
+LOAD 0
+SUB x
+STORE $T0
+WRITE $T0
+STOP
+x 0
+$T0 0
+
@@ -0,0 +1,251 @@
+// Created by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+// Last updated by ThanhDat Nguyen (tnrbf@umsystem.edu) on 2026-10-19
+
+#include "Batch_Engine.h"
+#include "Line_Profile.h"
+#include "Object_File.h"
+#include "Virtual_Machine.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::ifstream;
+using std::ofstream;
+using std::istringstream;
+using std::ostringstream;
+using std::string;
+
+/** Run the program once for each line of an input file, printing each instance's output on one line.
+ *  @param machine The assembled program
+ *  @param file_name The inputs, one instance per line of whitespace-separated integers
+ *  @param threads Number of threads to run groups of instances on
+ *  @param statistics Also time running the instances one at a time and print both rates
+ *  @return: The exit status, 1 if the file is invalid or an instance failed
+ */
+int run_batch(const Virtual_Machine& machine, const string& file_name, size_t threads, bool statistics) {
+    ifstream fin(file_name.c_str());
+    if (!fin.is_open()) {
+        cerr << "[Error] Cannot open " << file_name << endl;
+        return 1;
+    }
+
+    vector<vector<int32_t> > inputs;
+    string line;
+    while (getline(fin, line)) {
+        inputs.push_back(vector<int32_t>());
+        istringstream words(line);
+        string word;
+        while (words >> word) {
+            char* end = NULL;
+            long long value = strtoll(word.c_str(), &end, 10);
+            if (*end != '\0') {
+                cerr << "[Error] " << file_name << ":" << inputs.size() << ": " << word << " is not an integer" << endl;
+                return 1;
+            }
+            inputs.back().push_back(static_cast<int32_t>(static_cast<uint32_t>(value))); // Wraps like READ
+        }
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    Batch_Engine engine(machine);
+    engine.set_threads(threads);
+    vector<Batch_Engine::Result> results;
+    Clock::time_point start = Clock::now();
+    engine.run(inputs, results);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    int status = 0;
+    ostringstream text;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const vector<int32_t>& output = results.at(i).output;
+        for (size_t j = 0; j < output.size(); ++j) { text << (j == 0 ? "" : " ") << output.at(j); }
+        text << '\n';
+        if (!results.at(i).stopped) {
+            cerr << "[Error] input " << i + 1 << ": " << results.at(i).error << endl;
+            status = 1;
+        }
+    }
+    cout << text.str();
+
+    if (statistics) {
+        const Batch_Engine::Statistics counts = engine.get_statistics();
+
+        // The same instances on one thread, one at a time, for comparison
+        Batch_Engine single(machine);
+        single.set_lockstep(false);
+        vector<Batch_Engine::Result> single_results;
+        start = Clock::now();
+        single.run(inputs, single_results);
+        double single_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        cerr << "instances: " << inputs.size() << endl;
+        cerr << "batch: " << inputs.size() / (seconds > 0 ? seconds : 1e-9) << " inputs/second on " << threads << " thread(s)" << endl;
+        cerr << "one at a time: " << inputs.size() / (single_seconds > 0 ? single_seconds : 1e-9) << " inputs/second" << endl;
+        cerr << "lockstep steps: " << counts.vector_steps << " (" << (counts.vector_steps == 0 ? 0.0 : 100.0 * counts.lane_steps / (counts.vector_steps * Batch_Engine::lanes)) << "% of lanes active)" << endl;
+        cerr << "scalar steps: " << counts.scalar_steps << " (" << counts.fallbacks << " instances fell back)" << endl;
+    }
+    return status;
+}
+
+/** Print where a profiled run spent its instructions, by source line when a source map is next to
+ *  the program (the program's name with .map in place of its extension).
+ *  @param machine The machine after a profiled run
+ *  @param file_name The program file
+ *  @param folded_file File to write folded stacks to, empty for none
+ */
+void report_profile(const Virtual_Machine& machine, const string& file_name, const string& folded_file) {
+    size_t dot = file_name.find_last_of('.');
+    size_t slash = file_name.find_last_of('/');
+    string base = dot != string::npos && (slash == string::npos || dot > slash) ? file_name.substr(0, dot) : file_name;
+
+    Source_Map source_map;
+    if (!source_map.read(base + ".map")) {
+        cerr << "No source map " << base << ".map, reporting every instruction as line ?" << endl;
+    } else if (source_map.get_instruction_count() + 1 != machine.get_code().size()) {
+        cerr << "[Warning] " << base << ".map does not match " << file_name << ", ignoring it" << endl;
+        source_map = Source_Map();
+    }
+
+    Line_Profile profile(machine, source_map);
+    const string& source = source_map.get_source_file();
+    if (!source.empty() && !profile.load_source(source) && slash != string::npos) {
+        profile.load_source(file_name.substr(0, slash + 1) + source);
+    }
+    cerr << profile.report();
+
+    if (!folded_file.empty()) {
+        ofstream fout(folded_file.c_str());
+        slash = base.find_last_of('/');
+        fout << profile.folded(slash == string::npos ? base : base.substr(slash + 1));
+    }
+}
+
+// Runs the assembly or object file written by compile: vm [-stats] [-no-fuse] [-jit] [-registers] [-profile] [-profile-folded out] [-disassemble] [-batch inputs [-threads n]] file
+// READ takes integers from standard input and WRITE prints one integer per line.
+// -disassemble prints an object file as assembly instead of running it, or with -registers the register code.
+// -registers translates the program into three-operand register code and runs that.
+// -batch runs the program once per line of the inputs file, in lockstep groups on n threads.
+// -profile prints the instructions each source line ran, and -profile-folded also writes them as folded stacks.
+int main(int argc, char** argv) {
+    string file_name;
+    bool statistics = false; // -stats: print the number of instructions executed and of dispatches
+    bool superinstructions = true; // -no-fuse: dispatch every instruction on its own
+    bool disassemble = false; // -disassemble: print an object file as assembly
+    bool jit = false; // -jit: run x86-64 machine code compiled from the program
+    bool registers = false; // -registers: run register code translated from the program
+    string batch_file; // -batch: run once per line of this file
+    size_t threads = 1; // -threads: number of threads of a batch
+    bool profile = false; // -profile: count instructions and branches and report them by source line
+    string folded_file; // -profile-folded: also write the counts as folded stacks to this file
+
+    // Option processing
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "-stats") {
+            statistics = true;
+        } else if (argument == "-no-fuse") {
+            superinstructions = false;
+        } else if (argument == "-jit") {
+            jit = true;
+        } else if (argument == "-registers") {
+            registers = true;
+        } else if (argument == "-disassemble") {
+            disassemble = true;
+        } else if (argument == "-profile") {
+            profile = true;
+        } else if (argument == "-profile-folded" && i + 1 < argc) {
+            profile = true;
+            folded_file = argv[++i];
+        } else if (argument == "-batch" && i + 1 < argc) {
+            batch_file = argv[++i];
+        } else if (argument == "-threads" && i + 1 < argc) {
+            int count = atoi(argv[++i]);
+            if (count < 1) {
+                cerr << "[Error] -threads needs a positive number" << endl;
+                return 1;
+            }
+            threads = static_cast<size_t>(count);
+        } else if (!argument.empty() && argument.at(0) == '-') {
+            cerr << "[Error] Unknown option " << argument << endl;
+            return 1;
+        } else if (file_name.empty()) {
+            file_name = argument;
+        } else {
+            cerr << "[Error] Too many arguments provided" << endl;
+            return 1;
+        }
+    }
+    if (file_name.empty()) {
+        cerr << "Usage: vm [-stats] [-no-fuse] [-jit] [-registers] [-profile] [-profile-folded out] [-disassemble] [-batch inputs [-threads n]] file" << endl;
+        return 1;
+    }
+
+    Virtual_Machine machine;
+    machine.set_superinstructions(superinstructions);
+    machine.set_jit(jit);
+    machine.set_registers(registers);
+    machine.set_profiling(profile);
+    Object_File object;
+
+    if (Object_File::is_object_file(file_name)) {
+        if (!object.load(file_name)) {
+            cerr << "[Error] " << object.get_error() << endl;
+            return 1;
+        }
+        if (disassemble && !registers) {
+            cout << object.disassemble();
+            return 0;
+        }
+        machine.load(object);
+    } else {
+        if (disassemble && !registers) {
+            cerr << "[Error] " << file_name << " is not an object file" << endl;
+            return 1;
+        }
+
+        // Read the whole program
+        ifstream fin(file_name.c_str());
+        if (!fin.is_open()) {
+            cerr << "[Error] Cannot open " << file_name << endl;
+            return 1;
+        }
+        ostringstream text;
+        text << fin.rdbuf();
+
+        if (!machine.assemble(text.str())) {
+            cerr << "[Error] " << file_name << ": " << machine.get_error() << endl;
+            return 1;
+        }
+    }
+
+    if (disassemble) {
+        cout << machine.get_register_translator().disassemble(machine.get_variables());
+        return 0;
+    }
+
+    if (!batch_file.empty()) { return run_batch(machine, batch_file, threads, statistics); }
+
+    bool stopped = machine.run(stdin, stdout);
+    if (profile) { report_profile(machine, file_name, folded_file); }
+    if (statistics && jit && !profile) {
+        cerr << "steps: not counted by the JIT" << endl;
+    } else if (statistics) {
+        cerr << "steps: " << machine.get_steps() << endl;
+        cerr << "dispatches: " << machine.get_dispatches() << endl;
+    }
+    if (!stopped) {
+        cerr << "[Error] " << machine.get_error() << endl;
+        return 1;
+    }
+
+    return 0;
+}